@@ -13,9 +13,7 @@ SINGLE_SPRITES = [
     "deathPlayerPot.png",
     "roach.png",
     "dayWaterPot.png",
-    "nightWaterPot.png",
     "mushroomDayUpDown.png",
-    "nightShroom.png",
     "player-1.png",
     "flower.png",
     "flower-1.png",
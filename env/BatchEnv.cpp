@@ -0,0 +1,183 @@
+#include "BatchEnv.h"
+#include "world/WorldThread.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Distance from 'p' to the nearest point of 'r'
+float DistanceSq(Vector2 p, Rectangle r) {
+  float dx = std::max({r.x - p.x, 0.0f, p.x - (r.x + r.width)});
+  float dy = std::max({r.y - p.y, 0.0f, p.y - (r.y + r.height)});
+  return dx * dx + dy * dy;
+}
+
+// The 'Count' nearest items seen, nearest first (insertion into a small
+// sorted array: counts are a handful)
+template <typename T, int Count> class Nearest {
+public:
+  int size = 0;
+  T items[Count];
+  float keys[Count];
+
+  void Add(const T &item, float key) {
+    if (size == Count && key >= keys[Count - 1])
+      return;
+    int i = size < Count ? size++ : Count - 1;
+    for (; i > 0 && keys[i - 1] > key; i--) {
+      items[i] = items[i - 1];
+      keys[i] = keys[i - 1];
+    }
+    items[i] = item;
+    keys[i] = key;
+  }
+};
+
+} // namespace
+
+BatchEnv::BatchEnv() {
+  autoReset = true;
+  maxTicks = 0;
+}
+
+BatchEnv::~BatchEnv() { Destroy(); }
+
+bool BatchEnv::Create(const char *levelPath, int count, int threads) {
+  Destroy();
+  if (count <= 0 || !prototype.Load(levelPath))
+    return false;
+  prototype.Layout((float)Core::SCREEN_WIDTH, (float)Core::SCREEN_HEIGHT);
+
+  instances.reserve(count);
+  for (int i = 0; i < count; i++) {
+    instances.push_back(std::make_unique<Instance>());
+    instances.back()->level = prototype;
+    Restart(*instances.back());
+  }
+  jobs.Start(threads);
+  return true;
+}
+
+void BatchEnv::Destroy() {
+  jobs.Stop();
+  instances.clear();
+  prototype = Level();
+}
+
+void BatchEnv::Restart(Instance &instance) {
+  // Platforms back where the level starts them (sunk flowers rise)
+  instance.level.platforms = prototype.platforms;
+  instance.world.Start(instance.level, prototype.isDay);
+  instance.exposed = false;
+}
+
+void BatchEnv::Reset(float *observations) {
+  jobs.Wait(jobs.ParallelFor(GetCount(), INSTANCE_GRAIN,
+                             [&](int begin, int end) {
+                               for (int i = begin; i < end; i++) {
+                                 Restart(*instances[i]);
+                                 if (observations != nullptr)
+                                   Observe(*instances[i],
+                                           observations + i * OBS_SIZE);
+                               }
+                             }));
+}
+
+void BatchEnv::Reset(int index) {
+  if (index >= 0 && index < GetCount())
+    Restart(*instances[index]);
+}
+
+void BatchEnv::Step(const uint8_t *actions, float *observations,
+                    uint8_t *status) {
+  jobs.Wait(jobs.ParallelFor(GetCount(), INSTANCE_GRAIN, [&](int begin,
+                                                             int end) {
+    for (int i = begin; i < end; i++) {
+      Instance &instance = *instances[i];
+      uint8_t action = actions != nullptr ? actions[i] : 0;
+      WorldInput input;
+      input.player.left = (action & RENO_ACTION_LEFT) != 0;
+      input.player.right = (action & RENO_ACTION_RIGHT) != 0;
+      input.player.jump = (action & RENO_ACTION_JUMP) != 0;
+      input.toggleTime = (action & RENO_ACTION_TOGGLE) != 0;
+
+      World &world = instance.world;
+      WorldEvents events = world.Step(WorldThread::TICK_SECONDS, input);
+      instance.exposed = events.burning;
+
+      uint8_t result = RENO_STATUS_RUNNING;
+      if (world.player.isDead)
+        result = RENO_STATUS_DIED;
+      else if (world.IsFinished())
+        result = RENO_STATUS_EXIT;
+      else if (maxTicks > 0 && world.tick >= (unsigned long long)maxTicks)
+        result = RENO_STATUS_TIMEOUT;
+      if (result != RENO_STATUS_RUNNING && autoReset)
+        Restart(instance);
+
+      if (status != nullptr)
+        status[i] = result;
+      if (observations != nullptr)
+        Observe(instance, observations + i * OBS_SIZE);
+    }
+  }));
+}
+
+void BatchEnv::Observe(const Instance &instance, float *out) const {
+  const World &world = instance.world;
+  const Level &level = instance.level;
+  const Player &player = world.player;
+  float W = (float)Core::SCREEN_WIDTH;
+  float H = (float)Core::SCREEN_HEIGHT;
+  Rectangle body = player.GetRect();
+  Vector2 centre = {body.x + body.width * 0.5f, body.y + body.height * 0.5f};
+  auto relX = [&](float x) { return (x - centre.x) / W; };
+  auto relY = [&](float y) { return (y - centre.y) / H; };
+
+  memset(out, 0, OBS_SIZE * sizeof(float));
+  out[RENO_OBS_PLAYER_X] = centre.x / W;
+  out[RENO_OBS_PLAYER_Y] = centre.y / H;
+  out[RENO_OBS_VELOCITY_X] = player.velocity.x / player.speed;
+  out[RENO_OBS_VELOCITY_Y] = player.velocity.y / player.jumpForce;
+  out[RENO_OBS_GROUNDED] = player.isGrounded ? 1.0f : 0.0f;
+  out[RENO_OBS_FACING_RIGHT] = player.facingRight ? 1.0f : 0.0f;
+  out[RENO_OBS_HP] = player.hp / player.maxHp;
+  out[RENO_OBS_EXPOSED] = instance.exposed ? 1.0f : 0.0f;
+  out[RENO_OBS_IS_DAY] = world.isDayTime ? 1.0f : 0.0f;
+  out[RENO_OBS_EXIT_X] = relX(level.exitZone.x + level.exitZone.width * 0.5f);
+  out[RENO_OBS_EXIT_Y] = relY(level.exitZone.y + level.exitZone.height * 0.5f);
+  out[RENO_OBS_SUN_X] = relX(level.sunPosition.x);
+  out[RENO_OBS_SUN_Y] = relY(level.sunPosition.y);
+
+  Nearest<const Enemy *, RENO_OBS_ENEMY_COUNT> enemies;
+  for (const Enemy *enemy : world.enemies) {
+    Rectangle r = enemy->GetRect();
+    enemies.Add(enemy, DistanceSq(centre, r));
+  }
+  for (int k = 0; k < enemies.size; k++) {
+    const Enemy *enemy = enemies.items[k];
+    float *slot = out + RENO_OBS_ENEMIES + k * RENO_OBS_ENEMY_STRIDE;
+    slot[0] = 1.0f;
+    slot[1] = relX(enemy->position.x + enemy->width * 0.5f);
+    slot[2] = relY(enemy->position.y + enemy->height * 0.5f);
+    slot[3] = enemy->movingRight ? 1.0f : 0.0f;
+  }
+
+  // Platforms within half a screen, through the level's broadphase
+  Nearest<const Platform *, RENO_OBS_PLATFORM_COUNT> platforms;
+  Rectangle area = {centre.x - W * 0.5f, centre.y - H * 0.5f, W, H};
+  level.ForEachSolid(area, world.isDayTime, [&](const Platform &plat) {
+    if (CheckCollisionRecs(area, plat.rect))
+      platforms.Add(&plat, DistanceSq(centre, plat.rect));
+  });
+  for (int k = 0; k < platforms.size; k++) {
+    const Rectangle &r = platforms.items[k]->rect;
+    float *slot = out + RENO_OBS_PLATFORMS + k * RENO_OBS_PLATFORM_STRIDE;
+    slot[0] = 1.0f;
+    slot[1] = relX(r.x);
+    slot[2] = relY(r.y);
+    slot[3] = r.width / W;
+    slot[4] = r.height / H;
+    slot[5] = (float)platforms.items[k]->type;
+  }
+}
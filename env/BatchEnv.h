@@ -0,0 +1,61 @@
+#pragma once
+#include "RenoEnv.h"
+#include "core/JobSystem.h"
+#include "world/World.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Many independent games of one level, without a window: the batched
+// environment bots are trained and evaluated against.
+//
+// Every instance is a World on its own copy of the level, advanced by the
+// same fixed step as the game (WorldThread::TICK_SECONDS). Step() moves all
+// of them at once from an array of actions and writes observations into
+// one contiguous buffer (layout in RenoEnv.h). Instances are split across
+// the job system's workers, each writing only its own slice, so results do
+// not depend on the thread count. The C API (RenoEnv.h) wraps this class.
+class BatchEnv {
+public:
+  static constexpr int OBS_SIZE = RENO_OBS_SIZE;
+  static constexpr int INSTANCE_GRAIN = 16; // Instances per job
+
+  BatchEnv();
+  ~BatchEnv();
+  BatchEnv(const BatchEnv &) = delete;
+  BatchEnv &operator=(const BatchEnv &) = delete;
+
+  // Instances of the level at 'levelPath', laid out for the current
+  // Core::SCREEN_WIDTH/HEIGHT; threads as JobSystem::Start
+  bool Create(const char *levelPath, int count, int threads = -1);
+  void Destroy();
+
+  int GetCount() const { return (int)instances.size(); }
+  void SetAutoReset(bool value) { autoReset = value; }
+  void SetMaxTicks(int ticks) { maxTicks = ticks; }
+
+  void Reset(float *observations = nullptr);
+  void Reset(int index);
+
+  // actions: GetCount() RENO_ACTION_* masks; observations: GetCount() *
+  // OBS_SIZE floats; status: GetCount() RENO_STATUS_* values
+  void Step(const uint8_t *actions, float *observations, uint8_t *status);
+
+  const World &GetWorld(int index) const { return instances[index]->world; }
+
+private:
+  struct Instance {
+    Level level; // Own copy: flowers move per instance
+    World world;
+    bool exposed; // Last step
+  };
+
+  Level prototype; // Laid out once; instances restart from it
+  std::vector<std::unique_ptr<Instance>> instances;
+  JobSystem jobs;
+  bool autoReset;
+  int maxTicks;
+
+  void Restart(Instance &instance);
+  void Observe(const Instance &instance, float *out) const;
+};
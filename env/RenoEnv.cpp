@@ -0,0 +1,40 @@
+#include "RenoEnv.h"
+#include "BatchEnv.h"
+
+struct RenoEnv {
+  BatchEnv env;
+};
+
+RenoEnv *RenoEnvCreate(const char *levelPath, int count, int threads) {
+  RenoEnv *handle = new RenoEnv();
+  if (levelPath == nullptr || !handle->env.Create(levelPath, count, threads)) {
+    delete handle;
+    return nullptr;
+  }
+  return handle;
+}
+
+void RenoEnvDestroy(RenoEnv *env) { delete env; }
+
+int RenoEnvGetCount(const RenoEnv *env) { return env->env.GetCount(); }
+
+int RenoEnvGetObservationSize(void) { return RENO_OBS_SIZE; }
+
+void RenoEnvSetAutoReset(RenoEnv *env, int autoReset) {
+  env->env.SetAutoReset(autoReset != 0);
+}
+
+void RenoEnvSetMaxTicks(RenoEnv *env, int maxTicks) {
+  env->env.SetMaxTicks(maxTicks);
+}
+
+void RenoEnvReset(RenoEnv *env, float *observations) {
+  env->env.Reset(observations);
+}
+
+void RenoEnvResetOne(RenoEnv *env, int index) { env->env.Reset(index); }
+
+void RenoEnvStep(RenoEnv *env, const uint8_t *actions, float *observations,
+                 uint8_t *status) {
+  env->env.Step(actions, observations, status);
+}
@@ -0,0 +1,100 @@
+#ifndef RENO_ENV_H
+#define RENO_ENV_H
+// C API of the batched environment (see BatchEnv.h): many headless games
+// of one level, stepped together. No window or audio; links without a
+// display. All functions are for one calling thread at a time.
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(RENO_ENV_BUILD)
+#define RENO_ENV_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define RENO_ENV_API __declspec(dllimport)
+#else
+#define RENO_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Action of one instance for one step: bits below, OR'ed
+enum {
+  RENO_ACTION_LEFT = 1,
+  RENO_ACTION_RIGHT = 2,
+  RENO_ACTION_JUMP = 4,   // Jumps if grounded
+  RENO_ACTION_TOGGLE = 8, // Day <-> night
+};
+
+// Status of one instance after a step
+enum {
+  RENO_STATUS_RUNNING = 0,
+  RENO_STATUS_DIED = 1,
+  RENO_STATUS_EXIT = 2,    // Reached the exit
+  RENO_STATUS_TIMEOUT = 3, // Hit the tick limit (see RenoEnvSetMaxTicks)
+};
+
+// Observation of one instance: RENO_OBS_SIZE floats. Positions are relative
+// to the player's centre in screen units (1 = screen width or height),
+// flags are 0 or 1.
+enum {
+  RENO_OBS_PLAYER_X = 0, // Player centre, absolute
+  RENO_OBS_PLAYER_Y,
+  RENO_OBS_VELOCITY_X,   // In units of run speed / jump speed
+  RENO_OBS_VELOCITY_Y,
+  RENO_OBS_GROUNDED,
+  RENO_OBS_FACING_RIGHT,
+  RENO_OBS_HP,           // 0..1
+  RENO_OBS_EXPOSED,      // The sun burnt the player this step
+  RENO_OBS_IS_DAY,
+  RENO_OBS_EXIT_X,       // Exit centre
+  RENO_OBS_EXIT_Y,
+  RENO_OBS_SUN_X,
+  RENO_OBS_SUN_Y,
+
+  // Nearest enemies, nearest first; absent slots are all zero
+  RENO_OBS_ENEMIES,
+  RENO_OBS_ENEMY_COUNT = 4,
+  RENO_OBS_ENEMY_STRIDE = 4, // present, x, y (centre), moving right
+
+  // Nearest platforms solid at the current time of day, nearest first
+  RENO_OBS_PLATFORMS =
+      RENO_OBS_ENEMIES + RENO_OBS_ENEMY_COUNT * RENO_OBS_ENEMY_STRIDE,
+  RENO_OBS_PLATFORM_COUNT = 8,
+  RENO_OBS_PLATFORM_STRIDE = 6, // present, x, y (top left), width, height, type
+
+  RENO_OBS_SIZE =
+      RENO_OBS_PLATFORMS + RENO_OBS_PLATFORM_COUNT * RENO_OBS_PLATFORM_STRIDE,
+};
+
+typedef struct RenoEnv RenoEnv;
+
+// 'count' instances of the level at 'levelPath' (.lvl or .lvlb), stepped
+// on 'threads' workers besides the caller (< 0: hardware threads - 1).
+// NULL if the level does not load.
+RENO_ENV_API RenoEnv *RenoEnvCreate(const char *levelPath, int count,
+                                    int threads);
+RENO_ENV_API void RenoEnvDestroy(RenoEnv *env);
+
+RENO_ENV_API int RenoEnvGetCount(const RenoEnv *env);
+RENO_ENV_API int RenoEnvGetObservationSize(void); // RENO_OBS_SIZE
+
+// Finished instances restart on the next step (default) or stay finished
+RENO_ENV_API void RenoEnvSetAutoReset(RenoEnv *env, int autoReset);
+RENO_ENV_API void RenoEnvSetMaxTicks(RenoEnv *env, int maxTicks); // 0: none
+
+// Restart every instance; writes count * RENO_OBS_SIZE floats (may be NULL)
+RENO_ENV_API void RenoEnvReset(RenoEnv *env, float *observations);
+RENO_ENV_API void RenoEnvResetOne(RenoEnv *env, int index);
+
+// One 1/60 s step of every instance: 'actions' has one byte per instance,
+// 'observations' count * RENO_OBS_SIZE floats, 'status' one byte each
+// (either output may be NULL). With auto reset a finished instance reports
+// its status once and observes its restarted state.
+RENO_ENV_API void RenoEnvStep(RenoEnv *env, const uint8_t *actions,
+                              float *observations, uint8_t *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENO_ENV_H
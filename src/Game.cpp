@@ -1,43 +1,25 @@
 #include "Game.h"
-#include "entities/Roach.h"
-#include "entities/Spider.h"
+#include "core/Profiler.h"
+#include "core/Render.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <memory>
+#include <string>
 #include <tuple>
 
-// Helper: Check collision between a Line and a Rectangle
-bool CheckCollisionLineRect(Vector2 start, Vector2 end, Rectangle rect) {
-  // Check if either point is INSIDE
-  if (CheckCollisionPointRec(start, rect) || CheckCollisionPointRec(end, rect))
-    return true;
-
-  // Check against 4 edges
-  Vector2 p1 = {rect.x, rect.y};
-  Vector2 p2 = {rect.x + rect.width, rect.y};
-  Vector2 p3 = {rect.x + rect.width, rect.y + rect.height};
-  Vector2 p4 = {rect.x, rect.y + rect.height};
-
-  Vector2 collisionPoint;
-  if (CheckCollisionLines(start, end, p1, p2, &collisionPoint))
-    return true;
-  if (CheckCollisionLines(start, end, p2, p3, &collisionPoint))
-    return true;
-  if (CheckCollisionLines(start, end, p3, p4, &collisionPoint))
-    return true;
-  if (CheckCollisionLines(start, end, p4, p1, &collisionPoint))
-    return true;
-
-  return false;
-}
-
 Game::Game() {
   isDayTime = true;
+  nightBlend = 0.0f;
   debugMode = false;
   currentLevelIndex = 0;
   titleMusicLoaded = false;
-  currentPlayingMusic = nullptr;
-  isMusicPlaying = false;
-  isUnloaded = false;
-  sunHintShown = false;
-  sunHintTimer = 0.0f;
+  sunHintAlpha = 0.0f;
+  jumpSfx = burnSfx = deathSfx = -1;
+  isRecording = false;
+  playbackSegment = -1;
+  playbackMismatches = 0;
+  quitRequested = false;
 
   // Settings defaults
   masterVolume = 1.0f;
@@ -51,300 +33,432 @@ Game::Game() {
   // Initialize animation state
   flowerAnimFrameCount = 6;
   flowerAnimCurrentFrame = 0;
-  flowerAnimTimer = 0.0f;
   flowerAnimSpeed = 0.15f;
 }
 
-Game::~Game() {
-  if (!isUnloaded) {
-    Unload();
-  }
-}
+Game::~Game() { Unload(); }
 
-void Game::UnloadCurrentLevelEntities() {
-  for (auto *enemy : currentEnemies) {
-    delete enemy;
+void Game::Init() {
+  isDayTime = true; // Reset to Day on Init
+  nightBlend = 0.0f;
+
+  // Frame timings for the debug overlay (compiled out of release builds)
+  Profiler::SetThreadName("Main");
+  Profiler::SetEnabled(true);
+  Profiler::SetHitchBudget(HITCH_BUDGET_MS);
+  Profiler::SetHitchDescriber(
+      [this](Profiler::HitchNotes &notes) { DescribeForHitch(notes); });
+
+  // Night look is graded from the day textures (shader, or CPU fallback).
+  // Must run before queueing: decode jobs check which path is active.
+  colorGrade.Load();
+
+  // Assets decode on worker threads and upload a few per frame (see
+  // UpdateLoading, and the background pump in Update)
+  assetLoader.Start();
+  musicStreamer.Start();
+  sfx.Start();
+  jobs.Start();
+  world.SetJobs(&jobs);
+  world.computeSunRays = true; // Drawn as god rays
+  worldThread.Start(&world);   // Paused until gameplay
+  Resources::Init(&assetLoader, &colorGrade);
+  Resources::SetRenderSize(Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT);
+
+  // Read assets from the pack when there is one (built by the pack_assets
+  // target), loose files otherwise. Conditioned packs hold premultiplied
+  // images, which changes how everything is blended.
+  if (assetPack.Open(ASSET_PACK_PATH))
+    AssetFiles::Mount(&assetPack);
+  Render::SetPremultipliedAlpha(AssetFiles::IsPremultiplied());
+  colorGrade.SetPremultipliedAlpha(AssetFiles::IsPremultiplied());
+
+  // --- LEVEL DATA ---
+  // Levels are read up front from assets/levels/level1.lvl, level2.lvl...
+  // preferring the baked .lvlb the level compiler writes next to them.
+  // Their asset jobs write into them, so the vector is not resized after
+  // this; assets come in when a level is about to be played.
+  for (int n = 1;; n++) {
+    std::string path = TextFormat("assets/levels/level%d.lvlb", n);
+    if (!AssetFiles::Exists(path.c_str()))
+      path.pop_back();
+    if (!AssetFiles::Exists(path.c_str()))
+      break;
+    levels.emplace_back();
+    if (!levels.back().Load(path.c_str())) {
+      levels.pop_back();
+      break;
+    }
   }
-  currentEnemies.clear();
+  if (levels.empty())
+    TraceLog(LOG_FATAL, "LEVEL: No levels found in assets/levels");
+
+  // Scripts that run for the whole session
+  scripts.Spawn(SunHintScript());
+  scripts.Spawn(FlowerAnimScript());
+#if !defined(PLATFORM_WEB)
+  scripts.Spawn(LevelWatchScript());
+#endif
+
+  // Show the loading screen until the global and title assets are in
+  QueueGlobalAssets();
+  QueueTitleAssets();
+  currentScreen = LOADING;
 }
 
-void Game::Init() {
-  isDayTime = true; // Reset to Day on Init
+void Game::QueueGlobalAssets() {
+  if (!globalAssets.BeginLoad())
+    return;
+
+  using Resources::TextureOptions;
 
   // --- LOAD TEXTURES ---
 
   // Player textures
-  playerIdleTex = LoadTexture("assets/sprites/dayCharacter.png");
-  playerWalkSheet =
-      LoadTexture("assets/sprites/walkingDayCharAnimationSpreadsheet.png");
-  playerDeathTex = LoadTexture("assets/sprites/deathPlayerPot.png");
-
-  // Set player textures
-  player.sprite = playerIdleTex;
-  player.textureLoaded = true;
-  player.spritesheet = playerWalkSheet;
-  player.frameCount = 6;
-  player.frameSpeed = 0.1f;
-  player.animated = true;
-  player.deathSprite = playerDeathTex;
-  player.deathSpriteLoaded = true;
-
-  // Player size - images are now cropped to just the sprite content
-  player.width = (float)Core::SCREEN_HEIGHT * 0.12f;
-  player.height = (float)Core::SCREEN_HEIGHT * 0.12f;
+  // (display sizes in render heights: they pick the mip level)
+  QueueSprite(globalAssets, "assets/sprites/dayCharacter.png", &playerIdleTex,
+              TextureOptions::Mesh().WithDisplaySize(0.12f, 0.12f));
+  QueueSprite(globalAssets,
+              "assets/sprites/walkingDayCharAnimationSpreadsheet.png",
+              &playerWalkSheet,
+              TextureOptions::Mesh(6).WithDisplaySize(0.12f, 0.12f));
+  QueueSprite(globalAssets, "assets/sprites/deathPlayerPot.png",
+              &playerDeathTex,
+              TextureOptions::Mesh().WithDisplaySize(0.12f, 0.12f));
 
   // Enemy textures
-  roachTex = LoadTexture("assets/sprites/roach.png");
-  spiderSheet = LoadTexture("assets/sprites/spiderMoveSpreadsheet.png");
+  QueueSprite(globalAssets, "assets/sprites/roach.png", &roachTex,
+              TextureOptions::Mesh().WithDisplaySize(0.25f, 0.25f));
+  QueueSprite(globalAssets, "assets/sprites/spiderMoveSpreadsheet.png",
+              &spiderSheet,
+              TextureOptions::Mesh(2).WithDisplaySize(0.10f, 0.10f));
 
   // UI/Screen textures
-  introScreenTex = LoadTexture("assets/sprites/introScreenWithBackground.png");
-  introImageTex = LoadTexture("assets/sprites/introImage.png");
-  gameOverScreenTex = LoadTexture("assets/sprites/gameOverScreen.png");
-
-  // Exit zone (watering can) textures
-  waterPotDayTex = LoadTexture("assets/sprites/dayWaterPot.png");
-  waterPotNightTex = LoadTexture("assets/sprites/nightWaterPot.png");
-
-  // Platform textures
-  flowerTex = LoadTexture("assets/sprites/flower.png");
-  flowerAnimSheet =
-      LoadTexture("assets/sprites/flowerAnimationSpreadsheet.png");
-  mushroomDayTex = LoadTexture("assets/sprites/mushroomDayUpDown.png");
-  mushroomNightTex = LoadTexture("assets/sprites/nightShroom.png");
-  platformDayTex = LoadTexture("assets/sprites/PlatformTextureLevel1.png");
-  platformNightTex =
-      LoadTexture("assets/sprites/PlatformTextureLevel1Night.png");
+  QueueSprite(globalAssets, "assets/sprites/gameOverScreen.png",
+              &gameOverScreenTex);
+
+  // Exit zone (watering can) texture: 90 px high, 0.15 of the smallest
+  // render height
+  QueueSprite(globalAssets, "assets/sprites/dayWaterPot.png", &waterPotTex,
+              TextureOptions::Mesh().WithNight().WithDisplaySize(0.15f));
+
+  // Platform textures (flowers: 225x90 px, mushrooms: 0.08 W x 0.125 H)
+  QueueSprite(globalAssets, "assets/sprites/flower.png", &flowerTex,
+              TextureOptions().WithDisplaySize(0.15f, 0.375f));
+  QueueSprite(globalAssets, "assets/sprites/flowerAnimationSpreadsheet.png",
+              &flowerAnimSheet,
+              TextureOptions::Mesh(flowerAnimFrameCount)
+                  .WithDisplaySize(0.15f, 0.375f));
+  QueueSprite(globalAssets, "assets/sprites/mushroomDayUpDown.png",
+              &mushroomTex,
+              TextureOptions::Mesh().WithNight().WithDisplaySize(0.125f,
+                                                                 0.15f));
+  QueueSprite(globalAssets, "assets/sprites/PlatformTextureLevel1.png",
+              &platformTex, TextureOptions().WithNight());
 
   // --- LOAD AUDIO ---
-  jumpSound = LoadSound("assets/audio/jump_sound.wav");
-  walkSound = LoadSound("assets/audio/walk_sound.wav");
-  burnSound = LoadSound("assets/audio/burn_sound.wav");
-  deathSound = LoadSound("assets/audio/death_sound.wav");
-  wateringCanSound = LoadSound("assets/audio/watering_can.wav");
-
-  titleMusic = LoadMusicStream("assets/audio/titlescreenmusicmp3.mp3");
-  titleMusicLoaded = true;
-
-  // Helper lambda for relative coordinates
-  auto RelWidth = [](float p) { return p * Core::SCREEN_WIDTH; };
-  auto RelHeight = [](float p) { return p * Core::SCREEN_HEIGHT; };
+  QueueSound(globalAssets, "assets/audio/jump_sound.wav", &jumpSound);
+  QueueSound(globalAssets, "assets/audio/walk_sound.wav", &walkSound);
+  QueueSound(globalAssets, "assets/audio/burn_sound.wav", &burnSound);
+  QueueSound(globalAssets, "assets/audio/death_sound.wav", &deathSound);
+  QueueSound(globalAssets, "assets/audio/watering_can.wav", &wateringCanSound);
 
-  // --- LOAD LEVEL DATA ---
-
-  // LEVEL 1
-  Level lvl1;
+  globalAssets.EndQueue();
+}
 
-  // Backgrounds (from images)
-  Texture2D lvl1DayBg = LoadTexture("assets/sprites/level1day.png");
-  Texture2D lvl1NightBg = LoadTexture("assets/sprites/level1night.jpg");
-  lvl1.backgrounds = std::make_tuple(lvl1DayBg, lvl1NightBg);
+void Game::QueueTitleAssets() {
+  if (!titleAssets.BeginLoad())
+    return;
 
-  // Foregrounds
-  lvl1.foregroundDay = LoadTexture("assets/sprites/foregroundDay.png");
-  lvl1.foregroundNight = LoadTexture("assets/sprites/foregroundNight.png");
-  lvl1.hasForeground = true;
+  QueueSprite(titleAssets, "assets/sprites/introScreenWithBackground.png",
+              &introScreenTex);
+  QueueSprite(titleAssets, "assets/sprites/introImage.png", &introImageTex);
+  QueueMusic(titleAssets, "assets/audio/titlescreenmusicmp3.mp3", &titleMusic,
+             &titleMusicLoaded);
 
-  // Music
-  lvl1.dayMusic = LoadMusicStream("assets/audio/lvlupjam_lvl1.wav");
-  lvl1.nightMusic = LoadMusicStream("assets/audio/lvlupjam_lvl1_night.wav");
-  lvl1.hasDayMusic = true;
-  lvl1.hasNightMusic = true;
+  titleAssets.EndQueue();
+}
 
-  levels.push_back(lvl1);
+void Game::QueueLevelAssets(int index) {
+  if (index < 0 || index >= (int)levels.size())
+    return;
+  Level &lvl = levels[index];
+  if (!lvl.assets.BeginLoad())
+    return;
 
-  // LEVEL 2
-  Level lvl2;
-  Texture2D lvl2DayBg = LoadTexture("assets/sprites/level2day.png");
-  Texture2D lvl2NightBg = LoadTexture("assets/sprites/level2night.png");
-  lvl2.backgrounds = std::make_tuple(lvl2DayBg, lvl2NightBg);
+  // Background (from image, night graded from day)
+  QueueSprite(lvl.assets, lvl.dayBackgroundPath.c_str(), &lvl.background,
+              Resources::TextureOptions().WithNight());
 
-  // No foreground for level 2
-  lvl2.hasForeground = false;
+  // Foreground (mostly transparent full-screen layer: trim to opaque cells)
+  if (lvl.hasForeground) {
+    QueueSprite(lvl.assets, lvl.foregroundPath.c_str(), &lvl.foreground,
+                Resources::TextureOptions::Mesh(1, SpriteMesh::Mode::GRID)
+                    .WithNight());
+  }
 
   // Music
-  lvl2.dayMusic = LoadMusicStream("assets/audio/lvlupjam_lvl2.wav");
-  lvl2.nightMusic = LoadMusicStream("assets/audio/lvlupjam_lvl2_night.wav");
-  lvl2.hasDayMusic = true;
-  lvl2.hasNightMusic = true;
-
-  lvl2.isDay = false;
-  levels.push_back(lvl2);
-
-  // Initialize geometry for current resolution
-  RebuildLevelGeometry();
-
-  // Initial Load
-  currentScreen = TITLE;
+  if (!lvl.dayMusicPath.empty())
+    QueueMusic(lvl.assets, lvl.dayMusicPath.c_str(), &lvl.dayMusic,
+               &lvl.hasDayMusic);
+  if (!lvl.nightMusicPath.empty())
+    QueueMusic(lvl.assets, lvl.nightMusicPath.c_str(), &lvl.nightMusic,
+               &lvl.hasNightMusic);
+
+  lvl.assets.EndQueue();
 }
 
-void Game::RebuildLevelGeometry() {
-  float W = (float)Core::SCREEN_WIDTH;
-  float H = (float)Core::SCREEN_HEIGHT;
+void Game::EnsureLevelResident(int index) {
+  Level &lvl = levels[index];
+  if (lvl.assets.IsResident())
+    return;
 
-  // Clear existing platforms and enemies for all levels
-  for (auto &lvl : levels) {
-    lvl.platforms.clear();
-    lvl.enemies.clear();
+  // The prefetch missed (level skip, reset after a resolution change...):
+  // finish the remaining jobs now rather than play without art
+  TraceLog(LOG_WARNING, "ASSETS: Level %d not prefetched, loading now",
+           index + 1);
+  QueueLevelAssets(index);
+  while (!lvl.assets.IsResident()) {
+    assetLoader.Pump(1.0);
+    if (!lvl.assets.IsResident())
+      WaitTime(0.001); // Decodes still running on the workers
   }
+}
 
-  // LEVEL 1 Geometry
-  Level &lvl1 = levels[0];
-  lvl1.spawnPoint = {W * 0.85f, H * 0.75f}; // Spawn on right side
-  lvl1.platforms = {
-      // Main Ground
-      {{0, H * 0.9375f, W, H * 0.0625f}, basic},
-
-      // Boundaries (Invisible) - All 4 sides
-      {{-20, 0, 20, H}, invisible}, // Left Wall
-      {{W, 0, 20, H}, invisible},   // Right Wall
-      {{0, -20, W, 20}, invisible}, // Ceiling
-      {{0, H, W, 20}, invisible},   // Floor (fallback)
-
-      // Level Platforms (proportional)
-      {{W * 0.57f, H * 0.5f, W * 0.43f, 30}, basic},
-      {{0, H * 0.5f, W * 0.23f, 30}, basic},
-      {{W * 0.31f, H * 0.84f, W * 0.08f, H * 0.125f}, mushroom},
-  };
-
-  // Sun: Top Center
-  lvl1.sunPosition = {W / 2, 50.0f};
-  lvl1.isDay = true;
-  lvl1.exitZone = {50, H * 0.5f - 65, 100, 50};
-
-  // LEVEL 2 Geometry
-  Level &lvl2 = levels[1];
-  lvl2.spawnPoint = {50, H * 0.75f};
-
-  // Platforms (all proportional) - Lowered for easier difficulty
-  lvl2.platforms = {
-      // Ground
-      {{0, H * 0.9375f, W, H * 0.0625f}, basic},
-
-      // Boundaries - all 4 sides
-      {{-20, 0, 20, H}, invisible},
-      {{W, 0, 20, H}, invisible},
-      {{0, -20, W, 20}, invisible},
-      {{0, H, W, 20}, invisible},
-
-      // Flower Platform (Lowered: 0.56 -> 0.65)
-      {{W * 0.5f - 75, H * 0.65f, 150, 30}, flower},
-
-      // Steps leading up
-      {{W * 0.15f, H * 0.85f, 150, 30}, basic}, // Step 1
-      {{W * 0.31f, H * 0.75f, 150, 30}, basic}, // Step 2
-
-      // Right side high ground (Lowered: 0.5 -> 0.6)
-      {{W * 0.69f, H * 0.6f, W * 0.23f, 30}, basic},
-
-      // Bridging Platforms to Goal (Lowered ~0.15)
-      {{W * 0.80f, H * 0.45f, 150, 30}, basic},
-      {{W * 0.55f, H * 0.35f, 150, 30}, basic},
-      {{W * 0.5f + 50, H * 0.25f, 150, 30}, basic},
-
-      // Floating island high up (Goal) (Lowered: 0.05 -> 0.15)
-      {{W * 0.5f - 200, H * 0.15f, 400, 30}, basic},
-  };
+void Game::FinishLoading() {
+  // Set player textures
+  Player &player = world.player;
+  player.sprite = playerIdleTex;
+  player.spritesheet = playerWalkSheet;
+  player.frameCount = 6;
+  player.frameSpeed = 0.1f;
+  player.animated = true;
+  player.deathSprite = playerDeathTex;
 
-  // Enemy (Stationary blocker on the way to the goal)
-  float step2Y = H * 0.75f; // Matches Step 2
-  float roachHeight = H * 0.25f;
+  // Enemy textures (the simulation's enemies are drawn through these)
+  roachView.sprite = roachTex;
+  spiderView.spritesheet = spiderSheet;
+  spiderView.frameCount = 2;
+  spiderView.animated = true;
+
+  // Sound effects through the mixer's voice pool. Death outranks the rest
+  // and jumps may overlap; the burn loops on one voice.
+  SfxMixer::SoundDesc jumpDesc;
+  jumpDesc.bus = SfxMixer::Bus::PLAYER;
+  jumpDesc.priority = 1;
+  jumpDesc.maxVoices = 2;
+  jumpSfx = sfx.Register(Resources::GetSound(jumpSound), jumpDesc);
+
+  SfxMixer::SoundDesc burnDesc;
+  burnDesc.bus = SfxMixer::Bus::PLAYER;
+  burnDesc.priority = 0;
+  burnDesc.maxVoices = 1;
+  burnDesc.restart = false;
+  burnSfx = sfx.Register(Resources::GetSound(burnSound), burnDesc);
+
+  SfxMixer::SoundDesc deathDesc;
+  deathDesc.bus = SfxMixer::Bus::ENEMY;
+  deathDesc.priority = 2;
+  deathDesc.maxVoices = 1;
+  deathSfx = sfx.Register(Resources::GetSound(deathSound), deathDesc);
 
-  lvl2.enemies.push_back(
-      {{W * 0.35f, step2Y - roachHeight}, {0, 0}, true, 5, roach});
+  currentScreen = TITLE;
+}
 
-  // Spider on Goal Island (Patrolling)
-  float spiderHeight = H * 0.10f;
-  // Matches Goal Island Y (0.15)
-  lvl2.enemies.push_back(
-      {{W * 0.5f, H * 0.15f - spiderHeight}, {0, 0}, true, 5, spider});
+void Game::QueueSprite(AssetGroup &group, const char *path,
+                       Resources::TextureHandle *out,
+                       const Resources::TextureOptions &options) {
+  AssetGroup *owner = &group;
+  group.AddJob();
+  Resources::TextureHandle handle = Resources::AcquireTexture(
+      path, options, [owner]() { owner->JobDone(); });
+  *out = handle;
+
+  group.OnRelease([out, handle]() {
+    Resources::Release(handle);
+    *out = Resources::TextureHandle();
+  });
+}
 
-  // Sun: Top Right (Away from Exit)
-  lvl2.sunPosition = {W - 100, 100.0f};
+void Game::QueueSound(AssetGroup &group, const char *path,
+                      Resources::SoundHandle *out) {
+  AssetGroup *owner = &group;
+  group.AddJob();
+  Resources::SoundHandle handle =
+      Resources::AcquireSound(path, [owner]() { owner->JobDone(); });
+  *out = handle;
+
+  group.OnRelease([out, handle]() {
+    Resources::Release(handle);
+    *out = Resources::SoundHandle();
+  });
+}
 
-  lvl2.exitZone = {W * 0.5f - 50, H * 0.15f - 20, 100, 50};
+void Game::QueueMusic(AssetGroup &group, const char *path, Music *out,
+                      bool *loaded) {
+  // Streams decode while playing; the worker only fetches the bytes (a view
+  // of the pack mapping when packed). They must outlive the stream, so they
+  // are dropped with it on release.
+  auto bytes = std::make_shared<AssetBytes>();
+  std::string file = path;
+  AssetGroup *owner = &group;
+  *out = {0};
+  *loaded = false;
+
+  group.AddJob();
+  assetLoader.Queue(
+      [bytes, file]() {
+        if (AssetFiles::Exists(file.c_str()))
+          *bytes = AssetFiles::Read(file.c_str());
+      },
+      [bytes, owner, out, loaded]() {
+        if (bytes->IsValid()) {
+          *out = LoadMusicStreamFromMemory(bytes->fileType.c_str(),
+                                           bytes->data, (int)bytes->size);
+          *loaded = out->stream.buffer != nullptr;
+          if (*loaded) {
+            owner->OnRelease([out, loaded, bytes]() {
+              UnloadMusicStream(*out);
+              *bytes = AssetBytes();
+              *out = {0};
+              *loaded = false;
+            });
+          }
+        }
+        owner->JobDone();
+      },
+      [owner]() { owner->JobDone(); });
 }
 
 void Game::LoadLevel(int index) {
   if (index >= levels.size())
     return;
+  PROFILE_SCOPE("Game::LoadLevel");
+  Profiler::Instant("LoadLevel");
+
+  // The world is reset below: no step may run meanwhile
+  worldThread.Pause();
+
+  // Stop current music first: it may belong to a level released below
+  musicStreamer.Halt();
+
+  // Only the level being played stays resident
+  for (int i = 0; i < (int)levels.size(); i++) {
+    if (i != index)
+      levels[i].assets.Release();
+  }
+  EnsureLevelResident(index);
 
   currentLevelIndex = index;
   Level &lvl = levels[currentLevelIndex];
+  lvl.Layout((float)Core::SCREEN_WIDTH, (float)Core::SCREEN_HEIGHT);
+
+  // Set Game State: player at the spawn, enemies spawned (the thread
+  // resumes at the end of the frame)
+  world.Start(lvl, isDayTime);
+  worldThread.Publish();
+  if (isRecording)
+    recording.BeginSegment(lvl, index, world);
+
+  // Start level music: both tracks run in step, T crossfades between them
+  musicStreamer.Play(lvl.hasDayMusic ? &lvl.dayMusic : nullptr,
+                     lvl.hasNightMusic ? &lvl.nightMusic : nullptr,
+                     !isDayTime);
+}
 
-  // Set Game State
-  player.position = lvl.spawnPoint;
-  player.velocity = {0, 0};
-  player.hp = player.maxHp;
-  player.isDead = false;
-
-  // Spawn Enemies
-  UnloadCurrentLevelEntities();
-  for (const auto &config : lvl.enemies) {
-    if (config.type == EnemyType::ROACH) {
-      Roach *r = new Roach(config.position);
-      r->sprite = roachTex;
-      r->textureLoaded = true;
-      r->width = (float)Core::SCREEN_HEIGHT * 0.25f;
-      r->height = (float)Core::SCREEN_HEIGHT * 0.25f;
-      currentEnemies.push_back(r);
-    } else if (config.type == EnemyType::SPIDER) {
-      Spider *s = new Spider(config.position);
-      s->spritesheet = spiderSheet;
-      s->frameCount = 2;
-      s->frameSpeed = 0.2f;
-      s->animated = true;
-      s->width = (float)Core::SCREEN_HEIGHT * 0.10f;
-      s->height = (float)Core::SCREEN_HEIGHT * 0.10f;
-      currentEnemies.push_back(s);
-    }
-  }
+void Game::ResetGame() { LoadLevel(currentLevelIndex); }
+
+void Game::HotReloadLevel() {
+  Profiler::Instant("HotReloadLevel");
+  StopRecording(); // An edited level cannot be replayed
+  worldThread.Pause(); // Resumed at the end of the frame
+  if (world.ReloadLevel())
+    worldThread.Publish();
+}
 
-  // Stop current music and start level music
-  if (isMusicPlaying && currentPlayingMusic != nullptr) {
-    StopMusicStream(*currentPlayingMusic);
-    isMusicPlaying = false;
-    currentPlayingMusic = nullptr;
+Scheduler::Task Game::SunHintScript() {
+  // Show the hint on the first sun hit: 3 seconds, then a 1 second fade
+  co_await sunBurn;
+  sunHintAlpha = 1.0f;
+  co_await scripts.Delay(3.0f);
+  for (float t = 0.0f; t < 1.0f; t += scripts.GetDeltaTime()) {
+    sunHintAlpha = 1.0f - t;
+    co_await scripts.NextFrame();
   }
+  sunHintAlpha = 0.0f;
+}
 
-  // Start level music
-  if (isDayTime && lvl.hasDayMusic) {
-    PlayMusicStream(lvl.dayMusic);
-    currentPlayingMusic = &lvl.dayMusic;
-    isMusicPlaying = true;
-  } else if (!isDayTime && lvl.hasNightMusic) {
-    PlayMusicStream(lvl.nightMusic);
-    currentPlayingMusic = &lvl.nightMusic;
-    isMusicPlaying = true;
+Scheduler::Task Game::FlowerAnimScript() {
+  while (true) {
+    co_await scripts.Delay(flowerAnimSpeed);
+    flowerAnimCurrentFrame =
+        (flowerAnimCurrentFrame + 1) % flowerAnimFrameCount;
   }
 }
 
-void Game::ResetGame() { LoadLevel(currentLevelIndex); }
+Scheduler::Task Game::LevelWatchScript() {
+  // Edited .lvl / recompiled .lvlb next to the game, while playing
+  while (true) {
+    co_await scripts.Delay(LEVEL_WATCH_INTERVAL);
+    if (levels[currentLevelIndex].HasChangedOnDisk())
+      HotReloadLevel();
+  }
+}
 
 void Game::Update() {
+  // Everything since the last Update (the last Draw included) is a frame
+  Profiler::EndFrame();
+  PROFILE_SCOPE("Game::Update");
+
   // Debug Toggle
   if (IsKeyPressed(KEY_H)) {
     debugMode = !debugMode;
   }
 
-  // Update music stream
-  if (isMusicPlaying && currentPlayingMusic != nullptr) {
-    UpdateMusicStream(*currentPlayingMusic);
+  // Frame capture toggle (QOI sequence: much cheaper to encode than PNG)
+  if (IsKeyPressed(KEY_F9)) {
+    if (frameCapture.IsRecording())
+      frameCapture.Stop();
+    else
+      frameCapture.Start("captures", FrameCapture::Format::QOI);
   }
 
+  // Trace recording toggle (Chrome trace events: chrome://tracing or
+  // ui.perfetto.dev)
+  if (IsKeyPressed(KEY_F10)) {
+    if (Profiler::IsTracing())
+      Profiler::StopTrace();
+    else
+      Profiler::StartTrace("traces");
+  }
+
+  // Replay recording toggle
+  if (IsKeyPressed(KEY_F8) && !IsPlayingBack()) {
+    if (isRecording)
+      StopRecording();
+    else
+      StartRecording();
+  }
+
+  // Background loading (prefetched levels, title assets) outside the
+  // loading screen, with a smaller budget
+  if (currentScreen != LOADING)
+    assetLoader.Pump(BACKGROUND_LOAD_BUDGET_SECONDS);
+
+  // Music and sound effects mix on their own threads; these only do it
+  // without threads (web)
+  musicStreamer.Pump();
+  sfx.Pump();
+
   // State Machine
   switch (currentScreen) {
+  case LOADING:
+    UpdateLoading();
+    break;
   case TITLE:
-    // Update title music
-    if (titleMusicLoaded) {
-      UpdateMusicStream(titleMusic);
-    }
     UpdateTitle();
     break;
   case STORY:
-    if (titleMusicLoaded) {
-      UpdateMusicStream(titleMusic);
-    }
     UpdateStory();
     break;
   case GAMEPLAY:
@@ -357,20 +471,215 @@ void Game::Update() {
     UpdateSettings();
     break;
   case WIN:
-    if (titleMusicLoaded) {
-      UpdateMusicStream(titleMusic);
-    }
     UpdateWin();
     break;
   }
+
+  // The simulation runs while the game is played, and only then
+  if (currentScreen == GAMEPLAY)
+    worldThread.Resume();
+  else
+    worldThread.Pause();
+}
+
+void Game::DescribeForHitch(Profiler::HitchNotes &notes) {
+  static const char *SCREEN_NAMES[] = {"LOADING", "TITLE",    "STORY",
+                                       "GAMEPLAY", "SETTINGS", "WIN",
+                                       "GAME_OVER"};
+  char value[128];
+  auto note = [&](const char *key) { notes.push_back({key, value}); };
+
+  snprintf(value, sizeof(value), "%s", SCREEN_NAMES[currentScreen]);
+  note("screen");
+  snprintf(value, sizeof(value), "%d", currentLevelIndex + 1);
+  note("level");
+
+  // State of the last snapshot (the simulation may be a step further)
+  const WorldSnapshot &view = worldThread.Latest();
+  snprintf(value, sizeof(value), "%s", view.isDayTime ? "day" : "night");
+  note("time");
+  snprintf(value, sizeof(value), "%llu", (unsigned long long)view.tick);
+  note("tick");
+  snprintf(value, sizeof(value), "%s", worldThread.IsPaused() ? "yes" : "no");
+  note("simulationPaused");
+  const Player &p = view.player;
+  snprintf(value, sizeof(value),
+           "pos %.1f,%.1f vel %.1f,%.1f hp %.2f%s%s", p.position.x,
+           p.position.y, p.velocity.x, p.velocity.y, p.hp,
+           p.isGrounded ? " grounded" : "", p.isDead ? " dead" : "");
+  note("player");
+  snprintf(value, sizeof(value), "%d", (int)view.enemies.size());
+  note("enemies");
+  snprintf(value, sizeof(value), "%d", (int)view.platforms.size());
+  note("platforms");
+
+  snprintf(value, sizeof(value), "%s",
+           musicStreamer.IsPlaying() ? "playing" : "stopped");
+  note("music");
+  snprintf(value, sizeof(value), "%d", sfx.GetDroppedCount());
+  note("sfxDropped");
+  snprintf(value, sizeof(value), "%d of %d", assetLoader.GetFinishedCount(),
+           assetLoader.GetQueuedCount());
+  note("assetJobs");
+  Resources::CacheStats cache = Resources::GetStats();
+  snprintf(value, sizeof(value),
+           "%d textures %d sounds, %.1f MB, %d swapping, %d misses",
+           cache.textures, cache.sounds,
+           (double)(cache.textureBytes + cache.soundBytes) / (1024.0 * 1024.0),
+           cache.swapping, cache.misses);
+  note("resources");
+  const Render::FrameStats &draw = Render::GetLastFrameStats();
+  snprintf(value, sizeof(value), "%d draws, %d batches", draw.draws,
+           draw.batches);
+  note("lastFrameDraws");
+  snprintf(value, sizeof(value), "%s",
+           isRecording ? "recording"
+                       : (IsPlayingBack() ? "playing back" : "off"));
+  note("replay");
+}
+
+void Game::StartRecording() {
+  worldThread.Pause(); // Resumed at the end of the frame
+  recording.Begin(WorldThread::TICK_SECONDS);
+  worldThread.SetRecording(&recording);
+  isRecording = true;
+  TraceLog(LOG_INFO, "REPLAY: recording");
+  // Segments start with a level: restart the one being played (otherwise
+  // the next level loaded begins the recording)
+  if (currentScreen == GAMEPLAY)
+    LoadLevel(currentLevelIndex);
+}
+
+void Game::StopRecording() {
+  if (!isRecording)
+    return;
+  worldThread.Pause(); // Every step is in before the file is written
+  worldThread.SetRecording(nullptr);
+  isRecording = false;
+  if (recording.IsEmpty())
+    return;
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+  MakeDirectory("replays");
+  std::string path = std::string("replays/replay_") + stamp + ".rrpl";
+  recording.Save(path.c_str());
+}
+
+bool Game::PlayReplay(const char *path) {
+  if (!playback.Load(path))
+    return false;
+  if (playback.segments.empty()) {
+    TraceLog(LOG_WARNING, "REPLAY: %s is empty", path);
+    return false;
+  }
+  playbackPath = path;
+  playbackSegment = -1;
+  playbackMismatches = 0;
+  playbackFrameMs.clear();
+  TraceLog(LOG_INFO, "REPLAY: playing %s (%zu steps, %zu segments)", path,
+           playback.GetStepCount(), playback.segments.size());
+  return true;
+}
+
+void Game::StartPlaybackSegment(int index) {
+  const Replay::Segment &segment = playback.segments[index];
+  if (segment.levelIndex < 0 || segment.levelIndex >= (int)levels.size() ||
+      Replay::HashLevel(levels[segment.levelIndex]) != segment.levelHash) {
+    TraceLog(LOG_WARNING, "REPLAY: %s is not the level that was recorded",
+             segment.levelPath.c_str());
+    FinishPlayback();
+    return;
+  }
+
+  // Physics scales with the screen: play at the recorded size
+  if (segment.screenWidth != Core::SCREEN_WIDTH ||
+      segment.screenHeight != Core::SCREEN_HEIGHT) {
+    int match = -1;
+    for (int i = 0; i < RES_COUNT; i++) {
+      if (resOptions[i].width == segment.screenWidth &&
+          resOptions[i].height == segment.screenHeight)
+        match = i;
+    }
+    if (match < 0) {
+      TraceLog(LOG_WARNING, "REPLAY: no %dx%d resolution to play back at",
+               segment.screenWidth, segment.screenHeight);
+      FinishPlayback();
+      return;
+    }
+    selectedResIndex = match;
+    previousScreen = TITLE; // The level is loaded below
+    ApplyResolution();
+  }
+
+  playbackSegment = index;
+  currentScreen = GAMEPLAY;
+  titleAssets.Release(); // The menus are not coming back
+  isDayTime = segment.startAtDay;
+  LoadLevel(segment.levelIndex); // Pauses the simulation
+  playbackCursor.Begin(playback, index);
+  worldThread.SetPlayback(&playbackCursor);
+}
+
+void Game::UpdatePlayback() {
+  playbackFrameMs.push_back(GetFrameTime() * 1000.0f);
+  if (!playbackCursor.IsDone())
+    return;
+
+  worldThread.Pause(); // The counts are final once no step runs
+  int mismatches = playbackCursor.GetMismatches();
+  if (mismatches > 0) {
+    TraceLog(LOG_WARNING,
+             "REPLAY: segment %d diverged at step %lld (%d of %zu steps "
+             "differ)",
+             playbackSegment + 1, playbackCursor.GetFirstMismatch(),
+             mismatches, playbackCursor.GetStep());
+  }
+  playbackMismatches += mismatches;
+  if (playbackSegment + 1 < (int)playback.segments.size())
+    StartPlaybackSegment(playbackSegment + 1);
+  else
+    FinishPlayback();
+}
+
+void Game::FinishPlayback() {
+  worldThread.Pause();
+  worldThread.SetPlayback(nullptr);
+  quitRequested = true;
+
+  std::vector<float> frames = playbackFrameMs;
+  std::sort(frames.begin(), frames.end());
+  auto percentile = [&](float p) {
+    if (frames.empty())
+      return 0.0f;
+    size_t i = std::min(frames.size() - 1, (size_t)(p * frames.size()));
+    return frames[i];
+  };
+  TraceLog(LOG_INFO, "REPLAY: %s: %d segments played, %d steps differ",
+           playbackPath.c_str(), playbackSegment + 1, playbackMismatches);
+  TraceLog(LOG_INFO,
+           "REPLAY: %zu frames, ms p50 %.2f p90 %.2f p99 %.2f max %.2f",
+           frames.size(), percentile(0.50f), percentile(0.90f),
+           percentile(0.99f), frames.empty() ? 0.0f : frames.back());
+  playbackPath.clear();
+}
+
+void Game::UpdateLoading() {
+  assetLoader.Pump(LOAD_BUDGET_SECONDS);
+  if (globalAssets.IsResident() && titleAssets.IsResident()) {
+    FinishLoading();
+    if (IsPlayingBack())
+      StartPlaybackSegment(0); // Straight into the recording
+  }
 }
 
 void Game::UpdateTitle() {
-  if (titleMusicLoaded && !IsMusicStreamPlaying(titleMusic)) {
-    PlayMusicStream(titleMusic);
+  if (titleMusicLoaded && !musicStreamer.IsPlaying()) {
+    musicStreamer.Play(titleMusic);
   }
   if (IsKeyPressed(KEY_ENTER)) {
     currentScreen = STORY;
+    QueueLevelAssets(0); // Loads while the story is read
   }
   if (IsKeyPressed(KEY_ESCAPE)) {
     previousScreen = TITLE;
@@ -381,11 +690,10 @@ void Game::UpdateTitle() {
 void Game::UpdateStory() {
   if (IsKeyPressed(KEY_ENTER)) {
     // Stop title music
-    if (titleMusicLoaded) {
-      StopMusicStream(titleMusic);
-    }
+    musicStreamer.Halt();
     currentScreen = GAMEPLAY;
     LoadLevel(0);
+    titleAssets.Release(); // Back in for the win/title screens
   }
 }
 
@@ -397,147 +705,100 @@ void Game::UpdateGameOver() {
 }
 
 void Game::UpdateGameplay() {
+  PROFILE_SCOPE("Game::UpdateGameplay");
   float dt = GetFrameTime();
 
   // Level Switching (Test)
-  if (IsKeyPressed(KEY_L)) {
+  if (IsKeyPressed(KEY_L) && !IsPlayingBack()) {
     LoadLevel((currentLevelIndex + 1) % levels.size());
   }
 
-  // Day/Night Toggle
-  if (IsKeyPressed(KEY_T)) {
-    isDayTime = !isDayTime;
-
-    // Switch music on day/night toggle
-    Level &lvl = levels[currentLevelIndex];
-    if (isMusicPlaying && currentPlayingMusic != nullptr) {
-      StopMusicStream(*currentPlayingMusic);
-    }
-    if (isDayTime && lvl.hasDayMusic) {
-      PlayMusicStream(lvl.dayMusic);
-      currentPlayingMusic = &lvl.dayMusic;
-      isMusicPlaying = true;
-    } else if (!isDayTime && lvl.hasNightMusic) {
-      PlayMusicStream(lvl.nightMusic);
-      currentPlayingMusic = &lvl.nightMusic;
-      isMusicPlaying = true;
-    }
-  }
-
-  // Update flower animation
-  flowerAnimTimer += dt;
-  if (flowerAnimTimer >= flowerAnimSpeed) {
-    flowerAnimTimer -= flowerAnimSpeed;
-    flowerAnimCurrentFrame =
-        (flowerAnimCurrentFrame + 1) % flowerAnimFrameCount;
+  // Controls go to the simulation; it steps on its own clock (a replay
+  // being played back feeds it instead)
+  if (!IsPlayingBack()) {
+    WorldInput input;
+    input.player.left = IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A);
+    input.player.right = IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D);
+    input.player.jump = IsKeyPressed(KEY_SPACE);
+    input.toggleTime = IsKeyPressed(KEY_T); // Day/Night Toggle
+    worldThread.PostInput(input);
+    Profiler::Counter("Input", Replay::PackInput(input));
   }
-
-  Level &currentLvl = levels[currentLevelIndex];
-
-  // Dynamic Platform Logic (Flower)
-  for (auto &plat : currentLvl.platforms) {
-    if (plat.type == PlatformType::FLOWER) {
-      float targetY = plat.initialY;
-      if (!isDayTime) {
-        targetY = plat.initialY + 200.0f;
-      }
-
-      float moveSpeed = 5.0f;
-      float diff = targetY - plat.rect.y;
-      float moveY = diff * moveSpeed * dt;
-      plat.rect.y += moveY;
-
-      Rectangle pRect = player.GetRect();
-      if (pRect.x + pRect.width > plat.rect.x &&
-          pRect.x < plat.rect.x + plat.rect.width) {
-        float bottom = pRect.y + pRect.height;
-        if (bottom <= plat.rect.y + 10 && bottom >= plat.rect.y - 10) {
-          player.position.y += moveY;
-        }
-      }
+  worldThread.Pump(dt); // Steps here without threads (web)
+
+  // What the steps since the last frame did
+  bool died = false;
+  bool reachedExit = false;
+  WorldEvents events;
+  while (worldThread.PollEvents(events)) {
+    isDayTime = events.isDayTime;
+    if (events.timeToggled) {
+      // Crossfade to the other track (already playing, in step)
+      musicStreamer.SetNight(!isDayTime);
+    }
+    if (events.jumped)
+      sfx.Play(jumpSfx);
+    if (events.caught)
+      sfx.Play(deathSfx);
+    if (events.burning) {
+      // Burn sound: one voice that is not restarted, so posting every
+      // step plays it back to back rather than stacking
+      sfx.Play(burnSfx);
+      sunBurn.Fire();
     }
+    died |= events.died;
+    reachedExit |= events.reachedExit;
   }
 
-  // Detect jump for sound
-  bool wasGrounded = player.isGrounded;
+  // Ease the graded look towards the current day/night state
+  float blendTarget = isDayTime ? 0.0f : 1.0f;
+  nightBlend += (blendTarget - nightBlend) * std::min(1.0f, dt * 6.0f);
+  if (std::fabs(blendTarget - nightBlend) < 0.001f)
+    nightBlend = blendTarget;
 
-  // Player Update
-  player.Update(dt, currentLvl.platforms, isDayTime);
-
-  // Play jump sound
-  if (wasGrounded && !player.isGrounded && player.velocity.y < 0) {
-    PlaySound(jumpSound);
+  // Scripts and timed events (sun hint, flower animation, level watch)
+  {
+    PROFILE_SCOPE("Scheduler::Update");
+    scripts.Update(dt);
   }
 
-  // Enemies Update (only at night)
-  if (!isDayTime) {
-    for (auto *enemy : currentEnemies) {
-      enemy->Update(dt, currentLvl);
-
-      // Collision Check
-      if (CheckCollisionRecs(player.GetRect(), enemy->GetRect())) {
-        if (!player.isDead) {
-          PlaySound(deathSound);
-        }
-        player.Die();
-      }
-    }
+  // Played back: the recording's segments decide what comes next
+  if (IsPlayingBack()) {
+    UpdatePlayback();
+    return;
   }
 
-  // Sun Damage (Raycast Logic)
-  if (isDayTime) {
-    bool isExposed = true;
-    Rectangle playerRect = player.GetRect();
-    Vector2 playerCenter = {playerRect.x + playerRect.width / 2.0f,
-                            playerRect.y + playerRect.height / 2.0f};
-    Vector2 sunPos = levels[currentLevelIndex].sunPosition;
-
-    for (const auto &plat : currentLvl.platforms) {
-      if (!plat.IsSolid(isDayTime))
-        continue;
-      if (CheckCollisionLineRect(sunPos, playerCenter, plat.rect)) {
-        isExposed = false;
-        break;
-      }
-    }
-
-    if (isExposed) {
-      player.TakeDamage(1.0f * dt);
-      // Play burn sound occasionally (not every frame)
-      if (!IsSoundPlaying(burnSound) && player.hp > 0) {
-        PlaySound(burnSound);
-      }
-      // Show hint on first sun hit
-      if (!sunHintShown) {
-        sunHintShown = true;
-        sunHintTimer = 4.0f; // Show for 4 seconds
-      }
-    }
-  }
+  Level &currentLvl = levels[currentLevelIndex];
 
   // Game Over Check
-  if (player.isDead) {
-    if (isMusicPlaying && currentPlayingMusic != nullptr) {
-      StopMusicStream(*currentPlayingMusic);
-      isMusicPlaying = false;
-      currentPlayingMusic = nullptr;
-    }
+  if (died) {
+    musicStreamer.Halt();
     currentScreen = GAME_OVER;
+    return;
+  }
+
+  // Prefetch the next level as the player nears the exit, so reaching it
+  // never waits on a decode
+  int prefetchIndex = currentLevelIndex + 1;
+  if (prefetchIndex < (int)levels.size() &&
+      levels[prefetchIndex].assets.IsUnloaded()) {
+    Rectangle p = worldThread.Latest().player.GetRect();
+    Rectangle exit = currentLvl.exitZone;
+    float dx = (p.x + p.width / 2) - (exit.x + exit.width / 2);
+    float dy = (p.y + p.height / 2) - (exit.y + exit.height / 2);
+    float range = (float)Core::SCREEN_WIDTH * PREFETCH_DISTANCE;
+    if (dx * dx + dy * dy < range * range)
+      QueueLevelAssets(prefetchIndex);
   }
 
   // Check Exit Collision
-  if (CheckCollisionRecs(player.GetRect(), currentLvl.exitZone)) {
+  if (reachedExit) {
     int nextLevel = currentLevelIndex + 1;
     if (nextLevel >= (int)levels.size()) {
       // All levels completed! Show win screen
-      if (isMusicPlaying && currentPlayingMusic != nullptr) {
-        StopMusicStream(*currentPlayingMusic);
-        isMusicPlaying = false;
-        currentPlayingMusic = nullptr;
-      }
-      if (titleMusicLoaded) {
-        PlayMusicStream(titleMusic);
-      }
+      musicStreamer.Halt();
+      currentLvl.assets.Release();
+      QueueTitleAssets(); // Title music starts once streamed in (UpdateWin)
       currentScreen = WIN;
     } else {
       LoadLevel(nextLevel);
@@ -552,10 +813,15 @@ void Game::UpdateGameplay() {
 }
 
 void Game::Draw() {
+  PROFILE_SCOPE("Game::Draw");
   BeginDrawing();
   ClearBackground(BLACK);
+  Render::BeginFrame();
 
   switch (currentScreen) {
+  case LOADING:
+    DrawLoading();
+    break;
   case TITLE:
     DrawTitle();
     break;
@@ -576,26 +842,98 @@ void Game::Draw() {
     break;
   }
 
-  EndDrawing();
+  Render::EndFrame();
+  const Render::FrameStats &drawStats = Render::GetLastFrameStats();
+  Profiler::Counter("Draws", drawStats.draws);
+  Profiler::Counter("Batches", drawStats.batches);
+  if (debugMode) {
+    Render::DrawStatsOverlay(20, Core::SCREEN_HEIGHT - 110);
+    Resources::DrawStatsOverlay(290, Core::SCREEN_HEIGHT - 78);
+    Profiler::DrawOverlay(20, 80);
+  }
+
+  // Capture before the recording indicator so it stays out of the frames
+  frameCapture.CaptureFrame();
+  if (frameCapture.IsRecording()) {
+    char recBuf[64];
+    snprintf(recBuf, sizeof(recBuf), "REC %d (dropped %d)",
+             frameCapture.GetFramesCaptured(),
+             frameCapture.GetFramesDropped());
+    DrawCircle(Core::SCREEN_WIDTH - 200, Core::SCREEN_HEIGHT - 25, 8, RED);
+    DrawText(recBuf, Core::SCREEN_WIDTH - 185, Core::SCREEN_HEIGHT - 33, 16,
+             RED);
+  }
+  if (Profiler::IsTracing()) {
+    char traceBuf[64];
+    snprintf(traceBuf, sizeof(traceBuf), "TRACE %d",
+             Profiler::GetTraceEventCount());
+    DrawCircle(Core::SCREEN_WIDTH - 200, Core::SCREEN_HEIGHT - 50, 8, ORANGE);
+    DrawText(traceBuf, Core::SCREEN_WIDTH - 185, Core::SCREEN_HEIGHT - 58, 16,
+             ORANGE);
+  }
+  if (isRecording || IsPlayingBack()) {
+    char replayBuf[64];
+    if (isRecording)
+      snprintf(replayBuf, sizeof(replayBuf), "REPLAY REC");
+    else
+      snprintf(replayBuf, sizeof(replayBuf), "REPLAY %d/%d",
+               playbackSegment + 1, (int)playback.segments.size());
+    DrawCircle(Core::SCREEN_WIDTH - 200, Core::SCREEN_HEIGHT - 75, 8, SKYBLUE);
+    DrawText(replayBuf, Core::SCREEN_WIDTH - 185, Core::SCREEN_HEIGHT - 83, 16,
+             SKYBLUE);
+  }
+
+  {
+    PROFILE_SCOPE("EndDrawing"); // Buffer swap, and the wait for vsync
+    EndDrawing();
+  }
+}
+
+void Game::DrawLoading() {
+  ClearBackground(BLACK);
+
+  float progress = assetLoader.GetProgress();
+  float barW = Core::SCREEN_WIDTH * 0.5f;
+  float barH = 20.0f;
+  float barX = (Core::SCREEN_WIDTH - barW) / 2.0f;
+  float barY = Core::SCREEN_HEIGHT / 2.0f;
+
+  Render::DrawText("CHARGEMENT...",
+                   Core::SCREEN_WIDTH / 2 -
+                       MeasureText("CHARGEMENT...", 30) / 2,
+                   (int)barY - 50, 30, GOLD);
+  Render::DrawRectangleV({barX, barY}, {barW, barH}, DARKGRAY);
+  Render::DrawRectangleV({barX, barY}, {barW * progress, barH}, GOLD);
+  Render::DrawRectangleLines((int)barX, (int)barY, (int)barW, (int)barH, WHITE);
+
+  char countBuf[32];
+  snprintf(countBuf, sizeof(countBuf), "%d / %d",
+           assetLoader.GetFinishedCount(), assetLoader.GetQueuedCount());
+  Render::DrawText(countBuf,
+                   Core::SCREEN_WIDTH / 2 - MeasureText(countBuf, 20) / 2,
+                   (int)(barY + barH + 15), 20, LIGHTGRAY);
 }
 
 void Game::DrawTitle() {
-  if (introScreenTex.id != 0) {
+  const Texture2D &introScreen = Resources::GetTexture(introScreenTex);
+  if (introScreen.id != 0) {
     // Draw intro screen with story - scaled to fill window
-    Rectangle source = {0, 0, (float)introScreenTex.width,
-                        (float)introScreenTex.height};
+    Rectangle source = {0, 0, (float)introScreen.width,
+                        (float)introScreen.height};
     Rectangle dest = {0, 0, (float)Core::SCREEN_WIDTH,
                       (float)Core::SCREEN_HEIGHT};
-    DrawTexturePro(introScreenTex, source, dest, {0, 0}, 0.0f, WHITE);
+    Render::DrawTexturePro(introScreen, source, dest, {0, 0}, 0.0f, WHITE);
   } else {
     ClearBackground(BLACK);
-    DrawText("REINO DE ARAGON",
-             Core::SCREEN_WIDTH / 2 - MeasureText("REINO DE ARAGON", 40) / 2,
-             Core::SCREEN_HEIGHT / 3, 40, GOLD);
+    Render::DrawText("REINO DE ARAGON",
+                     Core::SCREEN_WIDTH / 2 -
+                         MeasureText("REINO DE ARAGON", 40) / 2,
+                     Core::SCREEN_HEIGHT / 3, 40, GOLD);
   }
-  DrawText("PRESS ENTER TO START",
-           Core::SCREEN_WIDTH / 2 - MeasureText("PRESS ENTER TO START", 20) / 2,
-           Core::SCREEN_HEIGHT - 80, 20, WHITE);
+  Render::DrawText("PRESS ENTER TO START",
+                   Core::SCREEN_WIDTH / 2 -
+                       MeasureText("PRESS ENTER TO START", 20) / 2,
+                   Core::SCREEN_HEIGHT - 80, 20, WHITE);
 }
 
 void Game::DrawStory() {
@@ -625,198 +963,212 @@ void Game::DrawStory() {
   int x = 80;
 
   // Title
-  DrawText("L'HISTOIRE DE PETIT JASMIN",
-           Core::SCREEN_WIDTH / 2 -
-               MeasureText("L'HISTOIRE DE PETIT JASMIN", 32) / 2,
-           25, 32, GOLD);
+  Render::DrawText("L'HISTOIRE DE PETIT JASMIN",
+                   Core::SCREEN_WIDTH / 2 -
+                       MeasureText("L'HISTOIRE DE PETIT JASMIN", 32) / 2,
+                   25, 32, GOLD);
 
   // Draw text
-  DrawText(storyText, x, startY, fontSize, WHITE);
+  Render::DrawText(storyText, x, startY, fontSize, WHITE);
 
   // Draw intro image if available (bottom right)
-  if (introImageTex.id != 0) {
+  const Texture2D &introImage = Resources::GetTexture(introImageTex);
+  if (introImage.id != 0) {
+    // Sized from the full-size art, whichever mip level is loaded
+    Vector2 size = Resources::GetSourceSize(introImageTex);
     float imgScale = 0.6f;
-    float drawW = introImageTex.width * imgScale;
-    float drawH = introImageTex.height * imgScale;
+    float drawW = size.x * imgScale;
+    float drawH = size.y * imgScale;
     float drawX = Core::SCREEN_WIDTH - drawW - 30;
     float drawY = Core::SCREEN_HEIGHT - drawH - 60;
-    Rectangle src = {0, 0, (float)introImageTex.width,
-                     (float)introImageTex.height};
+    Rectangle src = {0, 0, (float)introImage.width,
+                     (float)introImage.height};
     Rectangle dst = {drawX, drawY, drawW, drawH};
-    DrawTexturePro(introImageTex, src, dst, {0, 0}, 0.0f, WHITE);
+    Render::DrawTexturePro(introImage, src, dst, {0, 0}, 0.0f, WHITE);
   }
 
-  DrawText("PRESS ENTER TO PLAY",
-           Core::SCREEN_WIDTH / 2 - MeasureText("PRESS ENTER TO PLAY", 20) / 2,
-           Core::SCREEN_HEIGHT - 40, 20, GOLD);
+  Render::DrawText("PRESS ENTER TO PLAY",
+                   Core::SCREEN_WIDTH / 2 -
+                       MeasureText("PRESS ENTER TO PLAY", 20) / 2,
+                   Core::SCREEN_HEIGHT - 40, 20, GOLD);
 }
 
 void Game::DrawGameOver() {
-  if (gameOverScreenTex.id != 0) {
-    Rectangle source = {0, 0, (float)gameOverScreenTex.width,
-                        (float)gameOverScreenTex.height};
+  const Texture2D &gameOverScreen = Resources::GetTexture(gameOverScreenTex);
+  if (gameOverScreen.id != 0) {
+    Rectangle source = {0, 0, (float)gameOverScreen.width,
+                        (float)gameOverScreen.height};
     Rectangle dest = {0, 0, (float)Core::SCREEN_WIDTH,
                       (float)Core::SCREEN_HEIGHT};
-    DrawTexturePro(gameOverScreenTex, source, dest, {0, 0}, 0.0f, WHITE);
+    Render::DrawTexturePro(gameOverScreen, source, dest, {0, 0}, 0.0f, WHITE);
   } else {
-    DrawRectangle(0, 0, Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT, BLACK);
-    DrawText("GAME OVER",
-             Core::SCREEN_WIDTH / 2 - MeasureText("GAME OVER", 60) / 2,
-             Core::SCREEN_HEIGHT / 3, 60, RED);
+    Render::DrawRectangle(0, 0, Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT, BLACK);
+    Render::DrawText("GAME OVER",
+                     Core::SCREEN_WIDTH / 2 - MeasureText("GAME OVER", 60) / 2,
+                     Core::SCREEN_HEIGHT / 3, 60, RED);
   }
-  DrawText("PRESS 'R' TO RESTART",
-           Core::SCREEN_WIDTH / 2 - MeasureText("PRESS 'R' TO RESTART", 30) / 2,
-           Core::SCREEN_HEIGHT / 2, 30, WHITE);
+  Render::DrawText("PRESS 'R' TO RESTART",
+                   Core::SCREEN_WIDTH / 2 -
+                       MeasureText("PRESS 'R' TO RESTART", 30) / 2,
+                   Core::SCREEN_HEIGHT / 2, 30, WHITE);
 }
 
-// Ray Intersection Helper
-Vector2 GetRayIntersection(Vector2 start, Vector2 end,
-                           const std::vector<Platform> &platforms, bool isDay) {
-  float minT = 1.0f;
-
-  for (const auto &plat : platforms) {
-    if (!plat.IsSolid(isDay))
-      continue;
-
-    if (CheckCollisionLineRect(start, end, plat.rect)) {
-      float t0 = 0.0f;
-      float t1 = minT;
-      for (int i = 0; i < 8; i++) {
-        float mid = t0 + (t1 - t0) * 0.5f;
-        Vector2 midPoint = {start.x + (end.x - start.x) * mid,
-                            start.y + (end.y - start.y) * mid};
-        if (CheckCollisionPointRec(midPoint, plat.rect)) {
-          t1 = mid;
-        } else {
-          if (CheckCollisionLineRect(start, midPoint, plat.rect)) {
-            t1 = mid;
-          } else {
-            t0 = mid;
-          }
-        }
-      }
-      if (t1 < minT)
-        minT = t1;
-    }
+void Game::DrawGradedTexture(Resources::TextureHandle tex, Rectangle source,
+                             Rectangle dest, Color tint, int frame) {
+  const Texture2D &dayTex = Resources::GetTexture(tex);
+  const Texture2D &nightTex = Resources::GetNightTexture(tex);
+  const SpriteMesh *mesh = Resources::GetMesh(tex);
+  auto DrawLayer = [&](Texture2D tex, Color c) {
+    if (mesh != nullptr)
+      mesh->Draw(tex, source, dest, c, frame);
+    else
+      Render::DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, c);
+  };
+
+  // GPU path: the grade shader is active, always draw the day texture
+  if (colorGrade.IsShaderReady() || nightTex.id == 0) {
+    DrawLayer(dayTex, tint);
+    return;
   }
 
-  return {start.x + (end.x - start.x) * minT,
-          start.y + (end.y - start.y) * minT};
+  // CPU fallback: cross-fade the baked night texture over the day one
+  if (nightBlend < 1.0f)
+    DrawLayer(dayTex, tint);
+  if (nightBlend > 0.0f)
+    DrawLayer(nightTex, Fade(tint, nightBlend * tint.a / 255.0f));
 }
 
 void Game::DrawGameplay() {
-  // Draw Background
+  PROFILE_SCOPE("Game::DrawGameplay");
+
+  // Everything the simulation moves comes from its latest snapshot; the
+  // level supplies what stays put (types, textures, sun, exit)
+  const WorldSnapshot &view = worldThread.Latest();
+  bool isDayTime = view.isDayTime;
+  Profiler::Counter("Enemies", (double)view.enemies.size());
+  Profiler::Counter("Platforms", (double)view.platforms.size());
+
+  // World layers (background -> exit zone) are colour graded for the night
+  // look. Entities and UI are drawn ungraded.
+  colorGrade.Begin(nightBlend);
+
   Level &currentLvl = levels[currentLevelIndex];
-  Texture2D bg = isDayTime ? std::get<0>(currentLvl.backgrounds)
-                           : std::get<1>(currentLvl.backgrounds);
-  // Scale background to fill screen
-  Rectangle bgSource = {0, 0, (float)bg.width, (float)bg.height};
-  Rectangle bgDest = {0, 0, (float)Core::SCREEN_WIDTH,
-                      (float)Core::SCREEN_HEIGHT};
-  DrawTexturePro(bg, bgSource, bgDest, {0, 0}, 0.0f, WHITE);
+
+  // Draw Background
+  {
+    PROFILE_SCOPE("Background");
+    const Texture2D &bg = Resources::GetTexture(currentLvl.background);
+    // Scale background to fill screen
+    Rectangle bgSource = {0, 0, (float)bg.width, (float)bg.height};
+    Rectangle bgDest = {0, 0, (float)Core::SCREEN_WIDTH,
+                        (float)Core::SCREEN_HEIGHT};
+    DrawGradedTexture(currentLvl.background, bgSource, bgDest, WHITE);
+  }
 
   // Draw Sun/Moon
   if (isDayTime) {
-    DrawCircleV(currentLvl.sunPosition, 60, YELLOW);
-    DrawCircleV(currentLvl.sunPosition, 70, Fade(GOLD, 0.3f));
+    PROFILE_SCOPE("Sun rays");
+    Render::DrawCircleV(currentLvl.sunPosition, 60, YELLOW);
+    Render::DrawCircleV(currentLvl.sunPosition, 70, Fade(GOLD, 0.3f));
 
     // --- GOD RAYS VISUALS ---
     Vector2 sunPos = currentLvl.sunPosition;
     Color rayColor = Fade(YELLOW, 0.15f);
 
-    int screenW = Core::SCREEN_WIDTH;
-    int screenH = Core::SCREEN_HEIGHT;
-    int step = 40;
-
-    for (int x = 0; x <= screenW; x += step) {
-      Vector2 target = {(float)x, (float)screenH};
-      Vector2 endPoint =
-          GetRayIntersection(sunPos, target, currentLvl.platforms, isDayTime);
-      DrawLineV(sunPos, endPoint, rayColor);
-    }
+    // Ray ends are found by the simulation (World::sunRays)
+    for (const Vector2 &endPoint : view.sunRays)
+      Render::DrawLineV(sunPos, endPoint, rayColor);
   }
 
-  // Draw Platforms
-  for (const auto &plat : currentLvl.platforms) {
-    if (plat.type == PlatformType::INVISIBLE && !debugMode)
-      continue;
-
-    if (plat.type == PlatformType::FLOWER) {
-      // Draw animated flower platform
-      if (flowerAnimSheet.id != 0) {
-        float frameW =
-            (float)flowerAnimSheet.width / (float)flowerAnimFrameCount;
-        float frameH = (float)flowerAnimSheet.height;
-        Rectangle source = {frameW * flowerAnimCurrentFrame, 0, frameW, frameH};
-        float drawHeight = plat.rect.height * 3.0f;
-        Rectangle dest = {plat.rect.x - plat.rect.width * 0.25f,
-                          plat.rect.y - drawHeight + plat.rect.height,
-                          plat.rect.width * 1.5f, drawHeight};
-
-        float alpha = plat.IsSolid(isDayTime) ? 1.0f : 0.3f;
-        DrawTexturePro(flowerAnimSheet, source, dest, {0, 0}, 0.0f,
-                       Fade(WHITE, alpha));
-      } else {
-        Color c = plat.color;
-        if (!plat.IsSolid(isDayTime) && !debugMode)
-          c = Fade(c, 0.3f);
-        DrawRectangleRec(plat.rect, c);
-      }
-    } else if (plat.type == PlatformType::MUSHROOM) {
-      Texture2D mushTex = isDayTime ? mushroomDayTex : mushroomNightTex;
-      if (mushTex.id != 0) {
-        Rectangle source = {0, 0, (float)mushTex.width, (float)mushTex.height};
-        Rectangle dest = {plat.rect.x, plat.rect.y, plat.rect.width,
-                          plat.rect.height};
-        float alpha = plat.IsSolid(isDayTime) ? 1.0f : 0.3f;
-        DrawTexturePro(mushTex, source, dest, {0, 0}, 0.0f, Fade(WHITE, alpha));
-      } else {
-        Color c = plat.color;
-        if (!plat.IsSolid(isDayTime) && !debugMode)
-          c = Fade(c, 0.3f);
-        DrawRectangleRec(plat.rect, c);
-      }
-    } else if (plat.type == PlatformType::NORMAL) {
-      // Use cropped platform textures (434x457 after auto-crop)
-      Texture2D platTex = isDayTime ? platformDayTex : platformNightTex;
-      if (platTex.id != 0 && plat.rect.width > 0 && plat.rect.height > 0) {
-        Rectangle source = {0, 0, (float)platTex.width, (float)platTex.height};
-        Rectangle dest = {plat.rect.x, plat.rect.y, plat.rect.width,
-                          plat.rect.height};
-        DrawTexturePro(platTex, source, dest, {0, 0}, 0.0f, WHITE);
+  // Draw Platforms (as the snapshot has them: flowers move on the
+  // simulation thread)
+  {
+    PROFILE_SCOPE("Platforms");
+    for (const WorldSnapshot::PlatformView &p : view.platforms) {
+      Platform plat(p.rect, p.type, p.color);
+      if (plat.type == PlatformType::INVISIBLE && !debugMode)
+        continue;
+
+      if (plat.type == PlatformType::FLOWER) {
+        // Draw animated flower platform
+        const Texture2D &flowerSheet = Resources::GetTexture(flowerAnimSheet);
+        if (flowerSheet.id != 0) {
+          float frameW = (float)flowerSheet.width / (float)flowerAnimFrameCount;
+          float frameH = (float)flowerSheet.height;
+          Rectangle source = {frameW * flowerAnimCurrentFrame, 0, frameW,
+                              frameH};
+          float drawHeight = plat.rect.height * 3.0f;
+          Rectangle dest = {plat.rect.x - plat.rect.width * 0.25f,
+                            plat.rect.y - drawHeight + plat.rect.height,
+                            plat.rect.width * 1.5f, drawHeight};
+
+          float alpha = plat.IsSolid(isDayTime) ? 1.0f : 0.3f;
+          DrawGradedTexture(flowerAnimSheet, source, dest, Fade(WHITE, alpha),
+                            flowerAnimCurrentFrame);
+        } else {
+          Color c = plat.color;
+          if (!plat.IsSolid(isDayTime) && !debugMode)
+            c = Fade(c, 0.3f);
+          Render::DrawRectangleRec(plat.rect, c);
+        }
+      } else if (plat.type == PlatformType::MUSHROOM) {
+        const Texture2D &mushroomSprite = Resources::GetTexture(mushroomTex);
+        if (mushroomSprite.id != 0) {
+          Rectangle source = {0, 0, (float)mushroomSprite.width,
+                              (float)mushroomSprite.height};
+          Rectangle dest = {plat.rect.x, plat.rect.y, plat.rect.width,
+                            plat.rect.height};
+          float alpha = plat.IsSolid(isDayTime) ? 1.0f : 0.3f;
+          DrawGradedTexture(mushroomTex, source, dest, Fade(WHITE, alpha));
+        } else {
+          Color c = plat.color;
+          if (!plat.IsSolid(isDayTime) && !debugMode)
+            c = Fade(c, 0.3f);
+          Render::DrawRectangleRec(plat.rect, c);
+        }
+      } else if (plat.type == PlatformType::NORMAL) {
+        // Use cropped platform textures (434x457 after auto-crop)
+        const Texture2D &platform = Resources::GetTexture(platformTex);
+        if (platform.id != 0 && plat.rect.width > 0 && plat.rect.height > 0) {
+          Rectangle source = {0, 0, (float)platform.width,
+                              (float)platform.height};
+          Rectangle dest = {plat.rect.x, plat.rect.y, plat.rect.width,
+                            plat.rect.height};
+          DrawGradedTexture(platformTex, source, dest, WHITE);
+        } else {
+          // The grade shader already darkens the day colour at night
+          bool useDayColor = isDayTime || colorGrade.IsShaderReady();
+          Color platColor =
+              useDayColor ? Color{101, 67, 33, 255} : Color{50, 35, 20, 255};
+          Render::DrawRectangleRec(plat.rect, platColor);
+        }
       } else {
-        Color platColor =
-            isDayTime ? Color{101, 67, 33, 255} : Color{50, 35, 20, 255};
-        DrawRectangleRec(plat.rect, platColor);
-      }
-    } else {
-      // Invisible or other
-      if (debugMode) {
-        Color c = Fade(LIME, 0.3f);
-        DrawRectangleRec(plat.rect, c);
+        // Invisible or other
+        if (debugMode) {
+          Color c = Fade(LIME, 0.3f);
+          Render::DrawRectangleRec(plat.rect, c);
+        }
       }
     }
-
-    if (debugMode) {
-      DrawRectangleLinesEx(plat.rect, 2, RED);
-    }
   }
 
   // Draw Foreground Layer (BEFORE entities so player is visible on top)
   if (currentLvl.hasForeground) {
-    Texture2D fg =
-        isDayTime ? currentLvl.foregroundDay : currentLvl.foregroundNight;
+    PROFILE_SCOPE("Foreground");
+    const Texture2D &fg = Resources::GetTexture(currentLvl.foreground);
     if (fg.id != 0) {
       Rectangle fgSource = {0, 0, (float)fg.width, (float)fg.height};
       Rectangle fgDest = {0, 0, (float)Core::SCREEN_WIDTH,
                           (float)Core::SCREEN_HEIGHT};
-      DrawTexturePro(fg, fgSource, fgDest, {0, 0}, 0.0f, Fade(WHITE, 0.5f));
+      DrawGradedTexture(currentLvl.foreground, fgSource, fgDest,
+                        Fade(WHITE, 0.5f));
     }
   }
 
   // Draw Exit Zone with watering can image
   {
-    Texture2D wpTex = isDayTime ? waterPotDayTex : waterPotNightTex;
+    PROFILE_SCOPE("Exit zone");
+    const Texture2D &wpTex = Resources::GetTexture(waterPotTex);
     if (wpTex.id != 0) {
       Rectangle source = {0, 0, (float)wpTex.width, (float)wpTex.height};
       // Draw proportionally - images are now cropped (700x643)
@@ -827,51 +1179,70 @@ void Game::DrawGameplay() {
                     drawW / 2.0f;
       float drawY = currentLvl.exitZone.y + currentLvl.exitZone.height - drawH;
       Rectangle dest = {drawX, drawY, drawW, drawH};
-      DrawTexturePro(wpTex, source, dest, {0, 0}, 0.0f, WHITE);
+      DrawGradedTexture(waterPotTex, source, dest, WHITE);
     } else {
-      DrawRectangleRec(currentLvl.exitZone, GOLD);
-      DrawText("EXIT", (int)currentLvl.exitZone.x + 10,
-               (int)currentLvl.exitZone.y + 10, 20, WHITE);
+      Render::DrawRectangleRec(currentLvl.exitZone, GOLD);
+      Render::DrawText("EXIT", (int)currentLvl.exitZone.x + 10,
+                       (int)currentLvl.exitZone.y + 10, 20, WHITE);
     }
   }
 
+  colorGrade.End();
+
+  // Platform hitboxes (drawn ungraded so they stay readable)
+  if (debugMode) {
+    for (const WorldSnapshot::PlatformView &p : view.platforms)
+      Render::DrawRectangleLinesEx(p.rect, 2, RED);
+  }
+
   // Draw Entities (ON TOP of foreground so player is visible)
-  player.Draw();
-  if (debugMode)
-    DrawRectangleLinesEx(player.GetRect(), 2, GREEN);
-
-  // Draw enemies (only at night)
-  if (!isDayTime) {
-    for (auto *enemy : currentEnemies) {
-      enemy->Draw();
-      if (debugMode)
-        DrawRectangleLinesEx(enemy->GetRect(), 2, RED);
+  Player player = view.player;
+  {
+    PROFILE_SCOPE("Entities");
+    player.Draw();
+    if (debugMode)
+      Render::DrawRectangleLinesEx(player.GetRect(), 2, GREEN);
+
+    // Draw enemies (only at night)
+    if (!isDayTime) {
+      for (const auto &e : view.enemies) {
+        Enemy &enemy = e.type == EnemyType::SPIDER ? (Enemy &)spiderView
+                                                   : (Enemy &)roachView;
+        enemy.position = e.position;
+        enemy.width = e.width;
+        enemy.height = e.height;
+        enemy.movingRight = e.movingRight;
+        enemy.currentFrame = e.currentFrame;
+        enemy.Draw();
+        if (debugMode)
+          Render::DrawRectangleLinesEx(enemy.GetRect(), 2, RED);
+      }
     }
   }
 
   // UI
-  DrawText(isDayTime ? "DAY" : "NIGHT", 20, 20, 20, isDayTime ? BLACK : WHITE);
+  PROFILE_SCOPE("UI");
+  Render::DrawText(isDayTime ? "DAY" : "NIGHT", 20, 20, 20,
+                   isDayTime ? BLACK : WHITE);
   char levelBuf[32];
   snprintf(levelBuf, sizeof(levelBuf), "LEVEL %d", currentLevelIndex + 1);
-  DrawText(levelBuf, 100, 20, 20, RED);
+  Render::DrawText(levelBuf, 100, 20, 20, RED);
 
   if (debugMode)
-    DrawText("DEBUG MODE ON", 20, 50, 20, RED);
+    Render::DrawText("DEBUG MODE ON", 20, 50, 20, RED);
 
-  // Sun hint popup
-  if (sunHintTimer > 0.0f) {
-    sunHintTimer -= GetFrameTime();
-    float alpha =
-        sunHintTimer > 1.0f ? 1.0f : sunHintTimer; // Fade out last second
+  // Sun hint popup (see SunHintScript)
+  if (sunHintAlpha > 0.0f) {
+    float alpha = sunHintAlpha;
     const char *hint = "Appuie sur T pour passer en mode Nuit !";
     int hintFontSize = 24;
     int textW = MeasureText(hint, hintFontSize);
     int hintX = Core::SCREEN_WIDTH / 2 - textW / 2;
     int hintY = Core::SCREEN_HEIGHT / 2 - 50;
     // Dark background box
-    DrawRectangle(hintX - 15, hintY - 10, textW + 30, 44,
-                  Fade(BLACK, 0.7f * alpha));
-    DrawText(hint, hintX, hintY, hintFontSize, Fade(YELLOW, alpha));
+    Render::DrawRectangle(hintX - 15, hintY - 10, textW + 30, 44,
+                          Fade(BLACK, 0.7f * alpha));
+    Render::DrawText(hint, hintX, hintY, hintFontSize, Fade(YELLOW, alpha));
   }
 
   // HEALTHBAR
@@ -880,77 +1251,59 @@ void Game::DrawGameplay() {
   float barHeight = 20.0f;
   Vector2 barPos = {(float)Core::SCREEN_WIDTH - barWidth - 20, 20};
 
-  DrawRectangleV(barPos, {barWidth, barHeight}, DARKGRAY);
-  DrawRectangleV(barPos, {barWidth * hpPct, barHeight}, RED);
-  DrawRectangleLines(barPos.x, barPos.y, barWidth, barHeight, WHITE);
-  DrawText("HP", barPos.x - 30, barPos.y, 20, RED);
+  Render::DrawRectangleV(barPos, {barWidth, barHeight}, DARKGRAY);
+  Render::DrawRectangleV(barPos, {barWidth * hpPct, barHeight}, RED);
+  Render::DrawRectangleLines(barPos.x, barPos.y, barWidth, barHeight, WHITE);
+  Render::DrawText("HP", barPos.x - 30, barPos.y, 20, RED);
 
   if (isDayTime) {
-    DrawText("SUN HURTS!", barPos.x, barPos.y + 30, 20, ORANGE);
+    Render::DrawText("SUN HURTS!", barPos.x, barPos.y + 30, 20, ORANGE);
   }
 }
 
 void Game::Unload() {
-  if (isUnloaded)
-    return;
-  isUnloaded = true;
-
-  UnloadCurrentLevelEntities();
-
-  // Unload all textures
-  UnloadTexture(playerIdleTex);
-  UnloadTexture(playerWalkSheet);
-  UnloadTexture(playerDeathTex);
-  UnloadTexture(roachTex);
-  UnloadTexture(spiderSheet);
-  UnloadTexture(introScreenTex);
-  UnloadTexture(introImageTex);
-  UnloadTexture(gameOverScreenTex);
-  UnloadTexture(waterPotDayTex);
-  UnloadTexture(waterPotNightTex);
-  UnloadTexture(flowerTex);
-  UnloadTexture(flowerAnimSheet);
-  UnloadTexture(mushroomDayTex);
-  UnloadTexture(mushroomNightTex);
-  UnloadTexture(platformDayTex);
-  UnloadTexture(platformNightTex);
-
-  // Unload sounds
-  UnloadSound(jumpSound);
-  UnloadSound(walkSound);
-  UnloadSound(burnSound);
-  UnloadSound(deathSound);
-  UnloadSound(wateringCanSound);
-
-  // Unload title music
-  if (titleMusicLoaded) {
-    UnloadMusicStream(titleMusic);
-  }
+  // Safe to call twice (main, then the destructor): every step below is a
+  // no-op once done
+  frameCapture.Stop(); // Needs the GL context for the last readbacks
+  assetLoader.Stop();   // Workers may still be writing into our fields
+  Profiler::StopTrace();
+  StopRecording();
+  scripts.Clear();    // Tasks refer to the levels and assets below
+  worldThread.Stop(); // Steps use the jobs and the levels
+  jobs.Stop();
+  musicStreamer.Stop(); // Before the streams are unloaded below
+  sfx.Stop();           // Its voices alias the cached sounds
+
+  world.Clear();
+
+  // Groups drop their cache references and close their music streams
+  titleAssets.Release();
+  globalAssets.Release();
 
   // Levels unload their own resources
   for (auto &lvl : levels) {
     lvl.Unload();
   }
   levels.clear();
+
+  // Frees whatever is left cached (unused entries kept for reuse)
+  Resources::Shutdown();
+
+  // Last: music streams and cached assets may point into the mapping
+  AssetFiles::Mount(nullptr);
+  assetPack.Close();
+
+  colorGrade.Unload();
 }
 
 // --- Settings Menu ---
 
 void Game::ApplyVolume() {
   SetMasterVolume(masterVolume);
-  // Apply music volume to currently playing music
-  if (isMusicPlaying && currentPlayingMusic != nullptr) {
-    SetMusicVolume(*currentPlayingMusic, musicVolume);
-  }
-  if (titleMusicLoaded && IsMusicStreamPlaying(titleMusic)) {
-    SetMusicVolume(titleMusic, musicVolume);
-  }
-  // SFX volume applied per-sound when played
-  SetSoundVolume(jumpSound, sfxVolume);
-  SetSoundVolume(walkSound, sfxVolume);
-  SetSoundVolume(burnSound, sfxVolume);
-  SetSoundVolume(deathSound, sfxVolume);
-  SetSoundVolume(wateringCanSound, sfxVolume);
+  // Music volume applies to whatever the streamer plays, now and later
+  musicStreamer.SetVolume(musicVolume);
+  // SFX volume scales every mixer bus (playing voices included)
+  sfx.SetSfxVolume(sfxVolume);
 }
 
 void Game::ApplyResolution() {
@@ -961,19 +1314,15 @@ void Game::ApplyResolution() {
   Core::RecalculatePhysics();
   SetWindowSize(newW, newH);
 
-  // Rebuild level geometry for new resolution
-  RebuildLevelGeometry();
+  // Resident textures move to the mip level of the new size in the background
+  Resources::SetRenderSize(newW, newH);
 
-  // Resize player
-  player.width = (float)Core::SCREEN_HEIGHT * 0.12f;
-  player.height = (float)Core::SCREEN_HEIGHT * 0.12f;
-
-  // Reload current level if in gameplay
-  LoadLevel(currentLevelIndex);
+  // Reload current level if in gameplay (levels are laid out for the
+  // screen size as they load, and the player sized with them)
+  if (previousScreen == GAMEPLAY)
+    LoadLevel(currentLevelIndex);
 }
 
-// RebuildLevelGeometry moved to after Init()
-
 void Game::UpdateSettings() {
   // Navigate with UP/DOWN
   if (IsKeyPressed(KEY_UP)) {
@@ -1055,8 +1404,8 @@ void Game::DrawSettings() {
   // Draw a semi-transparent overlay if coming from gameplay
   if (previousScreen == GAMEPLAY) {
     DrawGameplay();
-    DrawRectangle(0, 0, Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT,
-                  Fade(BLACK, 0.75f));
+    Render::DrawRectangle(0, 0, Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT,
+                          Fade(BLACK, 0.75f));
   } else {
     ClearBackground(Color{20, 20, 30, 255});
   }
@@ -1067,8 +1416,8 @@ void Game::DrawSettings() {
   int fontSize = 24;
 
   // Title
-  DrawText("SETTINGS", centerX - MeasureText("SETTINGS", 36) / 2, startY - 60,
-           36, GOLD);
+  Render::DrawText("SETTINGS", centerX - MeasureText("SETTINGS", 36) / 2,
+                   startY - 60, 36, GOLD);
 
   // Menu items
   const char *labels[] = {"Resolution", "Music Volume", "SFX Volume",
@@ -1080,10 +1429,10 @@ void Game::DrawSettings() {
 
     // Highlight arrow
     if (i == settingsSelection) {
-      DrawText(">", centerX - 200, y, fontSize, GOLD);
+      Render::DrawText(">", centerX - 200, y, fontSize, GOLD);
     }
 
-    DrawText(labels[i], centerX - 170, y, fontSize, textColor);
+    Render::DrawText(labels[i], centerX - 170, y, fontSize, textColor);
 
     // Values
     if (i == 0) {
@@ -1091,9 +1440,10 @@ void Game::DrawSettings() {
       const char *resLabel = resOptions[selectedResIndex].label;
       char buf[64];
       snprintf(buf, sizeof(buf), "< %s >", resLabel);
-      DrawText(buf, centerX + 80, y, fontSize, textColor);
+      Render::DrawText(buf, centerX + 80, y, fontSize, textColor);
       if (i == settingsSelection) {
-        DrawText("(Press ENTER to apply)", centerX + 80, y + 25, 14, DARKGRAY);
+        Render::DrawText("(Press ENTER to apply)", centerX + 80, y + 25, 14,
+                         DARKGRAY);
       }
     } else if (i == 1) {
       // Music Volume bar
@@ -1101,32 +1451,32 @@ void Game::DrawSettings() {
       float barH = 20;
       float barX = centerX + 80;
       float barY = y + 3;
-      DrawRectangle(barX, barY, barW, barH, DARKGRAY);
-      DrawRectangle(barX, barY, barW * musicVolume, barH, GREEN);
-      DrawRectangleLines(barX, barY, barW, barH, WHITE);
+      Render::DrawRectangle(barX, barY, barW, barH, DARKGRAY);
+      Render::DrawRectangle(barX, barY, barW * musicVolume, barH, GREEN);
+      Render::DrawRectangleLines(barX, barY, barW, barH, WHITE);
       char vol[16];
       snprintf(vol, sizeof(vol), "%d%%", (int)(musicVolume * 100));
-      DrawText(vol, barX + barW + 10, y, fontSize, textColor);
+      Render::DrawText(vol, barX + barW + 10, y, fontSize, textColor);
     } else if (i == 2) {
       // SFX Volume bar
       float barW = 150;
       float barH = 20;
       float barX = centerX + 80;
       float barY = y + 3;
-      DrawRectangle(barX, barY, barW, barH, DARKGRAY);
-      DrawRectangle(barX, barY, barW * sfxVolume, barH, BLUE);
-      DrawRectangleLines(barX, barY, barW, barH, WHITE);
+      Render::DrawRectangle(barX, barY, barW, barH, DARKGRAY);
+      Render::DrawRectangle(barX, barY, barW * sfxVolume, barH, BLUE);
+      Render::DrawRectangleLines(barX, barY, barW, barH, WHITE);
       char vol[16];
       snprintf(vol, sizeof(vol), "%d%%", (int)(sfxVolume * 100));
-      DrawText(vol, barX + barW + 10, y, fontSize, textColor);
+      Render::DrawText(vol, barX + barW + 10, y, fontSize, textColor);
     } else if (i == 3) {
       // Fullscreen toggle
-      DrawText(isFullscreen ? "ON" : "OFF", centerX + 80, y, fontSize,
-               isFullscreen ? GREEN : RED);
+      Render::DrawText(isFullscreen ? "ON" : "OFF", centerX + 80, y, fontSize,
+                       isFullscreen ? GREEN : RED);
     }
   }
 
-  DrawText(
+  Render::DrawText(
       "UP/DOWN: Navigate  |  LEFT/RIGHT: Adjust  |  ESC: Back",
       centerX -
           MeasureText("UP/DOWN: Navigate  |  LEFT/RIGHT: Adjust  |  ESC: Back",
@@ -1138,6 +1488,9 @@ void Game::DrawSettings() {
 // --- Win Screen ---
 
 void Game::UpdateWin() {
+  if (titleMusicLoaded && !musicStreamer.IsPlaying()) {
+    musicStreamer.Play(titleMusic);
+  }
   if (IsKeyPressed(KEY_ENTER)) {
     currentScreen = TITLE;
   }
@@ -1148,31 +1501,36 @@ void Game::DrawWin() {
 
   int centerX = Core::SCREEN_WIDTH / 2;
 
-  DrawText("FELICITATIONS !", centerX - MeasureText("FELICITATIONS !", 48) / 2,
-           Core::SCREEN_HEIGHT / 4, 48, GOLD);
+  Render::DrawText("FELICITATIONS !",
+                   centerX - MeasureText("FELICITATIONS !", 48) / 2,
+                   Core::SCREEN_HEIGHT / 4, 48, GOLD);
 
-  DrawText("Petit Jasmin a trouve de l'eau !",
-           centerX - MeasureText("Petit Jasmin a trouve de l'eau !", 24) / 2,
-           Core::SCREEN_HEIGHT / 4 + 80, 24, WHITE);
+  Render::DrawText(
+      "Petit Jasmin a trouve de l'eau !",
+      centerX - MeasureText("Petit Jasmin a trouve de l'eau !", 24) / 2,
+      Core::SCREEN_HEIGHT / 4 + 80, 24, WHITE);
 
-  DrawText("Merci d'avoir joue a Reino de Aragon",
-           centerX -
-               MeasureText("Merci d'avoir joue a Reino de Aragon", 20) / 2,
-           Core::SCREEN_HEIGHT / 2, 20, LIGHTGRAY);
+  Render::DrawText(
+      "Merci d'avoir joue a Reino de Aragon",
+      centerX - MeasureText("Merci d'avoir joue a Reino de Aragon", 20) / 2,
+      Core::SCREEN_HEIGHT / 2, 20, LIGHTGRAY);
 
   // Draw intro image if available
-  if (introImageTex.id != 0) {
+  const Texture2D &introImage = Resources::GetTexture(introImageTex);
+  if (introImage.id != 0) {
+    Vector2 size = Resources::GetSourceSize(introImageTex);
     float scale = 0.5f;
-    float drawW = introImageTex.width * scale;
-    float drawH = introImageTex.height * scale;
-    Rectangle src = {0, 0, (float)introImageTex.width,
-                     (float)introImageTex.height};
+    float drawW = size.x * scale;
+    float drawH = size.y * scale;
+    Rectangle src = {0, 0, (float)introImage.width,
+                     (float)introImage.height};
     Rectangle dst = {centerX - drawW / 2, (float)Core::SCREEN_HEIGHT / 2 + 40,
                      drawW, drawH};
-    DrawTexturePro(introImageTex, src, dst, {0, 0}, 0.0f, WHITE);
+    Render::DrawTexturePro(introImage, src, dst, {0, 0}, 0.0f, WHITE);
   }
 
-  DrawText("PRESS ENTER TO RETURN TO MENU",
-           centerX - MeasureText("PRESS ENTER TO RETURN TO MENU", 20) / 2,
-           Core::SCREEN_HEIGHT - 60, 20, GOLD);
+  Render::DrawText(
+      "PRESS ENTER TO RETURN TO MENU",
+      centerX - MeasureText("PRESS ENTER TO RETURN TO MENU", 20) / 2,
+      Core::SCREEN_HEIGHT - 60, 20, GOLD);
 }
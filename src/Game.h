@@ -1,8 +1,23 @@
 #pragma once
-#include "entities/Enemy.h"
-#include "entities/Player.h"
+#include "core/AssetGroup.h"
+#include "core/AssetLoader.h"
+#include "core/ColorGrade.h"
+#include "core/FrameCapture.h"
+#include "core/JobSystem.h"
+#include "core/MusicStreamer.h"
+#include "core/PackFile.h"
+#include "core/Profiler.h"
+#include "core/Resources.h"
+#include "core/Scheduler.h"
+#include "core/SfxMixer.h"
+#include "entities/Roach.h"
+#include "entities/Spider.h"
 #include "raylib.h"
 #include "world/Level.h"
+#include "world/Replay.h"
+#include "world/World.h"
+#include "world/WorldThread.h"
+#include <string>
 #include <vector>
 
 class Game {
@@ -15,33 +30,63 @@ public:
   void Draw();
   void Unload();
 
+  // Play a replay file back (see Replay) once loading is done, then quit
+  bool PlayReplay(const char *path);
+  bool ShouldQuit() const { return quitRequested; }
+
 private:
   // Game State
-  bool isDayTime;
+  bool isDayTime;     // As last reported by the simulation
+  float nightBlend;   // 0 = day look, 1 = night look (eased towards isDayTime)
   bool debugMode;     // Toggle with H
-  bool isUnloaded;    // Prevent double-free
-  bool sunHintShown;  // Has the sun hint been shown?
-  float sunHintTimer; // Timer for showing hint text
-
-  Player player;
+  float sunHintAlpha; // Sun hint text opacity (0 = hidden)
+
+  // --- Scripts ---
+  // Timed behaviour as coroutines, advanced with gameplay (UpdateGameplay).
+  // Gameplay signals are declared before the scheduler so they outlive
+  // the tasks waiting on them.
+  Scheduler::Signal sunBurn; // The sun hurt the player
+  Scheduler scripts;
+  Scheduler::Task SunHintScript();    // Hint once, on the first burn
+  Scheduler::Task FlowerAnimScript(); // Flower platform frames
+  Scheduler::Task LevelWatchScript(); // Hot reload polling
+
+  // Simulation: the player, enemies and moving platforms step at a fixed
+  // rate on their own thread; this thread only draws its snapshots. The
+  // world is touched directly only while the thread is paused (outside
+  // gameplay, and around level loads).
+  World world;
+  WorldThread worldThread;
+
+  // Draw the snapshot's enemies through these (sprites set once)
+  Roach roachView{{0, 0}};
+  Spider spiderView{{0, 0}};
 
   // Level Management
   std::vector<Level> levels;
   int currentLevelIndex;
 
-  // Current Level Entities (pointers managed by Game)
-  std::vector<Enemy *> currentEnemies;
-
   void LoadLevel(int index);
-  void UnloadCurrentLevelEntities();
-  void RebuildLevelGeometry(); // Rebuild platform/spawn/exit positions for
-                               // current resolution
+
+  // Level hot reload: the current level's files are polled while playing
+  // and reloaded in place when they change (desktop only)
+  static constexpr float LEVEL_WATCH_INTERVAL = 0.5f;
+  void HotReloadLevel();
 
   // Screen Management
-  enum GameScreen { TITLE, STORY, GAMEPLAY, SETTINGS, WIN, GAME_OVER };
+  enum GameScreen {
+    LOADING,
+    TITLE,
+    STORY,
+    GAMEPLAY,
+    SETTINGS,
+    WIN,
+    GAME_OVER
+  };
   GameScreen currentScreen;
   GameScreen previousScreen; // To return from SETTINGS
 
+  void UpdateLoading();
   void UpdateTitle();
   void UpdateStory();
   void UpdateGameplay();
@@ -49,6 +94,7 @@ private:
   void UpdateSettings();
   void UpdateWin();
 
+  void DrawLoading();
   void DrawTitle();
   void DrawStory();
   void DrawGameplay();
@@ -83,49 +129,122 @@ private:
   void ApplyVolume();
   void ApplyResolution();
 
-  // --- Loaded Textures (owned by Game, assigned to entities) ---
+  // --- Simulation Jobs ---
+  // Per-step work of the world split across cores (results combined in
+  // index order, so steps do not depend on the worker count)
+  JobSystem jobs;
+
+  // --- Frame Capture (F9) ---
+  FrameCapture frameCapture;
+
+  // --- Profiling (overlay: H, trace: F10) ---
+  // Frames over this write the seconds around them to hitches/ (see
+  // Profiler's flight recorder), described by DescribeForHitch
+  static constexpr float HITCH_BUDGET_MS = 50.0f;
+  void DescribeForHitch(Profiler::HitchNotes &notes);
+
+  // --- Replays (record: F8, play back: --replay <file>) ---
+  // Recording keeps every step's input and the world's checksum after it,
+  // on the simulation thread; each level (re)start begins a segment.
+  // Playback drives the simulation from the file instead of the keyboard,
+  // segment by segment, then logs the frame-time percentiles and quits.
+  Replay recording;
+  bool isRecording;
+  void StartRecording(); // Restarts the level being played
+  void StopRecording();  // Writes replays/replay_YYYYMMDD_HHMMSS.rrpl
+
+  Replay playback;
+  ReplayCursor playbackCursor;
+  std::string playbackPath; // Empty: not playing back
+  int playbackSegment;      // Being played, -1 before the first
+  int playbackMismatches;   // Steps that differed, finished segments
+  std::vector<float> playbackFrameMs;
+  bool quitRequested;
+  bool IsPlayingBack() const { return !playbackPath.empty(); }
+  void StartPlaybackSegment(int index);
+  void UpdatePlayback(); // Gameplay frames while playing back
+  void FinishPlayback();
+
+  // --- Day/Night Grading ---
+  // Night textures are derived from the day ones (see ColorGrade); the cache
+  // only bakes night variants on the CPU fallback path.
+  ColorGrade colorGrade;
+  void DrawGradedTexture(Resources::TextureHandle tex, Rectangle source,
+                         Rectangle dest, Color tint, int frame = 0);
+
+  // --- Asset Loading ---
+  AssetLoader assetLoader;
+  static constexpr double LOAD_BUDGET_SECONDS = 0.008; // Uploads per frame
+  static constexpr double BACKGROUND_LOAD_BUDGET_SECONDS = 0.002; // In game
+  static constexpr float PREFETCH_DISTANCE = 0.35f; // x SCREEN_WIDTH to exit
+
+  // Asset lifetimes: global assets stay for the whole session, title assets
+  // while a menu screen needs them, level assets (Level::assets) while the
+  // level is played or about to be
+  PackFile assetPack; // Mounted for every loader while open
+  static constexpr const char *ASSET_PACK_PATH = "assets.pak";
+
+  AssetGroup globalAssets{"global"};
+  AssetGroup titleAssets{"title"};
+  void QueueGlobalAssets();
+  void QueueTitleAssets();
+  void QueueLevelAssets(int index); // Prefetch: no-op if loading/resident
+  void EnsureLevelResident(int index); // Blocks if the prefetch missed
+
+  // Queue an image or sound through the resource cache (a hit costs no
+  // load). The group holds one reference, dropped when it is released.
+  void QueueSprite(AssetGroup &group, const char *path,
+                   Resources::TextureHandle *out,
+                   const Resources::TextureOptions &options =
+                       Resources::TextureOptions());
+  void QueueSound(AssetGroup &group, const char *path,
+                  Resources::SoundHandle *out);
+  void QueueMusic(AssetGroup &group, const char *path, Music *out,
+                  bool *loaded);
+  void FinishLoading(); // Hook global assets up once they are in
+
+  // --- Loaded Assets (cache handles, shared freely with entities) ---
+  // Meshes and baked night variants live in the cache with each texture
   // Player textures
-  Texture2D playerIdleTex;
-  Texture2D playerWalkSheet;
-  Texture2D playerDeathTex;
+  Resources::TextureHandle playerIdleTex;
+  Resources::TextureHandle playerWalkSheet;
+  Resources::TextureHandle playerDeathTex;
 
   // Enemy textures
-  Texture2D roachTex;
-  Texture2D spiderSheet;
+  Resources::TextureHandle roachTex;
+  Resources::TextureHandle spiderSheet;
 
   // UI/Screen textures
-  Texture2D introScreenTex;
-  Texture2D introImageTex;
-  Texture2D gameOverScreenTex;
+  Resources::TextureHandle introScreenTex;
+  Resources::TextureHandle introImageTex;
+  Resources::TextureHandle gameOverScreenTex;
 
-  // Exit zone (watering can) textures
-  Texture2D waterPotDayTex;
-  Texture2D waterPotNightTex;
+  // Exit zone (watering can) texture
+  Resources::TextureHandle waterPotTex;
 
   // Platform textures
-  Texture2D flowerTex;
-  Texture2D flowerAnimSheet;
+  Resources::TextureHandle flowerTex;
+  Resources::TextureHandle flowerAnimSheet;
   int flowerAnimFrameCount;
   int flowerAnimCurrentFrame;
-  float flowerAnimTimer;
   float flowerAnimSpeed;
 
-  Texture2D mushroomDayTex;
-  Texture2D mushroomNightTex;
-
-  Texture2D platformDayTex;
-  Texture2D platformNightTex;
+  Resources::TextureHandle mushroomTex;
+  Resources::TextureHandle platformTex;
 
   // Audio
-  Sound jumpSound;
-  Sound walkSound;
-  Sound burnSound;
-  Sound deathSound;
-  Sound wateringCanSound;
+  Resources::SoundHandle jumpSound;
+  Resources::SoundHandle walkSound;
+  Resources::SoundHandle burnSound;
+  Resources::SoundHandle deathSound;
+  Resources::SoundHandle wateringCanSound;
+  SfxMixer sfx; // Voice pool the gameplay sounds are played through
+  SfxMixer::SfxId jumpSfx;
+  SfxMixer::SfxId burnSfx;
+  SfxMixer::SfxId deathSfx;
   Music titleMusic;
   bool titleMusicLoaded;
 
-  // Currently playing music tracking
-  Music *currentPlayingMusic;
-  bool isMusicPlaying;
+  // Plays title or level music on its own thread (level pairs crossfade)
+  MusicStreamer musicStreamer;
 };
@@ -0,0 +1,64 @@
+#include "AssetGroup.h"
+#include "raylib.h"
+
+AssetGroup::AssetGroup(const char *name) : name(name) {
+  state = State::UNLOADED;
+  pendingJobs = 0;
+  queueing = false;
+  releaseRequested = false;
+}
+
+bool AssetGroup::BeginLoad() {
+  releaseRequested = false;
+  if (state != State::UNLOADED)
+    return false;
+
+  state = State::LOADING;
+  queueing = true;
+  return true;
+}
+
+void AssetGroup::EndQueue() {
+  queueing = false;
+  CheckFinished();
+}
+
+void AssetGroup::AddJob() { pendingJobs++; }
+
+void AssetGroup::JobDone() {
+  pendingJobs--;
+  CheckFinished();
+}
+
+void AssetGroup::OnRelease(std::function<void()> release) {
+  releasers.push_back(std::move(release));
+}
+
+void AssetGroup::CheckFinished() {
+  if (state != State::LOADING || queueing || pendingJobs > 0)
+    return;
+
+  state = State::RESIDENT;
+  TraceLog(LOG_INFO, "ASSETS: Group '%s' resident", name.c_str());
+
+  // Released while its jobs were still in flight
+  if (releaseRequested)
+    Release();
+}
+
+void AssetGroup::Release() {
+  if (state == State::UNLOADED)
+    return;
+  if (state == State::LOADING) {
+    releaseRequested = true;
+    return;
+  }
+
+  // Unload in reverse load order
+  for (auto it = releasers.rbegin(); it != releasers.rend(); ++it)
+    (*it)();
+  releasers.clear();
+  releaseRequested = false;
+  state = State::UNLOADED;
+  TraceLog(LOG_INFO, "ASSETS: Group '%s' released", name.c_str());
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+// A set of assets that are loaded and released together (a screen, a level).
+//
+// Loading goes through AssetLoader jobs: the owner calls BeginLoad(), queues
+// its jobs (AddJob() for each, JobDone() from each job's upload step, and
+// OnRelease() for every resource that came in), then EndQueue(). The group is
+// resident once every job has finished. Release() runs the registered unload
+// actions; if jobs are still in flight it is deferred until they finish.
+// All methods are main-thread only.
+class AssetGroup {
+public:
+  enum class State { UNLOADED, LOADING, RESIDENT };
+
+  explicit AssetGroup(const char *name = "");
+
+  const std::string &GetName() const { return name; }
+  State GetState() const { return state; }
+  bool IsResident() const { return state == State::RESIDENT; }
+  bool IsUnloaded() const { return state == State::UNLOADED; }
+
+  // UNLOADED -> LOADING. Returns false (and cancels a deferred release) when
+  // the group is already loading or resident: nothing to queue.
+  bool BeginLoad();
+  void EndQueue();
+
+  void AddJob();
+  void JobDone();
+  void OnRelease(std::function<void()> release);
+
+  void Release();
+
+private:
+  std::string name;
+  State state;
+  int pendingJobs;
+  bool queueing;
+  bool releaseRequested;
+  std::vector<std::function<void()>> releasers;
+
+  void CheckFinished();
+};
@@ -0,0 +1,150 @@
+#include "AssetLoader.h"
+#include "raylib.h"
+
+AssetLoader::AssetLoader() {
+  queued = 0;
+  finished = 0;
+  stopping = false;
+}
+
+AssetLoader::~AssetLoader() { Stop(); }
+
+void AssetLoader::Start(int threadCount) {
+  if (!workers.empty())
+    return;
+
+#if defined(PLATFORM_WEB)
+  threadCount = 0; // No pthreads in the web build: decode inside Pump()
+#else
+  if (threadCount < 0) {
+    int hw = (int)std::thread::hardware_concurrency();
+    threadCount = hw > 1 ? hw - 1 : 1;
+  }
+#endif
+
+  stopping = false;
+  for (int i = 0; i < threadCount; i++)
+    workers.emplace_back(&AssetLoader::WorkerLoop, this);
+}
+
+void AssetLoader::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cond.notify_all();
+  for (auto &t : workers) {
+    if (t.joinable())
+      t.join();
+  }
+  workers.clear();
+
+  // Decoded jobs hold payloads (images, waves) only their tasks can free,
+  // and their owners wait for every job: discard them all. After the join,
+  // so jobs a worker was still decoding are among them.
+  std::deque<Job> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    dropped = std::move(decoded);
+    decoded.clear();
+    for (Job &job : pending)
+      dropped.push_back(std::move(job));
+    pending.clear();
+  }
+  for (Job &job : dropped) {
+    if (job.discard)
+      job.discard();
+    std::lock_guard<std::mutex> lock(mutex);
+    finished++;
+  }
+}
+
+void AssetLoader::Queue(Task decode, Task upload, Task discard) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(
+        {std::move(decode), std::move(upload), std::move(discard)});
+    queued++;
+  }
+  cond.notify_one();
+}
+
+void AssetLoader::WorkerLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [this] { return stopping || !pending.empty(); });
+      if (stopping)
+        return;
+      job = std::move(pending.front());
+      pending.pop_front();
+    }
+
+    if (job.decode)
+      job.decode();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    decoded.push_back(std::move(job));
+  }
+}
+
+bool AssetLoader::Pump(double budgetSeconds) {
+  double start = GetTime();
+
+  while (true) {
+    Job job;
+    bool haveJob = false;
+    bool decodeHere = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!decoded.empty()) {
+        job = std::move(decoded.front());
+        decoded.pop_front();
+        haveJob = true;
+      } else if (workers.empty() && !pending.empty()) {
+        job = std::move(pending.front());
+        pending.pop_front();
+        haveJob = true;
+        decodeHere = true;
+      }
+    }
+    if (!haveJob)
+      break;
+
+    if (decodeHere && job.decode)
+      job.decode();
+    if (job.upload)
+      job.upload();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished++;
+    }
+
+    if (GetTime() - start >= budgetSeconds)
+      break;
+  }
+
+  return IsDone();
+}
+
+int AssetLoader::GetQueuedCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return queued;
+}
+
+int AssetLoader::GetFinishedCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return finished;
+}
+
+float AssetLoader::GetProgress() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return queued > 0 ? (float)finished / (float)queued : 1.0f;
+}
+
+bool AssetLoader::IsDone() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return finished == queued;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Background asset loading in two phases.
+//
+// decode runs on a pool of worker threads and does the CPU-only work
+// (LoadImage, LoadWave, LoadFileData, mesh building...). upload runs on the
+// main thread from Pump(), which spends at most a time budget per frame on
+// GPU/audio-device work (LoadTextureFromImage, LoadSoundFromWave...), so the
+// game keeps drawing frames while assets stream in.
+//
+// With zero worker threads (web build: no pthreads) Pump() also runs the
+// decode step on the main thread, one job at a time within the budget.
+class AssetLoader {
+public:
+  using Task = std::function<void()>;
+
+  AssetLoader();
+  ~AssetLoader();
+
+  // threadCount < 0: hardware threads - 1 (at least one)
+  void Start(int threadCount = -1);
+  // Joins the workers, then discards every job not yet uploaded (decoded
+  // or not) on the calling thread
+  void Stop();
+
+  // 'discard' runs instead of 'upload' for a job Stop() drops: it frees
+  // whatever decode produced and reports the job as done to its owner.
+  // Any task may be empty.
+  void Queue(Task decode, Task upload, Task discard = Task());
+
+  // Run main-thread uploads for up to budgetSeconds (at least one upload
+  // when one is ready). Returns true once every queued job has finished.
+  bool Pump(double budgetSeconds);
+
+  int GetQueuedCount() const;
+  int GetFinishedCount() const;
+  float GetProgress() const; // 0..1 over the jobs queued so far
+  bool IsDone() const;
+
+private:
+  struct Job {
+    Task decode;
+    Task upload;
+    Task discard;
+  };
+
+  std::vector<std::thread> workers;
+  mutable std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<Job> pending; // Waiting for a worker
+  std::deque<Job> decoded; // Waiting for the main thread
+  int queued;
+  int finished;
+  bool stopping;
+
+  void WorkerLoop();
+};
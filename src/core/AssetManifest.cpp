@@ -0,0 +1,87 @@
+#include "AssetManifest.h"
+#include <cstdio>
+#include <sstream>
+
+static const char *KindName(AssetManifest::Kind kind) {
+  switch (kind) {
+  case AssetManifest::Kind::IMAGE:
+    return "image";
+  case AssetManifest::Kind::AUDIO:
+    return "audio";
+  default:
+    return "copy";
+  }
+}
+
+bool AssetManifest::Parse(const char *text, size_t length) {
+  entries.clear();
+  lookup.clear();
+
+  std::istringstream in(std::string(text, length));
+  std::string line;
+  int version = 0;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream fields(line);
+    std::string key;
+    fields >> key;
+    if (key == "version") {
+      fields >> version;
+    } else if (key == "max_resolution") {
+      fields >> maxWidth >> maxHeight;
+    } else if (key == "premultiplied_alpha") {
+      int value = 0;
+      fields >> value;
+      premultipliedAlpha = value != 0;
+    } else if (key == "image" || key == "audio" || key == "copy") {
+      Entry e;
+      e.kind = key == "image"   ? Kind::IMAGE
+               : key == "audio" ? Kind::AUDIO
+                                : Kind::COPY;
+      fields >> e.source >> e.output >> e.width >> e.height >> e.sourceBytes >>
+          e.outputBytes >> e.mipLevels;
+      if (fields.fail() || e.mipLevels < 1)
+        return false;
+      lookup[e.source] = entries.size();
+      entries.push_back(e);
+    }
+  }
+  return version == VERSION;
+}
+
+bool AssetManifest::Save(const char *path) const {
+  FILE *file = fopen(path, "w");
+  if (file == nullptr)
+    return false;
+
+  fprintf(file, "# Written by AssetConditioner\n");
+  fprintf(file, "version %d\n", VERSION);
+  fprintf(file, "max_resolution %d %d\n", maxWidth, maxHeight);
+  fprintf(file, "premultiplied_alpha %d\n", premultipliedAlpha ? 1 : 0);
+  for (const Entry &e : entries) {
+    fprintf(file, "%s %s %s %d %d %llu %llu %d\n", KindName(e.kind),
+            e.source.c_str(), e.output.c_str(), e.width, e.height,
+            (unsigned long long)e.sourceBytes,
+            (unsigned long long)e.outputBytes, e.mipLevels);
+  }
+  return fclose(file) == 0;
+}
+
+const AssetManifest::Entry *
+AssetManifest::Find(const std::string &source) const {
+  auto found = lookup.find(source);
+  return found != lookup.end() ? &entries[found->second] : nullptr;
+}
+
+std::string AssetManifest::MipPath(const std::string &output, int level) {
+  if (level <= 0)
+    return output;
+  size_t dot = output.rfind('.');
+  size_t slash = output.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    dot = output.size();
+  return output.substr(0, dot) + ".mip" + std::to_string(level) +
+         output.substr(dot);
+}
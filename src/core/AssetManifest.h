@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// What the offline conditioner (tools/AssetConditioner.cpp) produced for
+// each source asset. Stored as text next to the conditioned files:
+//
+//   version 2
+//   max_resolution 1920 1080
+//   premultiplied_alpha 1
+//   image <source> <output> <width> <height> <source bytes> <output bytes>
+//         <mip levels>
+//   audio <source> <output> <sample rate> <channels> <source bytes> <...> 1
+//   copy <source> <output> 0 0 <source bytes> <output bytes> 1
+//
+// (one line per entry). Images also get pre-scaled variants: mip level N is
+// the image at half the size N times, stored next to it (see MipPath).
+//
+// The game looks source paths up here to read the conditioned file instead.
+class AssetManifest {
+public:
+  static constexpr const char *FILE_NAME = "manifest.txt";
+  static constexpr int VERSION = 2;
+
+  // Mip levels per image, full size included, and the smallest side a
+  // stored level may have
+  static constexpr int MAX_MIP_LEVELS = 4;
+  static constexpr int MIN_MIP_SIZE = 16;
+
+  enum class Kind { IMAGE, AUDIO, COPY };
+
+  struct Entry {
+    Kind kind = Kind::COPY;
+    std::string source; // Path the game asks for ("assets/sprites/x.png")
+    std::string output; // Conditioned file ("assets/sprites/x.qoi")
+    int width = 0;      // Images: size after downscaling
+    int height = 0;     // (audio: sample rate, channels)
+    uint64_t sourceBytes = 0;
+    uint64_t outputBytes = 0; // Mip levels included
+    int mipLevels = 1;        // Stored levels (level 0 is 'output')
+  };
+
+  int maxWidth = 0;
+  int maxHeight = 0;
+  bool premultipliedAlpha = false;
+  std::vector<Entry> entries;
+
+  bool Parse(const char *text, size_t length);
+  bool Save(const char *path) const;
+
+  const Entry *Find(const std::string &source) const;
+
+  // File of a mip level: "x.qoi" -> "x.mip2.qoi" (level 0 is the file itself)
+  static std::string MipPath(const std::string &output, int level);
+
+private:
+  std::unordered_map<std::string, size_t> lookup;
+};
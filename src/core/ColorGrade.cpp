@@ -0,0 +1,267 @@
+#include "ColorGrade.h"
+#include "Render.h"
+#include <algorithm>
+
+// Night grade fragment shader: samples the LUT strip trilinearly (bilinear
+// inside a slice, manual lerp between the two nearest blue slices) and mixes
+// the result with the source colour by gradeAmount. Premultiplied texels are
+// graded on their straight colour and premultiplied again.
+#if defined(PLATFORM_WEB)
+static const char *gradeFragShader = R"(#version 100
+precision mediump float;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform sampler2D lutTexture;
+uniform float gradeAmount;
+uniform float premultiplied;
+
+vec3 SampleLut(vec3 c) {
+  float size = 16.0;
+  float blue = c.b * (size - 1.0);
+  float slice0 = floor(blue);
+  float slice1 = min(slice0 + 1.0, size - 1.0);
+  float u = (c.r * (size - 1.0) + 0.5) / (size * size);
+  float v = (c.g * (size - 1.0) + 0.5) / size;
+  vec3 a = texture2D(lutTexture, vec2(u + slice0 / size, v)).rgb;
+  vec3 b = texture2D(lutTexture, vec2(u + slice1 / size, v)).rgb;
+  return mix(a, b, blue - slice0);
+}
+
+void main() {
+  vec4 texel = texture2D(texture0, fragTexCoord) * colDiffuse * fragColor;
+  vec3 rgb = texel.rgb;
+  if (premultiplied > 0.5 && texel.a > 0.0)
+    rgb /= texel.a;
+  vec3 graded = SampleLut(clamp(rgb, 0.0, 1.0));
+  rgb = mix(rgb, graded, gradeAmount);
+  if (premultiplied > 0.5)
+    rgb *= texel.a;
+  gl_FragColor = vec4(rgb, texel.a);
+}
+)";
+#else
+static const char *gradeFragShader = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform sampler2D lutTexture;
+uniform float gradeAmount;
+uniform float premultiplied;
+out vec4 finalColor;
+
+vec3 SampleLut(vec3 c) {
+  float size = 16.0;
+  float blue = c.b * (size - 1.0);
+  float slice0 = floor(blue);
+  float slice1 = min(slice0 + 1.0, size - 1.0);
+  float u = (c.r * (size - 1.0) + 0.5) / (size * size);
+  float v = (c.g * (size - 1.0) + 0.5) / size;
+  vec3 a = texture(lutTexture, vec2(u + slice0 / size, v)).rgb;
+  vec3 b = texture(lutTexture, vec2(u + slice1 / size, v)).rgb;
+  return mix(a, b, blue - slice0);
+}
+
+void main() {
+  vec4 texel = texture(texture0, fragTexCoord) * colDiffuse * fragColor;
+  vec3 rgb = texel.rgb;
+  if (premultiplied > 0.5 && texel.a > 0.0)
+    rgb /= texel.a;
+  vec3 graded = SampleLut(clamp(rgb, 0.0, 1.0));
+  rgb = mix(rgb, graded, gradeAmount);
+  if (premultiplied > 0.5)
+    rgb *= texel.a;
+  finalColor = vec4(rgb, texel.a);
+}
+)";
+#endif
+
+ColorGrade::ColorGrade() {
+  lutTex = {0};
+  shader = {0};
+  lutLoc = -1;
+  amountLoc = -1;
+  premultipliedLoc = -1;
+  premultiplied = false;
+  shaderReady = false;
+  isLoaded = false;
+}
+
+void ColorGrade::BuildNightLut() {
+  const int N = LUT_SIZE;
+  lut.resize(N * N * N);
+
+  for (int b = 0; b < N; b++) {
+    for (int g = 0; g < N; g++) {
+      for (int r = 0; r < N; r++) {
+        float fr = (float)r / (N - 1);
+        float fg = (float)g / (N - 1);
+        float fb = (float)b / (N - 1);
+
+        // Desaturate towards luminance
+        float lum = 0.299f * fr + 0.587f * fg + 0.114f * fb;
+        float sat = 0.45f;
+        fr = lum + (fr - lum) * sat;
+        fg = lum + (fg - lum) * sat;
+        fb = lum + (fb - lum) * sat;
+
+        // Darken with a cold moonlight tint, lift shadows towards blue
+        fr = fr * 0.38f + 0.02f;
+        fg = fg * 0.48f + 0.03f;
+        fb = fb * 0.78f + 0.07f;
+
+        Color &out = lut[(b * N + g) * N + r];
+        out.r = (unsigned char)(std::clamp(fr, 0.0f, 1.0f) * 255.0f + 0.5f);
+        out.g = (unsigned char)(std::clamp(fg, 0.0f, 1.0f) * 255.0f + 0.5f);
+        out.b = (unsigned char)(std::clamp(fb, 0.0f, 1.0f) * 255.0f + 0.5f);
+        out.a = 255;
+      }
+    }
+  }
+}
+
+void ColorGrade::Load() {
+  if (isLoaded)
+    return;
+  isLoaded = true;
+
+  BuildNightLut();
+
+  // Upload the LUT as a (N*N) x N strip: slice b occupies columns [b*N, b*N+N)
+  const int N = LUT_SIZE;
+  Image strip = GenImageColor(N * N, N, BLACK);
+  Color *pixels = (Color *)strip.data;
+  for (int b = 0; b < N; b++)
+    for (int g = 0; g < N; g++)
+      for (int r = 0; r < N; r++)
+        pixels[g * (N * N) + b * N + r] = lut[(b * N + g) * N + r];
+
+  lutTex = LoadTextureFromImage(strip);
+  UnloadImage(strip);
+  SetTextureFilter(lutTex, TEXTURE_FILTER_BILINEAR);
+  SetTextureWrap(lutTex, TEXTURE_WRAP_CLAMP);
+
+  shader = LoadShaderFromMemory(nullptr, gradeFragShader);
+  lutLoc = GetShaderLocation(shader, "lutTexture");
+  amountLoc = GetShaderLocation(shader, "gradeAmount");
+  premultipliedLoc = GetShaderLocation(shader, "premultiplied");
+
+  // A failed compile falls back to raylib's default shader, which has
+  // neither uniform: grade on the CPU instead
+  shaderReady = lutTex.id != 0 && lutLoc != -1 && amountLoc != -1;
+  if (!shaderReady) {
+    TraceLog(LOG_WARNING, "ColorGrade: LUT shader unavailable, baking night "
+                          "textures on the CPU");
+  }
+}
+
+void ColorGrade::Unload() {
+  if (!isLoaded)
+    return;
+  isLoaded = false;
+
+  if (shaderReady)
+    UnloadShader(shader);
+  if (lutTex.id != 0)
+    UnloadTexture(lutTex);
+  lutTex = {0};
+  shader = {0};
+  shaderReady = false;
+}
+
+void ColorGrade::Begin(float amount) {
+  if (!shaderReady)
+    return;
+  BeginShaderMode(shader);
+  Render::RecordStateChange();
+  SetShaderValue(shader, amountLoc, &amount, SHADER_UNIFORM_FLOAT);
+  float premultipliedValue = premultiplied ? 1.0f : 0.0f;
+  SetShaderValue(shader, premultipliedLoc, &premultipliedValue,
+                 SHADER_UNIFORM_FLOAT);
+  SetShaderValueTexture(shader, lutLoc, lutTex);
+}
+
+void ColorGrade::End() {
+  if (!shaderReady)
+    return;
+  EndShaderMode();
+  Render::RecordStateChange();
+}
+
+Color ColorGrade::Sample(Color c) const {
+  const int N = LUT_SIZE;
+  auto Axis = [N](unsigned char v, int &i0, int &i1, float &f) {
+    float x = v / 255.0f * (N - 1);
+    i0 = (int)x;
+    i1 = std::min(i0 + 1, N - 1);
+    f = x - (float)i0;
+  };
+
+  int r0, r1, g0, g1, b0, b1;
+  float fr, fg, fb;
+  Axis(c.r, r0, r1, fr);
+  Axis(c.g, g0, g1, fg);
+  Axis(c.b, b0, b1, fb);
+
+  auto At = [&](int r, int g, int b) -> const Color & {
+    return lut[(b * N + g) * N + r];
+  };
+  auto Lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+
+  float out[3];
+  for (int ch = 0; ch < 3; ch++) {
+    auto C = [ch](const Color &col) -> float {
+      return ch == 0 ? col.r : (ch == 1 ? col.g : col.b);
+    };
+    float c00 = Lerp(C(At(r0, g0, b0)), C(At(r1, g0, b0)), fr);
+    float c10 = Lerp(C(At(r0, g1, b0)), C(At(r1, g1, b0)), fr);
+    float c01 = Lerp(C(At(r0, g0, b1)), C(At(r1, g0, b1)), fr);
+    float c11 = Lerp(C(At(r0, g1, b1)), C(At(r1, g1, b1)), fr);
+    out[ch] = Lerp(Lerp(c00, c10, fg), Lerp(c01, c11, fg), fb);
+  }
+
+  return {(unsigned char)(out[0] + 0.5f), (unsigned char)(out[1] + 0.5f),
+          (unsigned char)(out[2] + 0.5f), c.a};
+}
+
+void ColorGrade::ApplyToImage(Image *image, float amount) const {
+  if (image == nullptr || image->data == nullptr || lut.empty())
+    return;
+
+  if (image->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+  Color *pixels = (Color *)image->data;
+  int count = image->width * image->height;
+  for (int i = 0; i < count; i++) {
+    Color &p = pixels[i];
+    if (premultiplied && p.a == 0)
+      continue;
+    Color straight = p;
+    if (premultiplied && p.a < 255) {
+      straight.r = (unsigned char)std::min(255, p.r * 255 / p.a);
+      straight.g = (unsigned char)std::min(255, p.g * 255 / p.a);
+      straight.b = (unsigned char)std::min(255, p.b * 255 / p.a);
+    }
+    Color graded = Sample(straight);
+    if (premultiplied && p.a < 255) {
+      graded.r = (unsigned char)(graded.r * p.a / 255);
+      graded.g = (unsigned char)(graded.g * p.a / 255);
+      graded.b = (unsigned char)(graded.b * p.a / 255);
+    }
+    p.r = (unsigned char)(p.r + (graded.r - p.r) * amount);
+    p.g = (unsigned char)(p.g + (graded.g - p.g) * amount);
+    p.b = (unsigned char)(p.b + (graded.b - p.b) * amount);
+  }
+}
+
+Image ColorGrade::GenNightImage(Image dayImage) const {
+  if (shaderReady || dayImage.data == nullptr)
+    return {0};
+
+  Image night = ImageCopy(dayImage);
+  ApplyToImage(&night, 1.0f);
+  return night;
+}
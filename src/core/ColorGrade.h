@@ -0,0 +1,59 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// Night colour grading with a 3D look-up table.
+//
+// The night look of the level art is derived from the day textures instead
+// of shipping (and keeping in VRAM) a second copy of every asset. The LUT is
+// LUT_SIZE^3 entries, stored as LUT_SIZE slices of LUT_SIZE x LUT_SIZE laid
+// side by side (blue selects the slice, red/green index inside it).
+//
+// Two paths:
+//  - GPU: a fragment shader samples the LUT at draw time, blended with the
+//    original colour by an amount (0 = day, 1 = night) so day/night can
+//    cross-fade smoothly.
+//  - CPU fallback (no shader support): the night variant is baked once at
+//    load time from the day image.
+class ColorGrade {
+public:
+  static constexpr int LUT_SIZE = 16;
+
+  ColorGrade();
+
+  void Load(); // Needs a GL context (call after InitWindow)
+  void Unload();
+
+  // True when the LUT shader compiled and grading happens at draw time
+  bool IsShaderReady() const { return shaderReady; }
+
+  // Textures (and images passed in) hold premultiplied alpha. Set before
+  // any night image is baked.
+  void SetPremultipliedAlpha(bool enabled) { premultiplied = enabled; }
+
+  // Draw-time grading. amount: 0 = day (identity), 1 = full night
+  void Begin(float amount);
+  void End();
+
+  // Night variant of an already decoded day image. Baked on the CPU
+  // fallback path only; returns an empty image ({0}) when grading on the GPU.
+  // CPU only, safe to call from loader threads once Load() has run.
+  Image GenNightImage(Image dayImage) const;
+
+  // Grade an image in place on the CPU (RGBA8 conversion is done if needed)
+  void ApplyToImage(Image *image, float amount) const;
+  Color Sample(Color c) const;
+
+private:
+  std::vector<Color> lut; // LUT_SIZE^3 entries, index = (b*N + g)*N + r
+  Texture2D lutTex;
+  Shader shader;
+  int lutLoc;
+  int amountLoc;
+  int premultipliedLoc;
+  bool premultiplied;
+  bool shaderReady;
+  bool isLoaded;
+
+  void BuildNightLut();
+};
@@ -0,0 +1,319 @@
+#include "FrameCapture.h"
+#include "rlgl.h"
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+
+// --- Minimal GL entry points for PBO readback ---
+// rlgl does not expose pixel buffer objects, so the few functions needed are
+// resolved through GLFW (linked into raylib on desktop platforms).
+#if !defined(PLATFORM_WEB)
+extern "C" void *glfwGetProcAddress(const char *procname);
+extern "C" int glfwExtensionSupported(const char *extension);
+#endif
+
+#if defined(_WIN32)
+#define CAPTURE_APIENTRY __stdcall
+#else
+#define CAPTURE_APIENTRY
+#endif
+
+#define CAPTURE_GL_PIXEL_PACK_BUFFER 0x88EB
+#define CAPTURE_GL_STREAM_READ 0x88E1
+#define CAPTURE_GL_MAP_READ_BIT 0x0001
+#define CAPTURE_GL_RGBA 0x1908
+#define CAPTURE_GL_UNSIGNED_BYTE 0x1401
+
+typedef void(CAPTURE_APIENTRY *PFNGenBuffers)(int, unsigned int *);
+typedef void(CAPTURE_APIENTRY *PFNDeleteBuffers)(int, const unsigned int *);
+typedef void(CAPTURE_APIENTRY *PFNBindBuffer)(unsigned int, unsigned int);
+typedef void(CAPTURE_APIENTRY *PFNBufferData)(unsigned int, ptrdiff_t,
+                                              const void *, unsigned int);
+typedef void *(CAPTURE_APIENTRY *PFNMapBufferRange)(unsigned int, ptrdiff_t,
+                                                     ptrdiff_t, unsigned int);
+typedef unsigned char(CAPTURE_APIENTRY *PFNUnmapBuffer)(unsigned int);
+typedef void(CAPTURE_APIENTRY *PFNReadPixels)(int, int, int, int, unsigned int,
+                                              unsigned int, void *);
+
+static PFNGenBuffers glGenBuffersPtr = nullptr;
+static PFNDeleteBuffers glDeleteBuffersPtr = nullptr;
+static PFNBindBuffer glBindBufferPtr = nullptr;
+static PFNBufferData glBufferDataPtr = nullptr;
+static PFNMapBufferRange glMapBufferRangePtr = nullptr;
+static PFNUnmapBuffer glUnmapBufferPtr = nullptr;
+static PFNReadPixels glReadPixelsPtr = nullptr;
+
+FrameCapture::FrameCapture() {
+  recording = false;
+  format = Format::PNG;
+  glReady = false;
+  for (int i = 0; i < PBO_COUNT; i++) {
+    pbo[i] = 0;
+    pboPending[i] = false;
+    pboFrameIndex[i] = 0;
+  }
+  pboWidth = 0;
+  pboHeight = 0;
+  ringPos = 0;
+  framesCaptured = 0;
+  stopWorker = false;
+  framesWritten = 0;
+  framesDropped = 0;
+}
+
+FrameCapture::~FrameCapture() { Stop(); }
+
+bool FrameCapture::LoadGLFunctions() {
+#if defined(PLATFORM_WEB)
+  return false;
+#else
+  // PBOs need desktop GL 2.1+ (GL ES 2.0 has none), and glMapBufferRange
+  // GL 3.0+: on 2.1 only through the extension. The entry point alone
+  // proves nothing, drivers resolve names they do not support.
+  int version = rlGetVersion();
+  if (version == RL_OPENGL_11 || version == RL_OPENGL_ES_20)
+    return false;
+  if (version == RL_OPENGL_21 &&
+      !glfwExtensionSupported("GL_ARB_map_buffer_range"))
+    return false;
+
+  glGenBuffersPtr = (PFNGenBuffers)glfwGetProcAddress("glGenBuffers");
+  glDeleteBuffersPtr = (PFNDeleteBuffers)glfwGetProcAddress("glDeleteBuffers");
+  glBindBufferPtr = (PFNBindBuffer)glfwGetProcAddress("glBindBuffer");
+  glBufferDataPtr = (PFNBufferData)glfwGetProcAddress("glBufferData");
+  glMapBufferRangePtr =
+      (PFNMapBufferRange)glfwGetProcAddress("glMapBufferRange");
+  glUnmapBufferPtr = (PFNUnmapBuffer)glfwGetProcAddress("glUnmapBuffer");
+  glReadPixelsPtr = (PFNReadPixels)glfwGetProcAddress("glReadPixels");
+
+  return glGenBuffersPtr && glDeleteBuffersPtr && glBindBufferPtr &&
+         glBufferDataPtr && glMapBufferRangePtr && glUnmapBufferPtr &&
+         glReadPixelsPtr;
+#endif
+}
+
+bool FrameCapture::Start(const char *baseDir, Format fmt) {
+  if (recording)
+    return true;
+
+  if (!glReady)
+    glReady = LoadGLFunctions();
+  if (!glReady) {
+    TraceLog(LOG_WARNING, "FrameCapture: pixel buffer objects unavailable, "
+                          "capture disabled");
+    return false;
+  }
+
+  // One directory per recording: <baseDir>/capture_YYYYMMDD_HHMMSS
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+  MakeDirectory(baseDir);
+  directory = std::string(baseDir) + "/capture_" + stamp;
+  MakeDirectory(directory.c_str());
+
+  format = fmt;
+  ringPos = 0;
+  framesCaptured = 0;
+  framesWritten = 0;
+  framesDropped = 0;
+  for (int i = 0; i < PBO_COUNT; i++)
+    pboPending[i] = false;
+
+  stopWorker = false;
+  worker = std::thread(&FrameCapture::WorkerLoop, this);
+  recording = true;
+
+  TraceLog(LOG_INFO, "FrameCapture: recording to %s", directory.c_str());
+  return true;
+}
+
+void FrameCapture::Stop() {
+  if (!recording)
+    return;
+  recording = false;
+
+  // Collect the frames still in flight, oldest first
+  for (int i = 0; i < PBO_COUNT; i++)
+    CollectSlot((ringPos + i) % PBO_COUNT);
+
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopWorker = true;
+  }
+  queueCond.notify_one();
+  if (worker.joinable())
+    worker.join();
+
+  ReleaseBuffers();
+
+  TraceLog(LOG_INFO, "FrameCapture: %d frames written, %d dropped",
+           framesWritten.load(), framesDropped.load());
+}
+
+void FrameCapture::ResizeBuffers(int width, int height) {
+  ReleaseBuffers();
+  glGenBuffersPtr(PBO_COUNT, pbo);
+  for (int i = 0; i < PBO_COUNT; i++) {
+    glBindBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER, pbo[i]);
+    glBufferDataPtr(CAPTURE_GL_PIXEL_PACK_BUFFER,
+                    (ptrdiff_t)width * height * 4, nullptr,
+                    CAPTURE_GL_STREAM_READ);
+    pboPending[i] = false;
+  }
+  glBindBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER, 0);
+  pboWidth = width;
+  pboHeight = height;
+}
+
+void FrameCapture::ReleaseBuffers() {
+  if (pbo[0] != 0)
+    glDeleteBuffersPtr(PBO_COUNT, pbo);
+  for (int i = 0; i < PBO_COUNT; i++) {
+    pbo[i] = 0;
+    pboPending[i] = false;
+  }
+  pboWidth = 0;
+  pboHeight = 0;
+}
+
+void FrameCapture::CaptureFrame() {
+  if (!recording)
+    return;
+
+  int width = GetRenderWidth();
+  int height = GetRenderHeight();
+  if (width <= 0 || height <= 0)
+    return;
+
+  // Resolution changed: frames in flight are for the old size
+  if (width != pboWidth || height != pboHeight) {
+    for (int i = 0; i < PBO_COUNT; i++) {
+      if (pboPending[i])
+        framesDropped++;
+    }
+    ResizeBuffers(width, height);
+  }
+
+  // Submit everything drawn so far before reading the back buffer
+  rlDrawRenderBatchActive();
+
+  // The slot we are about to reuse holds the oldest frame: collect it first
+  int slot = ringPos;
+  CollectSlot(slot);
+
+  glBindBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER, pbo[slot]);
+  glReadPixelsPtr(0, 0, width, height, CAPTURE_GL_RGBA,
+                  CAPTURE_GL_UNSIGNED_BYTE, nullptr); // Async into the PBO
+  glBindBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER, 0);
+
+  pboPending[slot] = true;
+  pboFrameIndex[slot] = framesCaptured++;
+  ringPos = (ringPos + 1) % PBO_COUNT;
+}
+
+void FrameCapture::CollectSlot(int slot) {
+  if (!pboPending[slot])
+    return;
+  pboPending[slot] = false;
+
+  // Bounded queue: drop the frame rather than stall on the encoder
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if ((int)queue.size() >= MAX_QUEUED) {
+      framesDropped++;
+      return;
+    }
+  }
+
+  size_t size = (size_t)pboWidth * pboHeight * 4;
+  Frame frame;
+  frame.index = pboFrameIndex[slot];
+  frame.width = pboWidth;
+  frame.height = pboHeight;
+
+  glBindBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER, pbo[slot]);
+  void *mapped = glMapBufferRangePtr(CAPTURE_GL_PIXEL_PACK_BUFFER, 0,
+                                     (ptrdiff_t)size, CAPTURE_GL_MAP_READ_BIT);
+  if (mapped != nullptr) {
+    frame.pixels.resize(size);
+    memcpy(frame.pixels.data(), mapped, size);
+    glUnmapBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBufferPtr(CAPTURE_GL_PIXEL_PACK_BUFFER, 0);
+
+  if (frame.pixels.empty()) {
+    framesDropped++;
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queue.push_back(std::move(frame));
+  }
+  queueCond.notify_one();
+}
+
+void FrameCapture::WorkerLoop() {
+  FILE *rawFile = nullptr;
+  if (format == Format::RAW) {
+    std::string path = directory + "/capture.rgba";
+    rawFile = fopen(path.c_str(), "wb");
+  }
+
+  while (true) {
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueCond.wait(lock, [this] { return stopWorker || !queue.empty(); });
+      if (queue.empty())
+        break; // Stopped and drained
+      frame = std::move(queue.front());
+      queue.pop_front();
+    }
+    Encode(frame, rawFile);
+  }
+
+  if (rawFile != nullptr)
+    fclose(rawFile);
+}
+
+void FrameCapture::Encode(Frame &frame, FILE *rawFile) {
+  // GL rows are bottom-up: flip in place
+  size_t stride = (size_t)frame.width * 4;
+  std::vector<unsigned char> row(stride);
+  for (int y = 0; y < frame.height / 2; y++) {
+    unsigned char *top = frame.pixels.data() + y * stride;
+    unsigned char *bottom =
+        frame.pixels.data() + (frame.height - 1 - y) * stride;
+    memcpy(row.data(), top, stride);
+    memcpy(top, bottom, stride);
+    memcpy(bottom, row.data(), stride);
+  }
+
+  // The back buffer alpha is meaningless for a capture
+  for (size_t i = 3; i < frame.pixels.size(); i += 4)
+    frame.pixels[i] = 255;
+
+  bool ok = false;
+  if (format == Format::RAW) {
+    // Raw stream: 16-byte header (magic, index, width, height) + RGBA8
+    if (rawFile != nullptr) {
+      int header[4] = {0x41475752, frame.index, frame.width, frame.height};
+      ok = fwrite(header, sizeof(header), 1, rawFile) == 1 &&
+           fwrite(frame.pixels.data(), frame.pixels.size(), 1, rawFile) == 1;
+    }
+  } else {
+    Image img = {frame.pixels.data(), frame.width, frame.height, 1,
+                 PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%06d.%s", directory.c_str(),
+             frame.index, format == Format::QOI ? "qoi" : "png");
+    ok = ExportImage(img, path);
+  }
+
+  if (ok)
+    framesWritten++;
+  else
+    framesDropped++;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "raylib.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// In-game frame capture to disk without stalling the frame.
+//
+// Each captured frame is read back into a ring of GL pixel buffer objects
+// (PBOs); the copy is only mapped PBO_COUNT frames later, when the GPU has
+// long finished it. Mapped frames are handed to a worker thread that encodes
+// them (PNG or QOI image sequence, or a single raw RGBA stream). The queue is
+// bounded: when the encoder falls behind, frames are dropped instead of
+// blocking the main loop.
+//
+// Desktop only: WebGL 1 has no PBOs and the web build has no threads, so
+// Start() refuses to record there.
+class FrameCapture {
+public:
+  enum class Format { PNG, QOI, RAW };
+
+  static constexpr int PBO_COUNT = 2;  // Readback delay in frames
+  static constexpr int MAX_QUEUED = 8; // Frames waiting for the encoder
+
+  FrameCapture();
+  ~FrameCapture();
+
+  // Start recording into a new directory under 'baseDir'
+  bool Start(const char *baseDir, Format format);
+  void Stop(); // Flushes pending readbacks, joins the encoder
+  bool IsRecording() const { return recording; }
+
+  // Call once per frame after everything to be captured is drawn and
+  // before EndDrawing (needs the GL context)
+  void CaptureFrame();
+
+  int GetFramesCaptured() const { return framesCaptured; }
+  int GetFramesWritten() const { return framesWritten.load(); }
+  int GetFramesDropped() const { return framesDropped.load(); }
+  const char *GetDirectory() const { return directory.c_str(); }
+
+private:
+  struct Frame {
+    int index;
+    int width;
+    int height;
+    std::vector<unsigned char> pixels; // RGBA8, bottom-up (GL order)
+  };
+
+  bool recording;
+  Format format;
+  std::string directory;
+
+  // Readback ring
+  bool glReady;
+  unsigned int pbo[PBO_COUNT];
+  bool pboPending[PBO_COUNT];
+  int pboFrameIndex[PBO_COUNT];
+  int pboWidth;
+  int pboHeight;
+  int ringPos;
+  int framesCaptured;
+
+  // Encoder
+  std::thread worker;
+  std::mutex queueMutex;
+  std::condition_variable queueCond;
+  std::deque<Frame> queue;
+  bool stopWorker;
+  std::atomic<int> framesWritten;
+  std::atomic<int> framesDropped;
+
+  bool LoadGLFunctions();
+  void ResizeBuffers(int width, int height);
+  void ReleaseBuffers();
+  void CollectSlot(int slot); // Map a finished PBO and queue its frame
+  void WorkerLoop();
+  void Encode(Frame &frame, FILE *rawFile);
+};
@@ -0,0 +1,226 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// Queue of the worker running on this thread (-1: not a worker)
+thread_local int workerQueue = -1;
+
+} // namespace
+
+struct JobSystem::Handle::State {
+  std::atomic<int> remaining; // Work units (chunks) still to finish
+  std::mutex mutex;
+  std::vector<Task> continuations; // Released when remaining hits 0
+  bool done = false;               // Guarded by mutex
+};
+
+bool JobSystem::Handle::IsDone() const {
+  return state == nullptr || state->remaining.load() == 0;
+}
+
+JobSystem::JobSystem() {
+  queuedJobs = 0;
+  nextQueue = 0;
+  stopping = false;
+}
+
+JobSystem::~JobSystem() { Stop(); }
+
+void JobSystem::Start(int threadCount) {
+  if (!queues.empty())
+    return;
+
+#if defined(PLATFORM_WEB)
+  threadCount = 0; // No pthreads in the web build: jobs run in Wait()
+#else
+  if (threadCount < 0) {
+    int hw = (int)std::thread::hardware_concurrency();
+    threadCount = hw > 1 ? hw - 1 : 1;
+  }
+#endif
+
+  // Last queue: jobs pushed from threads outside the pool
+  for (int i = 0; i <= threadCount; i++)
+    queues.push_back(std::make_unique<Queue>());
+  stopping = false;
+  for (int i = 0; i < threadCount; i++)
+    workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+void JobSystem::Stop() {
+  if (queues.empty())
+    return;
+  // Drain: dependent jobs may hold references the caller is about to free
+  while (RunOne((int)queues.size() - 1)) {
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &t : workers) {
+    if (t.joinable())
+      t.join();
+  }
+  workers.clear();
+  queues.clear();
+}
+
+JobSystem::Handle JobSystem::Schedule(Task task,
+                                      std::initializer_list<Handle> deps) {
+  return Submit(std::move(task), 1, deps);
+}
+
+JobSystem::Handle JobSystem::ParallelFor(int count, int grain, RangeTask task,
+                                         std::initializer_list<Handle> deps) {
+  if (count <= 0)
+    return Handle();
+  grain = std::max(1, grain);
+  int chunks = (count + grain - 1) / grain;
+
+  // One chunk, nothing to wait for: no job at all
+  bool ready = std::all_of(deps.begin(), deps.end(),
+                           [](const Handle &h) { return h.IsDone(); });
+  if (chunks == 1 && ready) {
+    task(0, count);
+    return Handle();
+  }
+
+  // The chunks share one handle; they are queued once the dependencies are
+  // done, by whichever thread finishes the last of them
+  auto shared = std::make_shared<RangeTask>(std::move(task));
+  Handle handle;
+  handle.state = std::make_shared<Handle::State>();
+  handle.state->remaining = chunks;
+  auto state = handle.state;
+  Task release = [this, shared, state, count, grain, chunks]() {
+    for (int c = 0; c < chunks; c++) {
+      int begin = c * grain;
+      int end = std::min(count, begin + grain);
+      Push({[shared, begin, end]() { (*shared)(begin, end); }, state});
+    }
+  };
+
+  if (ready)
+    release();
+  else
+    Submit(std::move(release), 1, deps); // Its own handle is not needed
+  return handle;
+}
+
+JobSystem::Handle JobSystem::Submit(Task task, int units,
+                                    std::initializer_list<Handle> deps) {
+  Handle handle;
+  handle.state = std::make_shared<Handle::State>();
+  handle.state->remaining = units;
+  Job job = {std::move(task), handle.state};
+
+  // Count the unfinished dependencies; the last one to finish queues the job
+  auto waiting = std::make_shared<std::atomic<int>>(1);
+  auto shared = std::make_shared<Job>(std::move(job));
+  Task release = [this, waiting, shared]() {
+    if (waiting->fetch_sub(1) == 1)
+      Push(std::move(*shared));
+  };
+  for (const Handle &dep : deps) {
+    if (dep.state == nullptr)
+      continue;
+    std::lock_guard<std::mutex> lock(dep.state->mutex);
+    if (!dep.state->done) {
+      waiting->fetch_add(1);
+      dep.state->continuations.push_back(release);
+    }
+  }
+  release(); // Drops the initial count
+  return handle;
+}
+
+void JobSystem::Push(Job job) {
+  if (queues.empty()) {
+    // Not started: run in place
+    job.task();
+    Finish(job.done);
+    return;
+  }
+  int index = workerQueue >= 0
+                  ? workerQueue
+                  : (workers.empty() ? (int)queues.size() - 1
+                                     : (int)(nextQueue++ % workers.size()));
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->jobs.push_back(std::move(job));
+  }
+  queuedJobs++;
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+  }
+  wake.notify_one();
+}
+
+bool JobSystem::RunOne(int home) {
+  Job job;
+  bool found = false;
+  int count = (int)queues.size();
+  for (int k = 0; k < count && !found; k++) {
+    int index = (home + k) % count;
+    Queue &queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+      continue;
+    // Own queue: newest first (still in cache); others: steal the oldest
+    if (k == 0) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    } else {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+    found = true;
+  }
+  if (!found)
+    return false;
+
+  queuedJobs--;
+  job.task();
+  Finish(job.done);
+  return true;
+}
+
+void JobSystem::Finish(const std::shared_ptr<Handle::State> &state) {
+  if (state->remaining.fetch_sub(1) != 1)
+    return;
+  std::vector<Task> continuations;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->done = true;
+    continuations.swap(state->continuations);
+  }
+  for (Task &next : continuations)
+    next();
+}
+
+void JobSystem::Wait(const Handle &handle) {
+  int home = workerQueue >= 0 ? workerQueue : (int)queues.size() - 1;
+  while (!handle.IsDone()) {
+    if (queues.empty() || !RunOne(home))
+      std::this_thread::yield(); // Last jobs are running elsewhere
+  }
+}
+
+void JobSystem::WorkerLoop(int index) {
+  workerQueue = index;
+  char name[32];
+  snprintf(name, sizeof(name), "Worker %d", index);
+  Profiler::SetThreadName(name);
+  while (true) {
+    if (RunOne(index))
+      continue;
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [this] { return stopping || queuedJobs.load() > 0; });
+    if (stopping)
+      return;
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job scheduler for per-frame simulation work.
+//
+// A fixed pool of workers, each with its own deque: a worker takes its
+// newest job from the back, and an idle one steals the oldest job from the
+// front of another's. Jobs can depend on earlier ones through handles, and
+// Wait() runs pending jobs on the calling thread instead of blocking, so
+// the game thread is the pool's extra worker while it waits.
+//
+// Jobs must not depend on which thread runs them or in which order: each
+// writes only its own outputs (results by index), and the game combines
+// them in index order afterwards, so a frame is identical at any worker
+// count. With zero workers (web build: no pthreads) everything runs inside
+// Wait().
+class JobSystem {
+public:
+  using Task = std::function<void()>;
+  using RangeTask = std::function<void(int begin, int end)>;
+
+  // Completion of a job or a whole parallel-for; empty = already done
+  class Handle {
+  public:
+    bool IsDone() const;
+
+  private:
+    friend class JobSystem;
+    struct State;
+    std::shared_ptr<State> state;
+  };
+
+  JobSystem();
+  ~JobSystem();
+
+  // threadCount < 0: hardware threads - 1 (the caller of Wait() is one more)
+  void Start(int threadCount = -1);
+  void Stop(); // Runs what is queued, then joins the workers
+
+  // Run 'task' once every dependency is done
+  Handle Schedule(Task task, std::initializer_list<Handle> dependencies = {});
+
+  // task(begin, end) over [0, count) in chunks of 'grain' items. A range
+  // of one chunk runs inline, so small levels pay no scheduling cost.
+  Handle ParallelFor(int count, int grain, RangeTask task,
+                     std::initializer_list<Handle> dependencies = {});
+
+  void Wait(const Handle &handle); // Helps run jobs until 'handle' is done
+
+  int GetWorkerCount() const { return (int)workers.size(); }
+
+private:
+  struct Job {
+    Task task;
+    std::shared_ptr<Handle::State> done; // Finished when it has run
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<Queue>> queues; // One per worker, + callers'
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  std::atomic<int> queuedJobs;
+  std::atomic<unsigned> nextQueue;
+  std::atomic<bool> stopping;
+
+  Handle Submit(Task task, int units,
+                std::initializer_list<Handle> dependencies);
+  void Push(Job job);
+  bool RunOne(int home); // Own back first, then steal; false if none
+  void Finish(const std::shared_ptr<Handle::State> &state);
+  void WorkerLoop(int index);
+};
@@ -0,0 +1,201 @@
+#include "MusicStreamer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Buffers hold ~0.1 s of audio: refill well within that
+constexpr auto REFILL_INTERVAL = std::chrono::milliseconds(5);
+
+double Now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+MusicStreamer::MusicStreamer() {
+  posted = 0;
+  handled = 0;
+  stopping = false;
+  playing = false;
+  tracks[0] = tracks[1] = {0};
+  hasTrack[0] = hasTrack[1] = false;
+  mix = 0.0f;
+  mixTarget = 0.0f;
+  volume = 1.0f;
+  lastTime = Now();
+}
+
+MusicStreamer::~MusicStreamer() { Stop(); }
+
+void MusicStreamer::Start() {
+#if !defined(PLATFORM_WEB)
+  if (thread.joinable())
+    return;
+  stopping = false;
+  thread = std::thread(&MusicStreamer::ThreadLoop, this);
+#endif
+}
+
+void MusicStreamer::Stop() {
+  Halt();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cond.notify_all();
+  if (thread.joinable())
+    thread.join();
+}
+
+void MusicStreamer::Play(const Music *day, const Music *night, bool isNight) {
+  Command command = {};
+  command.type = Command::PLAY;
+  const Music *pair[2] = {day, night};
+  for (int i = 0; i < 2; i++) {
+    command.hasTrack[i] = pair[i] != nullptr && pair[i]->stream.buffer != nullptr;
+    command.tracks[i] = command.hasTrack[i] ? *pair[i] : Music{0};
+  }
+  command.isNight = isNight;
+  Post(command);
+}
+
+void MusicStreamer::SetNight(bool isNight) {
+  Command command = {};
+  command.type = Command::NIGHT;
+  command.isNight = isNight;
+  Post(command);
+}
+
+void MusicStreamer::SetVolume(float value) {
+  Command command = {};
+  command.type = Command::VOLUME;
+  command.volume = value;
+  Post(command);
+}
+
+void MusicStreamer::Halt() {
+  Command command = {};
+  command.type = Command::HALT;
+  Post(command);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!thread.joinable() || stopping) {
+    // No thread: apply here
+    lock.unlock();
+    Refill();
+    return;
+  }
+  unsigned ticket = posted;
+  applied.wait(lock, [&] { return handled >= ticket; });
+}
+
+bool MusicStreamer::IsPlaying() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return playing;
+}
+
+void MusicStreamer::Pump() {
+  if (!thread.joinable())
+    Refill();
+}
+
+void MusicStreamer::Post(const Command &command) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    commands.push_back(command);
+    posted++;
+    if (command.type == Command::PLAY)
+      playing = command.hasTrack[0] || command.hasTrack[1];
+    else if (command.type == Command::HALT)
+      playing = false;
+  }
+  cond.notify_one();
+}
+
+void MusicStreamer::Apply(const Command &command) {
+  switch (command.type) {
+  case Command::PLAY:
+    for (int i = 0; i < 2; i++) {
+      if (hasTrack[i])
+        StopMusicStream(tracks[i]);
+    }
+    mix = mixTarget = command.isNight ? 1.0f : 0.0f;
+    for (int i = 0; i < 2; i++) {
+      tracks[i] = command.tracks[i];
+      hasTrack[i] = command.hasTrack[i];
+    }
+    // Started back to back so the pair stays aligned
+    for (int i = 0; i < 2; i++) {
+      if (hasTrack[i]) {
+        SetMusicVolume(tracks[i], volume * (i == 0 ? 1.0f - mix : mix));
+        PlayMusicStream(tracks[i]);
+      }
+    }
+    break;
+  case Command::NIGHT:
+    mixTarget = command.isNight ? 1.0f : 0.0f;
+    break;
+  case Command::VOLUME:
+    volume = command.volume;
+    break;
+  case Command::HALT:
+    for (int i = 0; i < 2; i++) {
+      if (hasTrack[i])
+        StopMusicStream(tracks[i]);
+      tracks[i] = {0};
+      hasTrack[i] = false;
+    }
+    break;
+  }
+}
+
+void MusicStreamer::Refill() {
+  // Commands first, outside the lock
+  std::vector<Command> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.swap(commands);
+  }
+  for (const Command &command : pending)
+    Apply(command);
+  if (!pending.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      handled += (unsigned)pending.size();
+    }
+    applied.notify_all();
+  }
+
+  double now = Now();
+  float dt = (float)(now - lastTime);
+  lastTime = now;
+  if (mix != mixTarget) {
+    float step = dt / CROSSFADE_SECONDS;
+    mix = mix < mixTarget ? std::min(mixTarget, mix + step)
+                          : std::max(mixTarget, mix - step);
+  }
+
+  PROFILE_SCOPE("UpdateMusicStream");
+  for (int i = 0; i < 2; i++) {
+    if (!hasTrack[i])
+      continue;
+    // The silent track keeps decoding so it is in step when it fades in
+    SetMusicVolume(tracks[i], volume * (i == 0 ? 1.0f - mix : mix));
+    UpdateMusicStream(tracks[i]);
+  }
+}
+
+void MusicStreamer::ThreadLoop() {
+  Profiler::SetThreadName("Music");
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    lock.unlock();
+    Refill();
+    lock.lock();
+    cond.wait_for(lock, REFILL_INTERVAL,
+                  [&] { return stopping || !commands.empty(); });
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "raylib.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Music playback off the game thread.
+//
+// A dedicated thread refills the stream buffers (UpdateMusicStream), so a
+// long frame never starves the audio device. The game only posts commands,
+// which the thread applies on its next pass; nothing here waits on a
+// decode except Stop().
+//
+// A level's day and night tracks play as one pair: both decode in lock-step
+// from the same start, only the mix between them changes, so switching
+// crossfades instead of restarting a track.
+//
+// Without threads (web build) Pump() does the refill on the main thread.
+class MusicStreamer {
+public:
+  static constexpr float CROSSFADE_SECONDS = 1.5f;
+
+  MusicStreamer();
+  ~MusicStreamer();
+
+  void Start();
+  void Stop(); // Stops playback and joins the thread
+
+  // Play a day/night pair from the start (either may be null); 'isNight'
+  // picks the audible one. A single track is a pair without a partner.
+  void Play(const Music *day, const Music *night, bool isNight);
+  void Play(const Music &track) { Play(&track, nullptr, false); }
+  void SetNight(bool isNight); // Crossfade to the other track
+  void SetVolume(float volume);
+
+  // Stop playback. Returns once the thread no longer touches the streams,
+  // so they can be unloaded right after.
+  void Halt();
+  bool IsPlaying() const;
+
+  void Pump(); // Main-thread refill when there is no thread (web)
+
+private:
+  struct Command {
+    enum Type { PLAY, NIGHT, VOLUME, HALT } type;
+    Music tracks[2]; // Day, night
+    bool hasTrack[2];
+    bool isNight;
+    float volume;
+  };
+
+  std::thread thread;
+  mutable std::mutex mutex;
+  std::condition_variable cond;    // Wakes the thread for new commands
+  std::condition_variable applied; // Signals Halt() callers
+  std::vector<Command> commands;
+  unsigned posted;  // Commands posted so far
+  unsigned handled; // Commands applied so far
+  bool stopping;
+  bool playing; // As last posted (main thread view)
+
+  // Audio thread state
+  Music tracks[2];
+  bool hasTrack[2];
+  float mix;       // 0 = day track audible, 1 = night
+  float mixTarget;
+  float volume;
+  double lastTime;
+
+  void Post(const Command &command);
+  void Apply(const Command &command);
+  void Refill(); // One pass: commands, buffers, crossfade
+  void ThreadLoop();
+};
@@ -0,0 +1,369 @@
+#include "PackFile.h"
+#include "AssetManifest.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(PLATFORM_WEB)
+#include <emscripten.h>
+#elif defined(_WIN32)
+// Keep windows.h from clashing with raylib (Rectangle, CloseWindow...)
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#undef near
+#undef far
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "raylib.h"
+
+#if defined(PLATFORM_WEB)
+// Fetch [offset, offset + size) of 'url' into 'dest'; returns bytes written.
+// Suspends the caller through ASYNCIFY while the request is in flight.
+EM_ASYNC_JS(int, FetchRange, (const char *url, double offset, int size,
+                              unsigned char *dest), {
+  try {
+    const last = offset + size - 1;
+    const response = await fetch(UTF8ToString(url), {
+      headers: {Range: 'bytes=' + offset + '-' + last}
+    });
+    if (!response.ok)
+      return 0;
+    let bytes = new Uint8Array(await response.arrayBuffer());
+    // Servers without range support send the whole file
+    if (response.status == 200)
+      bytes = bytes.subarray(offset, offset + size);
+    const count = Math.min(bytes.length, size);
+    HEAPU8.set(bytes.subarray(0, count), dest);
+    return count;
+  } catch (e) {
+    return 0;
+  }
+});
+#endif
+
+PackFile::PackFile() {
+  isOpen = false;
+  mapped = nullptr;
+  mappedSize = 0;
+#if defined(_WIN32)
+  fileHandle = nullptr;
+  mappingHandle = nullptr;
+#endif
+}
+
+PackFile::~PackFile() { Close(); }
+
+bool PackFile::Open(const char *filePath) {
+  Close();
+  path = filePath;
+
+#if defined(PLATFORM_WEB)
+  Pack::Header header;
+  if (FetchRange(filePath, 0, (int)sizeof(header), (unsigned char *)&header) !=
+      (int)sizeof(header))
+    return false;
+  if (memcmp(header.magic, Pack::MAGIC, 4) != 0 ||
+      header.version != Pack::VERSION) {
+    TraceLog(LOG_WARNING, "PACK: [%s] Not a version %u pack", filePath,
+             Pack::VERSION);
+    return false;
+  }
+  std::vector<unsigned char> toc(header.tocSize);
+  if (FetchRange(filePath, (double)sizeof(header), (int)toc.size(),
+                 toc.data()) != (int)toc.size())
+    return false;
+  if (!ReadToc(toc.data(), header))
+    return false;
+#else
+  if (!MapFile())
+    return false;
+  Pack::Header header;
+  if (mappedSize < sizeof(header)) {
+    UnmapFile();
+    return false;
+  }
+  memcpy(&header, mapped, sizeof(header));
+  if (memcmp(header.magic, Pack::MAGIC, 4) != 0 ||
+      header.version != Pack::VERSION ||
+      sizeof(header) + header.tocSize > mappedSize) {
+    TraceLog(LOG_WARNING, "PACK: [%s] Not a version %u pack", filePath,
+             Pack::VERSION);
+    UnmapFile();
+    return false;
+  }
+  if (!ReadToc(mapped + sizeof(header), header)) {
+    UnmapFile();
+    return false;
+  }
+  for (const Pack::Entry &e : entries) {
+    if (e.offset + e.size > mappedSize) {
+      TraceLog(LOG_WARNING, "PACK: [%s] Truncated", filePath);
+      UnmapFile();
+      return false;
+    }
+  }
+#endif
+
+  isOpen = true;
+  TraceLog(LOG_INFO, "PACK: [%s] Opened, %d entries", filePath,
+           (int)entries.size());
+  return true;
+}
+
+bool PackFile::ReadToc(const unsigned char *toc, const Pack::Header &header) {
+  size_t entryBytes = (size_t)header.entryCount * sizeof(Pack::Entry);
+  if (entryBytes > header.tocSize)
+    return false;
+
+  entries.resize(header.entryCount);
+  memcpy(entries.data(), toc, entryBytes);
+  names.assign((const char *)toc + entryBytes,
+               (const char *)toc + header.tocSize);
+
+  lookup.clear();
+  for (int i = 0; i < (int)entries.size(); i++) {
+    const Pack::Entry &e = entries[i];
+    if ((size_t)e.nameOffset + e.nameLength > names.size() ||
+        Pack::HashName(names.data() + e.nameOffset, e.nameLength) != e.hash)
+      return false;
+    lookup.emplace(e.hash, i);
+  }
+  return true;
+}
+
+int PackFile::Find(const std::string &name) const {
+  auto range = lookup.equal_range(Pack::HashName(name.data(), name.size()));
+  for (auto it = range.first; it != range.second; ++it) {
+    const Pack::Entry &e = entries[it->second];
+    if (e.nameLength == name.size() &&
+        memcmp(names.data() + e.nameOffset, name.data(), name.size()) == 0)
+      return it->second;
+  }
+  return -1;
+}
+
+void PackFile::Close() {
+  if (!isOpen && mapped == nullptr)
+    return;
+  UnmapFile();
+  entries.clear();
+  names.clear();
+  lookup.clear();
+  isOpen = false;
+}
+
+bool PackFile::Contains(const std::string &name) const {
+  return Find(name) >= 0;
+}
+
+AssetBytes PackFile::Read(const std::string &name) const {
+  AssetBytes bytes;
+  int index = Find(name);
+  if (!isOpen || index < 0)
+    return bytes;
+  const Pack::Entry &e = entries[index];
+
+#if defined(PLATFORM_WEB)
+  bytes.storage.resize(e.size);
+  if (FetchRange(path.c_str(), (double)e.offset, (int)e.size,
+                 bytes.storage.data()) != (int)e.size) {
+    TraceLog(LOG_WARNING, "PACK: [%s] Range read failed", name.c_str());
+    bytes.storage.clear();
+    return bytes;
+  }
+  bytes.data = bytes.storage.data();
+#else
+  bytes.data = mapped + e.offset;
+#endif
+  bytes.size = (size_t)e.size;
+  return bytes;
+}
+
+#if defined(PLATFORM_WEB)
+
+bool PackFile::MapFile() { return false; }
+void PackFile::UnmapFile() {}
+
+#elif defined(_WIN32)
+
+bool PackFile::MapFile() {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    return false;
+  }
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  fileHandle = file;
+  mappingHandle = mapping;
+  mapped = (const unsigned char *)view;
+  mappedSize = (size_t)size.QuadPart;
+  return true;
+}
+
+void PackFile::UnmapFile() {
+  if (mapped != nullptr)
+    UnmapViewOfFile(mapped);
+  if (mappingHandle != nullptr)
+    CloseHandle((HANDLE)mappingHandle);
+  if (fileHandle != nullptr)
+    CloseHandle((HANDLE)fileHandle);
+  mapped = nullptr;
+  mappedSize = 0;
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+}
+
+#else
+
+bool PackFile::MapFile() {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps the file referenced
+  if (view == MAP_FAILED)
+    return false;
+  mapped = (const unsigned char *)view;
+  mappedSize = (size_t)st.st_size;
+  return true;
+}
+
+void PackFile::UnmapFile() {
+  if (mapped != nullptr)
+    munmap((void *)mapped, mappedSize);
+  mapped = nullptr;
+  mappedSize = 0;
+}
+
+#endif
+
+namespace AssetFiles {
+
+static std::atomic<const PackFile *> mounted{nullptr};
+static AssetManifest manifest;
+static bool hasManifest = false;
+
+static std::string FileType(const char *path) {
+  const char *ext = GetFileExtension(path);
+  return ext != nullptr ? ext : "";
+}
+
+void Mount(const PackFile *pack) {
+  mounted = pack;
+  hasManifest = false;
+  manifest = AssetManifest();
+  if (pack == nullptr)
+    return;
+
+  std::string name = std::string("assets/") + AssetManifest::FILE_NAME;
+  AssetBytes bytes = pack->Read(name);
+  if (bytes.IsValid()) {
+    hasManifest = manifest.Parse((const char *)bytes.data, bytes.size);
+    if (hasManifest)
+      TraceLog(LOG_INFO, "PACK: Conditioned assets (%d files, %s alpha)",
+               (int)manifest.entries.size(),
+               manifest.premultipliedAlpha ? "premultiplied" : "straight");
+  }
+}
+
+bool IsPremultiplied() {
+  return mounted.load() != nullptr && hasManifest &&
+         manifest.premultipliedAlpha;
+}
+
+// Conditioned file for a source path (itself when not conditioned)
+static std::string Resolve(const char *path, int *mipLevel) {
+  const AssetManifest::Entry *entry =
+      hasManifest ? manifest.Find(path) : nullptr;
+  if (entry == nullptr) {
+    *mipLevel = 0;
+    return path;
+  }
+  *mipLevel = std::max(0, std::min(*mipLevel, entry->mipLevels - 1));
+  return AssetManifest::MipPath(entry->output, *mipLevel);
+}
+
+bool GetImageInfo(const char *path, int *width, int *height,
+                  int *mipLevels) {
+  const AssetManifest::Entry *entry =
+      mounted.load() != nullptr && hasManifest ? manifest.Find(path) : nullptr;
+  if (entry == nullptr || entry->kind != AssetManifest::Kind::IMAGE)
+    return false;
+  *width = entry->width;
+  *height = entry->height;
+  *mipLevels = entry->mipLevels;
+  return true;
+}
+
+bool Exists(const char *path) {
+  const PackFile *pack = mounted.load();
+  int level = 0;
+  if (pack != nullptr && pack->Contains(Resolve(path, &level)))
+    return true;
+  return FileExists(path);
+}
+
+AssetBytes Read(const char *path, int mipLevel) {
+  const PackFile *pack = mounted.load();
+  if (pack != nullptr) {
+    std::string resolved = Resolve(path, &mipLevel);
+    if (pack->Contains(resolved)) {
+      AssetBytes bytes = pack->Read(resolved);
+      bytes.fileType = FileType(resolved.c_str());
+      bytes.mipLevel = mipLevel;
+      return bytes;
+    }
+  }
+
+  // Loose file: read straight into the returned storage
+  AssetBytes bytes;
+  bytes.fileType = FileType(path);
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", path);
+    return bytes;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (size > 0) {
+    bytes.storage.resize((size_t)size);
+    if (fread(bytes.storage.data(), 1, (size_t)size, file) == (size_t)size) {
+      bytes.data = bytes.storage.data();
+      bytes.size = (size_t)size;
+    }
+  }
+  fclose(file);
+  return bytes;
+}
+
+} // namespace AssetFiles
@@ -0,0 +1,94 @@
+#pragma once
+#include "PackFormat.h"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Bytes of one asset file. Points into a mapped pack when possible (no
+// copy, valid while the pack stays open), otherwise owns them in 'storage'.
+// Move-only: 'data' may point into 'storage', which a move keeps in place
+// but a copy would not.
+struct AssetBytes {
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+  std::vector<unsigned char> storage;
+  std::string fileType; // Extension of the file actually read (".qoi"...)
+  int mipLevel = 0;     // Pre-scaled variant read (0 = full size)
+
+  AssetBytes() = default;
+  AssetBytes(AssetBytes &&) = default;
+  AssetBytes &operator=(AssetBytes &&) = default;
+  AssetBytes(const AssetBytes &) = delete;
+  AssetBytes &operator=(const AssetBytes &) = delete;
+
+  bool IsValid() const { return data != nullptr; }
+};
+
+// Read-only view of an asset pack (see PackFormat.h).
+//
+// Desktop: the whole file is memory-mapped at Open() and Read() returns
+// pointers into the mapping, so reads are thread-safe and copy nothing.
+// Web: Open() fetches the header and table of contents only; each Read()
+// fetches its blob with an HTTP range request, so the game starts without
+// downloading the whole archive.
+class PackFile {
+public:
+  PackFile();
+  ~PackFile();
+
+  bool Open(const char *path); // File path, or URL on web
+  void Close();
+  bool IsOpen() const { return isOpen; }
+
+  bool Contains(const std::string &name) const;
+  AssetBytes Read(const std::string &name) const;
+
+  int GetEntryCount() const { return (int)entries.size(); }
+  size_t GetMappedSize() const { return mappedSize; }
+
+private:
+  bool isOpen;
+  std::string path;
+  std::vector<Pack::Entry> entries;
+  std::vector<char> names;
+  std::unordered_multimap<uint32_t, int> lookup; // Entry hash -> index
+
+  // Native mapping
+  const unsigned char *mapped;
+  size_t mappedSize;
+#if defined(_WIN32)
+  void *fileHandle;
+  void *mappingHandle;
+#endif
+
+  bool ReadToc(const unsigned char *toc, const Pack::Header &header);
+  int Find(const std::string &name) const; // Entry index, -1 if absent
+  bool MapFile();
+  void UnmapFile();
+};
+
+// Where the loaders read asset files from: the mounted pack first, then the
+// file system (loose files, or the web build's preloaded folder).
+//
+// A pack built from conditioned assets carries the conditioner's manifest
+// (assets/manifest.txt): source paths are then redirected to the conditioned
+// files, so callers keep asking for "x.png" and get "x.qoi".
+namespace AssetFiles {
+
+// nullptr unmounts. Not thread-safe: mount before queueing loads.
+void Mount(const PackFile *pack);
+bool Exists(const char *path);
+
+// Reads the stored mip level closest to 'mipLevel' without going over it
+// (the full-size file when there are no variants): see bytes.mipLevel
+AssetBytes Read(const char *path, int mipLevel = 0);
+
+// Full-size dimensions and stored mip levels of a conditioned image. False
+// when the image is not conditioned (size unknown until decoded).
+bool GetImageInfo(const char *path, int *width, int *height, int *mipLevels);
+
+// Images from the mounted pack have premultiplied alpha
+bool IsPremultiplied();
+
+} // namespace AssetFiles
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layout of an asset pack (.pak), shared by the game and the packer
+// (tools/AssetPacker.cpp). Little-endian.
+//
+//   Header | Entry[entryCount] | names | padding | blob | padding | blob ...
+//
+// The table of contents (entries + names) sits right after the header, so a
+// reader can fetch it with one small read and then pull single blobs by
+// range. Blobs start on 'alignment' boundaries: mapped in place they can be
+// handed to decoders directly, with no copy.
+namespace Pack {
+
+constexpr char MAGIC[4] = {'R', 'P', 'A', 'K'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t DEFAULT_ALIGNMENT = 64;
+
+struct Header {
+  char magic[4];
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t alignment;
+  uint64_t tocSize;    // Bytes of entries + names, right after the header
+  uint64_t dataOffset; // First blob
+};
+
+struct Entry {
+  uint64_t offset;     // From the start of the file
+  uint64_t size;
+  uint32_t nameOffset; // Into the names block ('/' separated, not terminated)
+  uint32_t nameLength;
+  uint32_t hash;       // HashName() of the name
+  uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 32, "Pack::Header layout");
+static_assert(sizeof(Entry) == 32, "Pack::Entry layout");
+
+// FNV-1a. Readers index entries by it and compare names only on a match;
+// an entry whose name does not hash to its 'hash' marks a corrupt pack.
+inline uint32_t HashName(const char *name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char)name[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace Pack
@@ -0,0 +1,668 @@
+#include "Profiler.h"
+
+#if RENO_FLIGHT_RECORDER
+#include "Constants.h"
+#include "Render.h"
+#include "SpscQueue.h"
+#include "TraceWriter.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Profiler {
+
+std::atomic<bool> detail::enabled{false};
+
+namespace {
+
+enum class Kind : uint16_t { SCOPE, INSTANT, COUNTER };
+
+// One finished scope (or instant, counter), as a thread hands it to the
+// game thread
+struct Record {
+  uint64_t key;    // Scope and the scopes it is nested in (PathKey)
+  uint64_t parent; // Key of the enclosing scope, 0 at the top
+  int64_t start;
+  int64_t end;
+  const char *name; // Instants and counters
+  double value;     // Counters
+  ScopeId id;
+  uint16_t depth;
+  Kind kind;
+};
+
+// Room for a few frames of scopes per thread; more are dropped (counted)
+constexpr size_t BUFFER_RECORDS = 4096;
+constexpr int MAX_SCOPES = 1024;
+constexpr int NAME_LENGTH = 32;
+
+struct Buffer {
+  SpscQueue<Record, BUFFER_RECORDS> records;
+  std::atomic<bool> inUse{true}; // Cleared when its thread exits
+  std::atomic<int> dropped{0};
+  char name[NAME_LENGTH]; // Under registryMutex
+};
+
+std::mutex registryMutex;
+const char *names[MAX_SCOPES];
+std::atomic<uint32_t> nameCount{0};
+std::unique_ptr<Buffer> buffers[MAX_THREADS];
+std::atomic<int> bufferCount{0};
+
+// Scopes open on the calling thread
+struct ThreadState {
+  Buffer *buffer = nullptr;
+  bool claimed = false; // A buffer was asked for (may have failed)
+  char name[NAME_LENGTH] = "";
+  int depth = 0;
+  uint64_t keys[MAX_DEPTH];
+  int64_t starts[MAX_DEPTH];
+  ScopeId ids[MAX_DEPTH];
+
+  ~ThreadState() {
+    if (buffer != nullptr)
+      buffer->inUse.store(false, std::memory_order_release);
+  }
+};
+
+thread_local ThreadState local;
+
+uint64_t PathKey(uint64_t parent, ScopeId id) {
+  uint64_t x = (parent ^ ((uint64_t)id + 1)) * 0x9E3779B97F4A7C15ull;
+  x ^= x >> 32;
+  return x != 0 ? x : 1;
+}
+
+// A buffer for the calling thread: a free one left by a thread of the same
+// name (a restarted thread keeps its statistics), else a new one
+Buffer *Claim(ThreadState &t) {
+  t.claimed = true;
+  std::lock_guard<std::mutex> lock(registryMutex);
+  int count = bufferCount.load(std::memory_order_relaxed);
+  Buffer *found = nullptr;
+  for (int i = 0; i < count && found == nullptr; i++) {
+    Buffer *b = buffers[i].get();
+    if (!b->inUse.load(std::memory_order_acquire) &&
+        strcmp(b->name, t.name) == 0)
+      found = b;
+  }
+  if (found == nullptr && count < MAX_THREADS) {
+    buffers[count] = std::make_unique<Buffer>();
+    found = buffers[count].get();
+    bufferCount.store(count + 1, std::memory_order_release);
+  }
+  if (found == nullptr)
+    return nullptr;
+  found->inUse.store(true, std::memory_order_relaxed);
+  if (t.name[0] == '\0')
+    snprintf(t.name, sizeof(t.name), "Thread %d", count);
+  snprintf(found->name, sizeof(found->name), "%s", t.name);
+  return found;
+}
+
+// --- Game thread side ---
+
+struct Node {
+  uint64_t key;
+  uint64_t parent;
+  ScopeId id;
+  int depth;
+  int64_t frameTime; // This frame so far
+  int frameCalls;
+  float history[HISTORY_FRAMES]; // Ms per frame, by frame slot
+  int calls[HISTORY_FRAMES];
+};
+
+struct ThreadView {
+  char name[NAME_LENGTH];
+  std::vector<Node> nodes; // In the order first seen
+  std::unordered_map<uint64_t, int> index;
+};
+
+ThreadView views[MAX_THREADS];
+float frameTimes[HISTORY_FRAMES]; // Ms, by frame slot
+float frameOrdered[HISTORY_FRAMES];
+int frameIndex = 0;
+int64_t lastFrameEnd = 0;
+
+// Trace export: collected records go to the writer as well
+constexpr int TRACE_FLUSH_FRAMES = 30; // Hand-off to the writer thread
+TraceWriter trace;
+int64_t traceStart = 0;
+bool traceNamed[MAX_THREADS]; // Thread name written
+std::string traceNames[MAX_THREADS];
+
+// Track labels, written again when a thread is renamed
+void TraceThreadName(int thread) {
+  if (!traceNamed[thread] || traceNames[thread] != views[thread].name) {
+    traceNamed[thread] = true;
+    traceNames[thread] = views[thread].name;
+    trace.SetThreadName(thread, views[thread].name);
+  }
+}
+
+TraceWriter::Event ToEvent(int thread, const Record &r, int64_t origin) {
+  TraceWriter::Event e;
+  e.thread = thread;
+  e.time = r.start - origin;
+  e.duration = 0;
+  e.value = 0.0;
+  switch (r.kind) {
+  case Kind::SCOPE:
+    e.phase = 'X';
+    e.name = GetName(r.id);
+    e.duration = r.end - r.start;
+    break;
+  case Kind::INSTANT:
+    e.phase = 'i';
+    e.name = r.name;
+    break;
+  case Kind::COUNTER:
+    e.phase = 'C';
+    e.name = r.name;
+    e.value = r.value;
+    break;
+  }
+  return e;
+}
+
+void TraceRecord(int thread, const Record &r) {
+  if (r.start >= traceStart) // Not from before the trace started
+    trace.Add(ToEvent(thread, r, traceStart));
+}
+
+// --- Flight recorder: the last seconds of records and frames ---
+
+constexpr size_t RING_RECORDS = 32768;
+constexpr int RING_FRAMES = 1024;
+constexpr int FRAME_TRACK = MAX_THREADS; // Frame spans, below the threads
+
+struct RingRecord {
+  int thread;
+  Record record;
+};
+
+struct FrameSpan {
+  int64_t start;
+  int64_t end;
+  int index;
+};
+
+std::vector<RingRecord> ring; // Allocated when the recorder is turned on
+size_t ringNext = 0;          // Oldest once the ring is full
+FrameSpan frameRing[RING_FRAMES];
+
+float hitchBudgetMs = 0.0f;
+std::string hitchDirectory;
+HitchDescriber hitchDescribe;
+int hitchPending = -1; // Frames left to record after a hitch
+FrameSpan hitchFrame;
+HitchNotes hitchNotes;
+int64_t lastHitch = 0;
+int hitchCount = 0;
+
+// Joins the last dump, at exit too
+struct HitchThread {
+  std::thread thread;
+  ~HitchThread() {
+    if (thread.joinable())
+      thread.join();
+  }
+} hitchThread;
+
+void RingAdd(int thread, const Record &r) {
+  ring[ringNext] = {thread, r};
+  ringNext = (ringNext + 1) % RING_RECORDS;
+}
+
+// Copy the window around the hitch out of the rings and write it on a
+// background thread
+void DumpHitch() {
+  int64_t from = hitchFrame.start - (int64_t)(HITCH_WINDOW_SECONDS * 1e9f);
+  std::vector<TraceWriter::Event> events;
+  auto labels = std::make_shared<std::vector<std::string>>();
+  int count = bufferCount.load(std::memory_order_acquire);
+  labels->reserve(count + 1);
+  for (int i = 0; i < count; i++)
+    labels->push_back(views[i].name);
+  labels->push_back("Frames");
+  for (int i = 0; i <= count; i++)
+    events.push_back({'M', (*labels)[i].c_str(), i == count ? FRAME_TRACK : i,
+                      0, 0, 0.0});
+
+  for (const FrameSpan &f : frameRing) {
+    if (f.end != 0 && f.start >= from)
+      events.push_back({'X', f.index == hitchFrame.index ? "Hitch" : "Frame",
+                        FRAME_TRACK, f.start - from, f.end - f.start, 0.0});
+  }
+  for (size_t k = 0; k < RING_RECORDS; k++) {
+    const RingRecord &rr = ring[(ringNext + k) % RING_RECORDS];
+    if (rr.record.end != 0 && rr.record.start >= from)
+      events.push_back(ToEvent(rr.thread, rr.record, from));
+  }
+
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+  MakeDirectory(hitchDirectory.c_str());
+  char path[512];
+  snprintf(path, sizeof(path), "%s/hitch_%s_%d.json", hitchDirectory.c_str(),
+           stamp, hitchFrame.index);
+  TraceLog(LOG_INFO, "Profiler: %.1f ms frame, writing %s",
+           (double)(hitchFrame.end - hitchFrame.start) * 1e-6, path);
+
+  std::string file = path;
+  HitchNotes notes;
+  notes.swap(hitchNotes);
+  auto write = [file, labels, events = std::move(events),
+                notes = std::move(notes)] {
+    TraceWriter::WriteFile(file.c_str(), events, notes);
+  };
+#if defined(PLATFORM_WEB)
+  write();
+#else
+  if (hitchThread.thread.joinable())
+    hitchThread.thread.join();
+  hitchThread.thread = std::thread(write);
+#endif
+}
+
+// The frame that just ended, [start, end]: spot hitches, and write the one
+// pending once the frames after it are in
+void CheckHitch(int64_t start, int64_t end) {
+  frameRing[frameIndex % RING_FRAMES] = {start, end, frameIndex};
+  if (hitchPending > 0 && --hitchPending == 0) {
+    hitchPending = -1;
+    DumpHitch();
+  }
+  float ms = (float)((double)(end - start) * 1e-6);
+  if (hitchPending < 0 && ms > hitchBudgetMs &&
+      (lastHitch == 0 ||
+       end - lastHitch > (int64_t)(HITCH_COOLDOWN_SECONDS * 1e9f))) {
+    lastHitch = end;
+    hitchCount++;
+    hitchFrame = frameRing[frameIndex % RING_FRAMES];
+    hitchPending = HITCH_AFTER_FRAMES;
+
+    char value[64];
+    hitchNotes.clear();
+    snprintf(value, sizeof(value), "%.2f", ms);
+    hitchNotes.push_back({"frameMs", value});
+    snprintf(value, sizeof(value), "%.2f", hitchBudgetMs);
+    hitchNotes.push_back({"budgetMs", value});
+    snprintf(value, sizeof(value), "%d", frameIndex);
+    hitchNotes.push_back({"frame", value});
+    if (hitchDescribe)
+      hitchDescribe(hitchNotes);
+  }
+}
+
+Buffer *ThreadBuffer() {
+  ThreadState &t = local;
+  if (!t.claimed)
+    t.buffer = Claim(t);
+  return t.buffer;
+}
+
+void Emit(Kind kind, const char *name, double value) {
+  Buffer *buffer = ThreadBuffer();
+  if (buffer == nullptr)
+    return;
+  Record r = {};
+  r.start = r.end = Now();
+  r.name = name;
+  r.value = value;
+  r.depth = (uint16_t)std::min(local.depth, MAX_DEPTH);
+  r.kind = kind;
+  if (!buffer->records.Push(r))
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Collect(ThreadView &view, const Record &r) {
+  auto it = view.index.find(r.key);
+  int n;
+  if (it == view.index.end()) {
+    n = (int)view.nodes.size();
+    view.index.emplace(r.key, n);
+    view.nodes.push_back(Node());
+    Node &node = view.nodes.back();
+    node.key = r.key;
+    node.parent = r.parent;
+    node.id = r.id;
+    node.depth = (int)r.depth;
+    node.frameTime = 0;
+    node.frameCalls = 0;
+    std::fill(node.history, node.history + HISTORY_FRAMES, 0.0f);
+    std::fill(node.calls, node.calls + HISTORY_FRAMES, 0);
+  } else {
+    n = it->second;
+  }
+  Node &node = view.nodes[n];
+  node.frameTime += r.end - r.start;
+  node.frameCalls++;
+}
+
+void AddStats(const ThreadView &view, int n, std::vector<ScopeStats> &out) {
+  const Node &node = view.nodes[n];
+  float samples[HISTORY_FRAMES];
+  int count = 0, calls = 0;
+  float sum = 0.0f, peak = 0.0f;
+  for (int i = 0; i < HISTORY_FRAMES; i++) {
+    if (node.calls[i] == 0)
+      continue;
+    samples[count++] = node.history[i];
+    sum += node.history[i];
+    peak = std::max(peak, node.history[i]);
+    calls += node.calls[i];
+  }
+  if (count == 0)
+    return; // Not run in the window
+
+  ScopeStats s;
+  s.name = GetName(node.id);
+  s.thread = view.name;
+  s.depth = node.depth;
+  s.meanMs = sum / (float)count;
+  int rank = std::min(count - 1, (count * 95) / 100);
+  std::nth_element(samples, samples + rank, samples + count);
+  s.p95Ms = samples[rank];
+  s.maxMs = peak;
+  s.callsPerFrame = (float)calls / (float)count;
+  s.history.resize(HISTORY_FRAMES);
+  for (int i = 0; i < HISTORY_FRAMES; i++)
+    s.history[i] = node.history[(frameIndex + i) % HISTORY_FRAMES];
+  out.push_back(std::move(s));
+}
+
+} // namespace
+
+ScopeId Register(const char *name) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  uint32_t count = nameCount.load(std::memory_order_relaxed);
+  // Sites with the same name share statistics
+  for (uint32_t i = 0; i < count; i++)
+    if (strcmp(names[i], name) == 0)
+      return i;
+  if (count == MAX_SCOPES)
+    return MAX_SCOPES - 1;
+  names[count] = name;
+  nameCount.store(count + 1, std::memory_order_release);
+  return count;
+}
+
+const char *GetName(ScopeId id) {
+  return id < nameCount.load(std::memory_order_acquire) ? names[id] : "?";
+}
+
+void SetEnabled(bool enabled) {
+  detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SetThreadName(const char *name) {
+  snprintf(local.name, sizeof(local.name), "%s", name);
+  if (local.buffer != nullptr) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    snprintf(local.buffer->name, sizeof(local.buffer->name), "%s", name);
+  }
+}
+
+int64_t Now() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Scope::Begin(ScopeId id) {
+  ThreadState &t = local;
+  if (t.depth < MAX_DEPTH) {
+    uint64_t parent = t.depth > 0 ? t.keys[t.depth - 1] : 0;
+    t.keys[t.depth] = PathKey(parent, id);
+    t.ids[t.depth] = id;
+    t.starts[t.depth] = Now();
+  }
+  t.depth++;
+}
+
+void Scope::End() {
+  ThreadState &t = local;
+  t.depth--;
+  if (t.depth >= MAX_DEPTH || t.depth < 0)
+    return;
+  if (ThreadBuffer() == nullptr)
+    return;
+
+  Record r = {};
+  r.key = t.keys[t.depth];
+  r.parent = t.depth > 0 ? t.keys[t.depth - 1] : 0;
+  r.start = t.starts[t.depth];
+  r.end = Now();
+  r.id = t.ids[t.depth];
+  r.depth = (uint16_t)t.depth;
+  r.kind = Kind::SCOPE;
+  if (!t.buffer->records.Push(r))
+    t.buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Instant(const char *name) {
+  if (IsEnabled())
+    Emit(Kind::INSTANT, name, 0.0);
+}
+
+void Counter(const char *name, double value) {
+  if (IsEnabled())
+    Emit(Kind::COUNTER, name, value);
+}
+
+void EndFrame() {
+  int64_t now = Now();
+  int64_t frameStart = lastFrameEnd;
+  int slot = frameIndex % HISTORY_FRAMES;
+  frameTimes[slot] =
+      lastFrameEnd != 0 ? (float)((double)(now - lastFrameEnd) * 1e-6) : 0.0f;
+  lastFrameEnd = now;
+  bool recording = hitchBudgetMs > 0.0f;
+
+  int count = bufferCount.load(std::memory_order_acquire);
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (int i = 0; i < count; i++)
+      memcpy(views[i].name, buffers[i]->name, NAME_LENGTH);
+  }
+  for (int i = 0; i < count; i++) {
+    // What is there now: a busy thread must not keep this loop going
+    Record r;
+    bool tracing = trace.IsRecording();
+    if (tracing)
+      TraceThreadName(i);
+    for (size_t k = 0; k < BUFFER_RECORDS && buffers[i]->records.Pop(r);
+         k++) {
+      if (r.kind == Kind::SCOPE)
+        Collect(views[i], r);
+      if (tracing)
+        TraceRecord(i, r);
+      if (recording)
+        RingAdd(i, r);
+    }
+    for (Node &node : views[i].nodes) {
+      node.history[slot] = (float)((double)node.frameTime * 1e-6);
+      node.calls[slot] = node.frameCalls;
+      node.frameTime = 0;
+      node.frameCalls = 0;
+    }
+  }
+  if (recording && frameStart != 0)
+    CheckHitch(frameStart, now);
+  frameIndex++;
+  if (frameIndex % TRACE_FLUSH_FRAMES == 0)
+    trace.Flush();
+}
+
+void GetStats(std::vector<ScopeStats> &out) {
+  out.clear();
+  int count = bufferCount.load(std::memory_order_acquire);
+  for (int t = 0; t < count; t++) {
+    const ThreadView &view = views[t];
+    // Children in the order first seen; scopes whose parent has not been
+    // seen yet (still open) are listed at the top
+    std::vector<std::vector<int>> children(view.nodes.size());
+    std::vector<int> roots;
+    for (int n = 0; n < (int)view.nodes.size(); n++) {
+      auto it = view.index.find(view.nodes[n].parent);
+      if (view.nodes[n].parent != 0 && it != view.index.end())
+        children[it->second].push_back(n);
+      else
+        roots.push_back(n);
+    }
+    std::vector<int> stack(roots.rbegin(), roots.rend());
+    while (!stack.empty()) {
+      int n = stack.back();
+      stack.pop_back();
+      AddStats(view, n, out);
+      stack.insert(stack.end(), children[n].rbegin(), children[n].rend());
+    }
+  }
+}
+
+const float *GetFrameHistory(int &count) {
+  for (int i = 0; i < HISTORY_FRAMES; i++)
+    frameOrdered[i] = frameTimes[(frameIndex + i) % HISTORY_FRAMES];
+  count = HISTORY_FRAMES;
+  return frameOrdered;
+}
+
+int GetDroppedScopes() {
+  int total = 0;
+  int count = bufferCount.load(std::memory_order_acquire);
+  for (int i = 0; i < count; i++)
+    total += buffers[i]->dropped.load(std::memory_order_relaxed);
+  return total;
+}
+
+void DrawOverlay(int posX, int posY) {
+  const int width = 560;
+  const int lineH = 14;
+  const int graphX = posX + 410; // Per-scope graphs
+  const float budgetMs = 1000.0f / 60.0f;
+
+  static std::vector<ScopeStats> stats; // Kept to reuse its storage
+  GetStats(stats);
+  int historyCount;
+  const float *frames = GetFrameHistory(historyCount);
+
+  // Rows that fit above the other debug overlays (bottom of the screen)
+  int maxRows = std::max(1, (Core::SCREEN_HEIGHT - 130 - posY - 64) / lineH);
+  int rows = 0;
+  const char *lastThread = nullptr;
+  for (const ScopeStats &s : stats) {
+    rows += s.thread != lastThread ? 2 : 1;
+    lastThread = s.thread;
+  }
+  rows = std::min(rows, maxRows);
+  ::DrawRectangle(posX - 6, posY - 6, width, 64 + rows * lineH + 6,
+                  Render::BlendColor(Fade(BLACK, 0.7f)));
+
+  // Frame times, with the 60 fps budget
+  float frameSum = 0.0f, framePeak = 0.0f;
+  int frameCount = 0;
+  for (int i = 0; i < historyCount; i++) {
+    if (frames[i] <= 0.0f)
+      continue;
+    frameSum += frames[i];
+    framePeak = std::max(framePeak, frames[i]);
+    frameCount++;
+  }
+  char line[128];
+  snprintf(line, sizeof(line), "frame  mean %.2f  max %.2f ms  dropped %d",
+           frameCount > 0 ? frameSum / (float)frameCount : 0.0f, framePeak,
+           GetDroppedScopes());
+  ::DrawText(line, posX, posY, 10, LIME);
+  const int frameGraphH = 40;
+  int baseY = posY + 14 + frameGraphH;
+  float scale = (float)frameGraphH / (budgetMs * 2.0f); // Budget at half
+  for (int i = 0; i < historyCount; i++) {
+    int h = std::min(frameGraphH, (int)(frames[i] * scale));
+    Color c = frames[i] > budgetMs ? RED : LIME;
+    ::DrawRectangle(posX + i * 4, baseY - h, 3, h, c);
+  }
+  int budgetY = baseY - (int)(budgetMs * scale);
+  ::DrawLine(posX, budgetY, posX + historyCount * 4, budgetY, YELLOW);
+
+  // Scope table: name, mean / p95 / max in ms, calls, graph of the window
+  int y = posY + 64;
+  int row = 0;
+  lastThread = nullptr;
+  for (const ScopeStats &s : stats) {
+    if (s.thread != lastThread) {
+      if (row + 2 > rows)
+        break;
+      lastThread = s.thread;
+      ::DrawText(s.thread, posX, y, 10, YELLOW);
+      ::DrawText("mean    p95    max  calls", posX + 230, y, 10, GRAY);
+      y += lineH;
+      row++;
+    }
+    if (row + 1 > rows)
+      break;
+    ::DrawText(s.name, posX + 8 + s.depth * 10, y, 10, RAYWHITE);
+    snprintf(line, sizeof(line), "%5.2f  %5.2f  %5.2f  %5.1f", s.meanMs,
+             s.p95Ms, s.maxMs, s.callsPerFrame);
+    ::DrawText(line, posX + 230, y, 10, LIME);
+
+    float peak = std::max(s.maxMs, 0.001f);
+    for (int i = 0; i < (int)s.history.size(); i++) {
+      int h = (int)(s.history[i] / peak * (float)(lineH - 3));
+      if (h > 0)
+        ::DrawLine(graphX + i, y + lineH - 2, graphX + i, y + lineH - 2 - h,
+                   SKYBLUE);
+    }
+    y += lineH;
+    row++;
+  }
+}
+
+bool StartTrace(const char *baseDir) {
+  if (trace.IsRecording())
+    return true;
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+  MakeDirectory(baseDir);
+  std::string path = std::string(baseDir) + "/trace_" + stamp + ".json";
+  if (!trace.Start(path.c_str()))
+    return false;
+  traceStart = Now();
+  for (int i = 0; i < MAX_THREADS; i++)
+    traceNamed[i] = false;
+  return true;
+}
+
+void StopTrace() { trace.Stop(); }
+
+void SetHitchBudget(float budgetMs, const char *directory) {
+  hitchBudgetMs = budgetMs;
+  hitchDirectory = directory;
+  if (budgetMs > 0.0f && ring.empty())
+    ring.resize(RING_RECORDS, RingRecord{0, Record()});
+}
+
+void SetHitchDescriber(HitchDescriber describe) {
+  hitchDescribe = std::move(describe);
+}
+
+int GetHitchCount() { return hitchCount; }
+
+bool IsTracing() { return trace.IsRecording(); }
+
+int GetTraceEventCount() { return trace.GetEventCount(); }
+
+} // namespace Profiler
+
+#endif
@@ -0,0 +1,196 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Scoped, hierarchical frame profiler.
+//
+//   void World::UpdateSunRays() {
+//     PROFILE_SCOPE("World::UpdateSunRays");
+//     ...
+//   }
+//
+// A scope records its start and end into a buffer owned by the thread it
+// runs on (lock-free, no allocation), nested under the scopes open on that
+// thread when it starts. Once per frame the game thread collects every
+// buffer (EndFrame) and keeps a rolling history per scope, shown as mean,
+// p95 and max with a graph by DrawOverlay (debug mode).
+//
+// Instants (level loads, deaths...) and counters (entities, draws...) go
+// through the same buffers. While a trace is recorded (StartTrace), all of
+// it is also written as Chrome trace events for offline viewing.
+//
+// The last few seconds are always kept as well: a frame over the hitch
+// budget writes them to a trace file of their own, with the game's state
+// (flight recorder).
+//
+// Two switches select what is compiled:
+// - RENO_FLIGHT_RECORDER (on by default, release builds included): the
+//   buffers, frame times, instants, counters, traces and hitch dumps, so
+//   long release sessions still leave a file behind when they hitch.
+// - RENO_PROFILE (on unless NDEBUG): the PROFILE_SCOPE markers, so release
+//   builds contain no scopes at all; their hitch files then show frames,
+//   instants and counters only. Needs the recorder.
+// Define either to 0 or 1 to override (the headless targets build with both
+// off). When compiled in, scopes still cost a single load until
+// SetEnabled(true).
+#if !defined(RENO_FLIGHT_RECORDER)
+#define RENO_FLIGHT_RECORDER 1
+#endif
+#if !defined(RENO_PROFILE)
+#if defined(NDEBUG)
+#define RENO_PROFILE 0
+#else
+#define RENO_PROFILE 1
+#endif
+#endif
+#if RENO_PROFILE && !RENO_FLIGHT_RECORDER
+#error "RENO_PROFILE records into the flight recorder: enable it too"
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+namespace Profiler {
+// Key/value pairs describing the game, stored with a hitch
+using HitchNotes = std::vector<std::pair<std::string, std::string>>;
+using HitchDescriber = std::function<void(HitchNotes &notes)>;
+} // namespace Profiler
+
+#if RENO_PROFILE
+// 'name' must be a string literal (kept by pointer)
+#define PROFILE_SCOPE(name)                                                    \
+  static const ::Profiler::ScopeId PROFILE_CONCAT(profileId, __LINE__) =       \
+      ::Profiler::Register(name);                                              \
+  ::Profiler::Scope PROFILE_CONCAT(profileScope,                               \
+                                   __LINE__)(PROFILE_CONCAT(profileId,         \
+                                                            __LINE__))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#if RENO_FLIGHT_RECORDER
+
+namespace Profiler {
+
+using ScopeId = uint32_t;
+
+constexpr int HISTORY_FRAMES = 120; // Rolling window of the statistics
+constexpr int MAX_DEPTH = 32;       // Deeper scopes are not recorded
+constexpr int MAX_THREADS = 32;     // Threads past this are not recorded
+
+ScopeId Register(const char *name); // Once per PROFILE_SCOPE site
+const char *GetName(ScopeId id);
+
+void SetEnabled(bool enabled);
+inline bool IsEnabled();
+
+// Label for the calling thread's buffer (overlay); copied
+void SetThreadName(const char *name);
+
+// Time on the profiler clock, in nanoseconds
+int64_t Now();
+
+// A moment and a sampled value, on the calling thread's track. 'name' must
+// be a string literal (kept by pointer).
+void Instant(const char *name);
+void Counter(const char *name, double value);
+
+class Scope {
+public:
+  explicit Scope(ScopeId id) {
+    active = IsEnabled();
+    if (active)
+      Begin(id);
+  }
+  ~Scope() {
+    if (active)
+      End();
+  }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  bool active;
+  static void Begin(ScopeId id);
+  static void End();
+};
+
+// Collect the scopes every thread finished since the last call into the
+// statistics. Game thread, once per frame.
+void EndFrame();
+
+// Rolling statistics of one scope, over the frames it ran in. Times are
+// per frame: a scope run several times in a frame counts their sum.
+struct ScopeStats {
+  const char *name;
+  const char *thread;
+  int depth; // 0 = outermost on its thread
+  float meanMs;
+  float p95Ms;
+  float maxMs;
+  float callsPerFrame;
+  std::vector<float> history; // Ms per frame, oldest first (0 = did not run)
+};
+
+// Every scope seen in the window, thread by thread, depth first
+void GetStats(std::vector<ScopeStats> &out);
+const float *GetFrameHistory(int &count); // Frame times in ms, oldest first
+int GetDroppedScopes(); // Lost to full buffers, since the start
+
+// Scope table with graphs (game thread, inside BeginDrawing)
+void DrawOverlay(int posX, int posY);
+
+// Record everything collected from now on to a new trace file,
+// <baseDir>/trace_YYYYMMDD_HHMMSS.json (written on a background thread)
+bool StartTrace(const char *baseDir);
+void StopTrace();
+bool IsTracing();
+int GetTraceEventCount();
+
+// --- Flight recorder ---
+constexpr float HITCH_WINDOW_SECONDS = 3.0f;   // Kept before a hitch
+constexpr int HITCH_AFTER_FRAMES = 10;         // And after it
+constexpr float HITCH_COOLDOWN_SECONDS = 5.0f; // Between two dumps
+
+// A frame longer than 'budgetMs' (0 = off) writes the window around it to
+// <directory>/hitch_YYYYMMDD_HHMMSS_<frame>.json, on a background thread.
+// 'describe' adds the game's state, called on the game thread right after
+// the slow frame.
+void SetHitchBudget(float budgetMs, const char *directory = "hitches");
+void SetHitchDescriber(HitchDescriber describe);
+int GetHitchCount(); // Dumps started so far
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}
+
+inline bool IsEnabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+} // namespace Profiler
+
+#else
+
+namespace Profiler {
+inline void SetEnabled(bool) {}
+inline bool IsEnabled() { return false; }
+inline void SetThreadName(const char *) {}
+inline void Instant(const char *) {}
+inline void Counter(const char *, double) {}
+inline void EndFrame() {}
+inline void DrawOverlay(int, int) {}
+inline bool StartTrace(const char *) { return false; }
+inline void StopTrace() {}
+inline bool IsTracing() { return false; }
+inline int GetTraceEventCount() { return 0; }
+inline void SetHitchBudget(float, const char * = "hitches") {}
+inline void SetHitchDescriber(HitchDescriber) {}
+inline int GetHitchCount() { return 0; }
+} // namespace Profiler
+
+#endif
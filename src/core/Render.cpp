@@ -0,0 +1,172 @@
+#include "Render.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace Render {
+
+static FrameStats current = {};
+static FrameStats last = {};
+static unsigned int lastTextureId = 0;
+static bool premultipliedAlpha = false;
+
+// Area of a rectangle clipped to the screen
+static float ClippedArea(float x, float y, float w, float h) {
+  if (w < 0) {
+    x += w;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h;
+    h = -h;
+  }
+  float x0 = std::max(x, 0.0f);
+  float y0 = std::max(y, 0.0f);
+  float x1 = std::min(x + w, (float)Core::SCREEN_WIDTH);
+  float y1 = std::min(y + h, (float)Core::SCREEN_HEIGHT);
+  if (x1 <= x0 || y1 <= y0)
+    return 0.0f;
+  return (x1 - x0) * (y1 - y0);
+}
+
+void BeginFrame() {
+  current = {};
+  lastTextureId = 0;
+  if (premultipliedAlpha)
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+}
+
+void EndFrame() {
+  if (premultipliedAlpha)
+    EndBlendMode();
+  current.batches = current.textureSwitches + current.stateChanges + 1;
+  float screenArea = (float)Core::SCREEN_WIDTH * (float)Core::SCREEN_HEIGHT;
+  current.overdraw = screenArea > 0 ? current.coveredArea / screenArea : 0.0f;
+  last = current;
+}
+
+void SetPremultipliedAlpha(bool enabled) { premultipliedAlpha = enabled; }
+bool IsPremultipliedAlpha() { return premultipliedAlpha; }
+
+Color BlendColor(Color color) {
+  if (!premultipliedAlpha || color.a == 255)
+    return color;
+  return {(unsigned char)(color.r * color.a / 255),
+          (unsigned char)(color.g * color.a / 255),
+          (unsigned char)(color.b * color.a / 255), color.a};
+}
+
+const FrameStats &GetLastFrameStats() { return last; }
+const FrameStats &GetCurrentFrameStats() { return current; }
+
+void RecordDraw(unsigned int textureId, int vertexCount, float area) {
+  current.draws++;
+  if (textureId != lastTextureId) {
+    if (lastTextureId != 0)
+      current.textureSwitches++;
+    lastTextureId = textureId;
+  }
+  current.vertices += vertexCount;
+  current.quads += (vertexCount + 3) / 4;
+  current.coveredArea += area;
+}
+
+void RecordStateChange() { current.stateChanges++; }
+
+// Shapes are drawn with raylib's shapes texture (a white patch of the
+// default font's texture), so they batch with text
+static void RecordShape(int vertexCount, float area) {
+  RecordDraw(GetShapesTexture().id, vertexCount, area);
+}
+
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest,
+                    Vector2 origin, float rotation, Color tint) {
+  ::DrawTexturePro(texture, source, dest, origin, rotation,
+                   BlendColor(tint));
+  RecordDraw(texture.id, 4,
+             ClippedArea(dest.x - origin.x, dest.y - origin.y, dest.width,
+                         dest.height));
+}
+
+void DrawRectangle(int posX, int posY, int width, int height, Color color) {
+  ::DrawRectangle(posX, posY, width, height, BlendColor(color));
+  RecordShape(4, ClippedArea((float)posX, (float)posY, (float)width,
+                             (float)height));
+}
+
+void DrawRectangleV(Vector2 position, Vector2 size, Color color) {
+  ::DrawRectangleV(position, size, BlendColor(color));
+  RecordShape(4, ClippedArea(position.x, position.y, size.x, size.y));
+}
+
+void DrawRectangleRec(Rectangle rec, Color color) {
+  ::DrawRectangleRec(rec, BlendColor(color));
+  RecordShape(4, ClippedArea(rec.x, rec.y, rec.width, rec.height));
+}
+
+void DrawRectangleLines(int posX, int posY, int width, int height,
+                        Color color) {
+  ::DrawRectangleLines(posX, posY, width, height, BlendColor(color));
+  RecordShape(8, 2.0f * (width + height));
+}
+
+void DrawRectangleLinesEx(Rectangle rec, float lineThick, Color color) {
+  ::DrawRectangleLinesEx(rec, lineThick, BlendColor(color));
+  RecordShape(16, 2.0f * (rec.width + rec.height) * lineThick);
+}
+
+void DrawCircleV(Vector2 center, float radius, Color color) {
+  ::DrawCircleV(center, radius, BlendColor(color));
+  // raylib tessellates circles into 36 segments (3 vertices each)
+  RecordShape(36 * 3, ClippedArea(center.x - radius, center.y - radius,
+                                  radius * 2, radius * 2) *
+                          0.785f);
+}
+
+void DrawLineV(Vector2 startPos, Vector2 endPos, Color color) {
+  ::DrawLineV(startPos, endPos, BlendColor(color));
+  float dx = endPos.x - startPos.x;
+  float dy = endPos.y - startPos.y;
+  RecordShape(2, std::max(std::fabs(dx), std::fabs(dy)));
+}
+
+void DrawText(const char *text, int posX, int posY, int fontSize,
+              Color color) {
+  ::DrawText(text, posX, posY, fontSize, BlendColor(color));
+
+  int glyphs = 0;
+  for (const char *c = text; *c != '\0'; c++) {
+    if (*c != ' ' && *c != '\n' && *c != '\t')
+      glyphs++;
+  }
+  current.textGlyphs += glyphs;
+
+  // One textured quad per visible glyph from the font atlas
+  unsigned int fontTex = GetFontDefault().texture.id;
+  RecordDraw(fontTex, glyphs * 4,
+             ClippedArea((float)posX, (float)posY,
+                         (float)MeasureText(text, fontSize), (float)fontSize));
+}
+
+void DrawStatsOverlay(int posX, int posY) {
+  const FrameStats &s = last;
+  char lines[6][64];
+  snprintf(lines[0], sizeof(lines[0]), "draws: %d  batches~: %d", s.draws,
+           s.batches);
+  snprintf(lines[1], sizeof(lines[1]), "tex switches: %d  state: %d",
+           s.textureSwitches, s.stateChanges);
+  snprintf(lines[2], sizeof(lines[2]), "quads: %d  verts: %d", s.quads,
+           s.vertices);
+  snprintf(lines[3], sizeof(lines[3]), "glyphs: %d", s.textGlyphs);
+  snprintf(lines[4], sizeof(lines[4]), "overdraw: %.2fx screen", s.overdraw);
+  snprintf(lines[5], sizeof(lines[5]), "fps: %d", GetFPS());
+
+  int lineH = 16;
+  ::DrawRectangle(posX - 6, posY - 6, 250, lineH * 6 + 10,
+                  BlendColor(Fade(BLACK, 0.6f)));
+  for (int i = 0; i < 6; i++)
+    ::DrawText(lines[i], posX, posY + i * lineH, 14, LIME);
+}
+
+} // namespace Render
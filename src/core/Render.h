@@ -0,0 +1,59 @@
+#pragma once
+#include "raylib.h"
+
+// Thin instrumentation layer over the raylib draw calls the game uses.
+//
+// Each wrapper forwards to raylib and records what it submitted, so a frame's
+// cost (draws, texture switches, quads, covered area) can be read on screen
+// (debug mode) or through GetLastFrameStats() from automated benchmarks.
+namespace Render {
+
+struct FrameStats {
+  int draws;           // Wrapped draw calls issued
+  int textureSwitches; // Bound texture changed between consecutive draws
+  int stateChanges;    // Shader/blend mode changes (each forces a flush)
+  int batches;         // Estimated GPU draw calls: switches + state changes + 1
+  int quads;           // Quads submitted (triangles count as half a quad)
+  int vertices;        // Vertices submitted
+  int textGlyphs;      // Glyph quads from DrawText
+  float coveredArea;   // Sum of on-screen pixel areas (clipped to the screen)
+  float overdraw;      // coveredArea / screen area (1.0 = one full screen)
+};
+
+// Frame boundaries: call right after BeginDrawing / right before EndDrawing
+void BeginFrame();
+void EndFrame();
+
+// Textures hold premultiplied alpha (conditioned assets): frames then blend
+// with BLEND_ALPHA_PREMULTIPLY and the wrappers premultiply their colours
+void SetPremultipliedAlpha(bool enabled);
+bool IsPremultipliedAlpha();
+
+// A tint/shape colour as it must be submitted under the current blend mode
+Color BlendColor(Color color);
+
+// Stats of the last completed frame, and of the frame being recorded
+const FrameStats &GetLastFrameStats();
+const FrameStats &GetCurrentFrameStats();
+
+// Low level hooks for code that submits geometry itself (rlgl)
+void RecordDraw(unsigned int textureId, int vertexCount, float area);
+void RecordStateChange();
+
+// Wrapped raylib draw calls (same signatures)
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest,
+                    Vector2 origin, float rotation, Color tint);
+void DrawRectangle(int posX, int posY, int width, int height, Color color);
+void DrawRectangleV(Vector2 position, Vector2 size, Color color);
+void DrawRectangleRec(Rectangle rec, Color color);
+void DrawRectangleLines(int posX, int posY, int width, int height,
+                        Color color);
+void DrawRectangleLinesEx(Rectangle rec, float lineThick, Color color);
+void DrawCircleV(Vector2 center, float radius, Color color);
+void DrawLineV(Vector2 startPos, Vector2 endPos, Color color);
+void DrawText(const char *text, int posX, int posY, int fontSize, Color color);
+
+// Panel with the last frame's stats (drawn unrecorded)
+void DrawStatsOverlay(int posX, int posY);
+
+} // namespace Render
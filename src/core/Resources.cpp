@@ -0,0 +1,642 @@
+#include "Resources.h"
+#include "AssetLoader.h"
+#include "AssetManifest.h"
+#include "ColorGrade.h"
+#include "PackFile.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Resources {
+
+namespace {
+
+template <typename Payload> struct Slot {
+  std::string key;
+  unsigned int generation = 0;
+  int refs = 0;
+  bool ready = false;
+  size_t bytes = 0;
+  unsigned long lastUsed = 0; // Release clock when refs dropped to 0
+  std::vector<ReadyCallback> waiting;
+  Payload data;
+};
+
+// Slots are reused through a free list; a reused slot gets a new generation
+// so handles to its previous occupant stop resolving
+template <typename Payload> struct Pool {
+  std::vector<Slot<Payload>> slots;
+  std::vector<unsigned int> freeSlots;
+  std::unordered_map<std::string, unsigned int> lookup;
+
+  Slot<Payload> *Find(unsigned int index, unsigned int generation) {
+    if (generation == 0 || index >= slots.size())
+      return nullptr;
+    Slot<Payload> &slot = slots[index];
+    return slot.generation == generation ? &slot : nullptr;
+  }
+
+  unsigned int Allocate(const std::string &key) {
+    unsigned int index;
+    if (!freeSlots.empty()) {
+      index = freeSlots.back();
+      freeSlots.pop_back();
+    } else {
+      index = (unsigned int)slots.size();
+      slots.emplace_back();
+    }
+    Slot<Payload> &slot = slots[index];
+    slot.key = key;
+    if (++slot.generation == 0)
+      slot.generation = 1;
+    lookup[key] = index;
+    return index;
+  }
+
+  void Free(unsigned int index) {
+    Slot<Payload> &slot = slots[index];
+    lookup.erase(slot.key);
+    unsigned int generation = slot.generation;
+    slot = Slot<Payload>();
+    slot.generation = generation; // Bumped again on reuse
+    freeSlots.push_back(index);
+  }
+};
+
+struct TextureData {
+  Texture2D texture = {0};
+  Texture2D night = {0};
+  SpriteMesh mesh;
+  bool hasMesh = false;
+
+  // What it was loaded from, to reload it at another mip level
+  std::string path;
+  TextureOptions options;
+  int sourceWidth = 0; // Full-size image
+  int sourceHeight = 0;
+  int mipLevel = 0;
+  int pendingLevel = -1; // Level being swapped in, -1 = none
+};
+
+// Pixel size a texture must cover (INT_MAX before a render size is set)
+struct MipTarget {
+  int width;
+  int height;
+};
+
+struct SoundData {
+  Sound sound = {0};
+};
+
+AssetLoader *loader = nullptr;
+const ColorGrade *grade = nullptr;
+size_t unusedBudget = DEFAULT_UNUSED_BUDGET;
+Pool<TextureData> textures;
+Pool<SoundData> sounds;
+unsigned long releaseClock = 0;
+int renderWidth = 0;
+int renderHeight = 0;
+int hits = 0;
+int misses = 0;
+int evictions = 0;
+
+const Texture2D emptyTexture = {0};
+const Sound emptySound = {0};
+
+void UnloadEntry(Slot<TextureData> &slot) {
+  if (slot.data.texture.id != 0)
+    UnloadTexture(slot.data.texture);
+  if (slot.data.night.id != 0)
+    UnloadTexture(slot.data.night);
+  slot.data.texture = {0};
+  slot.data.night = {0};
+}
+
+void UnloadEntry(Slot<SoundData> &slot) {
+  if (slot.data.sound.stream.buffer != nullptr)
+    UnloadSound(slot.data.sound);
+}
+
+template <typename Payload> void MarkReady(Slot<Payload> &slot) {
+  slot.ready = true;
+  // Callbacks may acquire more assets (and grow the pool): detach them first
+  std::vector<ReadyCallback> waiting = std::move(slot.waiting);
+  slot.waiting.clear();
+  for (auto &callback : waiting)
+    callback();
+}
+
+template <typename Payload> size_t UnusedBytes(const Pool<Payload> &pool) {
+  size_t total = 0;
+  for (const auto &slot : pool.slots) {
+    if (slot.generation != 0 && !slot.key.empty() && slot.ready &&
+        slot.refs == 0)
+      total += slot.bytes;
+  }
+  return total;
+}
+
+// Oldest unused ready entry of a pool, or -1
+template <typename Payload> int OldestUnused(const Pool<Payload> &pool) {
+  int oldest = -1;
+  for (size_t i = 0; i < pool.slots.size(); i++) {
+    const auto &slot = pool.slots[i];
+    if (slot.key.empty() || !slot.ready || slot.refs > 0)
+      continue;
+    if (oldest < 0 || slot.lastUsed < pool.slots[oldest].lastUsed)
+      oldest = (int)i;
+  }
+  return oldest;
+}
+
+template <typename Payload> void Evict(Pool<Payload> &pool, int index) {
+  TraceLog(LOG_DEBUG, "RESOURCES: Evicting '%s'", pool.slots[index].key.c_str());
+  UnloadEntry(pool.slots[index]);
+  pool.Free((unsigned int)index);
+  evictions++;
+}
+
+// Evict unused entries, oldest first, until they fit the budget
+void Trim() {
+  while (UnusedBytes(textures) + UnusedBytes(sounds) > unusedBudget) {
+    int tex = OldestUnused(textures);
+    int snd = OldestUnused(sounds);
+    if (tex < 0 && snd < 0)
+      return;
+    if (snd < 0 ||
+        (tex >= 0 && textures.slots[tex].lastUsed <= sounds.slots[snd].lastUsed))
+      Evict(textures, tex);
+    else
+      Evict(sounds, snd);
+  }
+}
+
+template <typename Payload> void Unreference(Slot<Payload> *slot) {
+  if (slot == nullptr || slot->refs <= 0)
+    return;
+  if (--slot->refs == 0) {
+    slot->lastUsed = ++releaseClock;
+    if (slot->ready)
+      Trim();
+  }
+}
+
+std::string TextureKey(const char *path, const TextureOptions &options) {
+  std::string key = path;
+  if (options.buildMesh || options.frameCount != 1) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "#mesh%d:%d",
+             options.buildMesh ? (int)options.meshMode : -1,
+             options.frameCount);
+    key += suffix;
+  }
+  if (options.night)
+    key += "#night";
+  if (options.displayHeight > 0.0f) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "#size%.3f:%.3f", options.displayHeight,
+             options.displayWidth);
+    key += suffix;
+  }
+  return key;
+}
+
+MipTarget TargetFor(const TextureOptions &options) {
+  if (renderWidth <= 0 || renderHeight <= 0)
+    return {INT_MAX, INT_MAX};
+  if (options.displayHeight <= 0.0f)
+    return {renderWidth, renderHeight};
+  return {(int)std::ceil(options.displayWidth * renderHeight),
+          (int)std::ceil(options.displayHeight * renderHeight)};
+}
+
+// Smallest level (each one half the size of the previous) whose frames still
+// cover the target
+int ChooseMipLevel(int width, int height, int frameCount, MipTarget target) {
+  int level = 0;
+  while (level + 1 < AssetManifest::MAX_MIP_LEVELS) {
+    int w = width >> (level + 1);
+    int h = height >> (level + 1);
+    if (w < AssetManifest::MIN_MIP_SIZE || h < AssetManifest::MIN_MIP_SIZE ||
+        w / frameCount < target.width || h < target.height)
+      break;
+    level++;
+  }
+  return level;
+}
+
+int UpdateMipLevel(unsigned int index, unsigned int generation);
+
+// Decode on a worker at the level the target calls for, upload on the main
+// thread. A first load marks the entry ready; a swap (swapLevel >= 0)
+// replaces the textures of a ready entry if that level is still wanted.
+void QueueTextureJob(unsigned int index, unsigned int generation,
+                     int swapLevel) {
+  const TextureData &data = textures.slots[index].data;
+
+  // Decoded data travels from the worker to the upload step
+  struct Decoded {
+    Image image = {0};
+    Image nightImage = {0};
+    SpriteMesh mesh;
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    int level = 0;
+  };
+  auto state = std::make_shared<Decoded>();
+  std::string file = data.path;
+  TextureOptions options = data.options;
+  MipTarget target = TargetFor(options);
+  int knownWidth = data.sourceWidth;
+  int knownHeight = data.sourceHeight;
+  // Meshes are in frame units: a swap keeps the one it has
+  bool buildMesh = options.buildMesh && swapLevel < 0;
+  const ColorGrade *nightGrade = options.night ? grade : nullptr;
+
+  loader->Queue(
+      [state, file, options, target, knownWidth, knownHeight, buildMesh,
+       nightGrade]() {
+        // With the full size known up front (conditioned pack, or a swap),
+        // only the wanted variant is read
+        int width = knownWidth;
+        int height = knownHeight;
+        int stored = 1;
+        if (width == 0)
+          AssetFiles::GetImageInfo(file.c_str(), &width, &height, &stored);
+        int level = width > 0 ? ChooseMipLevel(width, height,
+                                               options.frameCount, target)
+                              : 0;
+
+        // Decoded straight from the pack mapping when the file is packed
+        AssetBytes bytes = AssetFiles::Read(file.c_str(), level);
+        if (bytes.IsValid())
+          state->image = LoadImageFromMemory(bytes.fileType.c_str(),
+                                             bytes.data, (int)bytes.size);
+        if (state->image.data != nullptr) {
+          if (width == 0) {
+            width = state->image.width;
+            height = state->image.height;
+            level = ChooseMipLevel(width, height, options.frameCount, target);
+          }
+          // Levels the pack does not store (or loose files) are scaled here
+          int w = std::max(1, width >> level);
+          int h = std::max(1, height >> level);
+          if (state->image.width != w || state->image.height != h)
+            ImageResize(&state->image, w, h);
+        }
+        state->sourceWidth = width;
+        state->sourceHeight = height;
+        state->level = level;
+
+        if (buildMesh)
+          state->mesh.Build(state->image, options.frameCount, options.meshMode);
+        if (nightGrade != nullptr)
+          state->nightImage = nightGrade->GenNightImage(state->image);
+      },
+      [state, index, generation, swapLevel]() {
+        Slot<TextureData> *entry = textures.Find(index, generation);
+        // Cache shut down meanwhile, or another swap superseded this one
+        if (entry == nullptr ||
+            (swapLevel >= 0 && entry->data.pendingLevel != swapLevel)) {
+          UnloadImage(state->image);
+          UnloadImage(state->nightImage);
+          return;
+        }
+        if (swapLevel >= 0) {
+          UnloadEntry(*entry);
+          entry->data.pendingLevel = -1;
+        }
+
+        entry->data.texture = LoadTextureFromImage(state->image);
+        UnloadImage(state->image);
+        const Texture2D &tex = entry->data.texture;
+        entry->bytes =
+            (size_t)GetPixelDataSize(tex.width, tex.height, tex.format);
+        if (state->nightImage.data != nullptr) {
+          entry->data.night = LoadTextureFromImage(state->nightImage);
+          UnloadImage(state->nightImage);
+          entry->bytes += entry->bytes; // Same size as the day texture
+        }
+        entry->data.sourceWidth = state->sourceWidth;
+        entry->data.sourceHeight = state->sourceHeight;
+        entry->data.mipLevel = state->level;
+        if (swapLevel >= 0)
+          return;
+
+        if (entry->data.options.buildMesh) {
+          entry->data.mesh = std::move(state->mesh);
+          entry->data.hasMesh = true;
+        }
+
+        MarkReady(*entry);
+        // The render size changed while it loaded
+        UpdateMipLevel(index, generation);
+        // Every reference was dropped while it loaded
+        entry = textures.Find(index, generation);
+        if (entry != nullptr && entry->refs == 0)
+          Trim();
+      },
+      [state, index, generation, swapLevel]() {
+        UnloadImage(state->image);
+        UnloadImage(state->nightImage);
+        Slot<TextureData> *entry = textures.Find(index, generation);
+        if (entry == nullptr)
+          return;
+        if (swapLevel < 0)
+          MarkReady(*entry); // Stays empty, as when decoding fails
+        else if (entry->data.pendingLevel == swapLevel)
+          entry->data.pendingLevel = -1;
+      });
+}
+
+// Bring a ready texture to the level the render size calls for: swap it in
+// the background, or drop it when unused (it reloads at the right level
+// if acquired again). Returns 1 when a swap was queued.
+int UpdateMipLevel(unsigned int index, unsigned int generation) {
+  Slot<TextureData> *slot = textures.Find(index, generation);
+  if (slot == nullptr || !slot->ready || slot->data.sourceHeight == 0)
+    return 0;
+  TextureData &data = slot->data;
+  int level = ChooseMipLevel(data.sourceWidth, data.sourceHeight,
+                             data.options.frameCount, TargetFor(data.options));
+  if (level == data.mipLevel) {
+    data.pendingLevel = -1; // Cancels a swap still in flight
+    return 0;
+  }
+  if (level == data.pendingLevel)
+    return 0;
+  if (slot->refs == 0) {
+    Evict(textures, (int)index);
+    return 0;
+  }
+  data.pendingLevel = level;
+  QueueTextureJob(index, generation, level);
+  return 1;
+}
+
+} // namespace
+
+TextureOptions TextureOptions::Mesh(int frameCount, SpriteMesh::Mode mode) {
+  TextureOptions options;
+  options.frameCount = frameCount;
+  options.buildMesh = true;
+  options.meshMode = mode;
+  return options;
+}
+
+TextureOptions TextureOptions::WithNight() const {
+  TextureOptions options = *this;
+  options.night = true;
+  return options;
+}
+
+TextureOptions TextureOptions::WithDisplaySize(float height,
+                                               float width) const {
+  TextureOptions options = *this;
+  options.displayHeight = height;
+  options.displayWidth = width;
+  return options;
+}
+
+void Init(AssetLoader *assetLoader, const ColorGrade *colorGrade,
+          size_t unusedBudgetBytes) {
+  loader = assetLoader;
+  grade = colorGrade;
+  unusedBudget = unusedBudgetBytes;
+}
+
+void Shutdown() {
+  int referenced = 0;
+  for (auto &slot : textures.slots) {
+    if (slot.refs > 0)
+      referenced++;
+    UnloadEntry(slot);
+  }
+  for (auto &slot : sounds.slots) {
+    if (slot.refs > 0)
+      referenced++;
+    UnloadEntry(slot);
+  }
+  if (referenced > 0)
+    TraceLog(LOG_WARNING, "RESOURCES: %d entries still referenced at shutdown",
+             referenced);
+
+  textures = Pool<TextureData>();
+  sounds = Pool<SoundData>();
+}
+
+void SetRenderSize(int width, int height) {
+  if (width == renderWidth && height == renderHeight)
+    return;
+  renderWidth = width;
+  renderHeight = height;
+
+  int swaps = 0;
+  for (unsigned int i = 0; i < (unsigned int)textures.slots.size(); i++) {
+    if (!textures.slots[i].key.empty())
+      swaps += UpdateMipLevel(i, textures.slots[i].generation);
+  }
+  if (swaps > 0)
+    TraceLog(LOG_INFO, "RESOURCES: %dx%d, swapping %d textures", width, height,
+             swaps);
+}
+
+TextureHandle AcquireTexture(const char *path, const TextureOptions &options,
+                             ReadyCallback onReady) {
+  std::string key = TextureKey(path, options);
+
+  auto found = textures.lookup.find(key);
+  if (found != textures.lookup.end()) {
+    Slot<TextureData> &slot = textures.slots[found->second];
+    slot.refs++;
+    hits++;
+    if (onReady) {
+      if (slot.ready)
+        onReady();
+      else
+        slot.waiting.push_back(std::move(onReady));
+    }
+    return {found->second, slot.generation};
+  }
+
+  unsigned int index = textures.Allocate(key);
+  Slot<TextureData> &slot = textures.slots[index];
+  unsigned int generation = slot.generation;
+  slot.refs = 1;
+  slot.data.path = path;
+  slot.data.options = options;
+  if (onReady)
+    slot.waiting.push_back(std::move(onReady));
+  misses++;
+
+  QueueTextureJob(index, generation, -1);
+  return {index, generation};
+}
+
+SoundHandle AcquireSound(const char *path, ReadyCallback onReady) {
+  std::string key = path;
+
+  auto found = sounds.lookup.find(key);
+  if (found != sounds.lookup.end()) {
+    Slot<SoundData> &slot = sounds.slots[found->second];
+    slot.refs++;
+    hits++;
+    if (onReady) {
+      if (slot.ready)
+        onReady();
+      else
+        slot.waiting.push_back(std::move(onReady));
+    }
+    return {found->second, slot.generation};
+  }
+
+  unsigned int index = sounds.Allocate(key);
+  Slot<SoundData> &slot = sounds.slots[index];
+  unsigned int generation = slot.generation;
+  slot.refs = 1;
+  if (onReady)
+    slot.waiting.push_back(std::move(onReady));
+  misses++;
+
+  auto wave = std::make_shared<Wave>();
+  *wave = {0};
+  std::string file = path;
+
+  loader->Queue(
+      [wave, file]() {
+        AssetBytes bytes = AssetFiles::Read(file.c_str());
+        if (bytes.IsValid())
+          *wave = LoadWaveFromMemory(bytes.fileType.c_str(), bytes.data,
+                                     (int)bytes.size);
+      },
+      [wave, index, generation]() {
+        Slot<SoundData> *entry = sounds.Find(index, generation);
+        if (entry == nullptr) {
+          UnloadWave(*wave);
+          return;
+        }
+
+        entry->data.sound = LoadSoundFromWave(*wave);
+        entry->bytes =
+            (size_t)wave->frameCount * wave->channels * wave->sampleSize / 8;
+        UnloadWave(*wave);
+
+        MarkReady(*entry);
+        entry = sounds.Find(index, generation);
+        if (entry != nullptr && entry->refs == 0)
+          Trim();
+      },
+      [wave, index, generation]() {
+        UnloadWave(*wave);
+        Slot<SoundData> *entry = sounds.Find(index, generation);
+        if (entry != nullptr)
+          MarkReady(*entry); // Stays empty, as when decoding fails
+      });
+
+  return {index, generation};
+}
+
+void Release(TextureHandle handle) {
+  Unreference(textures.Find(handle.index, handle.generation));
+}
+
+void Release(SoundHandle handle) {
+  Unreference(sounds.Find(handle.index, handle.generation));
+}
+
+bool IsReady(TextureHandle handle) {
+  Slot<TextureData> *slot = textures.Find(handle.index, handle.generation);
+  return slot != nullptr && slot->ready;
+}
+
+const Texture2D &GetTexture(TextureHandle handle) {
+  Slot<TextureData> *slot = textures.Find(handle.index, handle.generation);
+  return (slot != nullptr && slot->ready) ? slot->data.texture : emptyTexture;
+}
+
+const Texture2D &GetNightTexture(TextureHandle handle) {
+  Slot<TextureData> *slot = textures.Find(handle.index, handle.generation);
+  return (slot != nullptr && slot->ready) ? slot->data.night : emptyTexture;
+}
+
+const SpriteMesh *GetMesh(TextureHandle handle) {
+  Slot<TextureData> *slot = textures.Find(handle.index, handle.generation);
+  if (slot == nullptr || !slot->ready || !slot->data.hasMesh)
+    return nullptr;
+  return &slot->data.mesh;
+}
+
+Vector2 GetSourceSize(TextureHandle handle) {
+  Slot<TextureData> *slot = textures.Find(handle.index, handle.generation);
+  if (slot == nullptr || !slot->ready)
+    return {0, 0};
+  return {(float)slot->data.sourceWidth, (float)slot->data.sourceHeight};
+}
+
+const Sound &GetSound(SoundHandle handle) {
+  Slot<SoundData> *slot = sounds.Find(handle.index, handle.generation);
+  return (slot != nullptr && slot->ready) ? slot->data.sound : emptySound;
+}
+
+int EvictUnused() {
+  int count = 0;
+  for (int i; (i = OldestUnused(textures)) >= 0; count++)
+    Evict(textures, i);
+  for (int i; (i = OldestUnused(sounds)) >= 0; count++)
+    Evict(sounds, i);
+  return count;
+}
+
+CacheStats GetStats() {
+  CacheStats stats = {};
+  for (const auto &slot : textures.slots) {
+    if (slot.key.empty())
+      continue;
+    stats.textures++;
+    stats.textureBytes += slot.bytes;
+    if (slot.refs == 0)
+      stats.unused++;
+    if (slot.data.pendingLevel >= 0)
+      stats.swapping++;
+  }
+  for (const auto &slot : sounds.slots) {
+    if (slot.key.empty())
+      continue;
+    stats.sounds++;
+    stats.soundBytes += slot.bytes;
+    if (slot.refs == 0)
+      stats.unused++;
+  }
+  stats.unusedBytes = UnusedBytes(textures) + UnusedBytes(sounds);
+  stats.hits = hits;
+  stats.misses = misses;
+  stats.evictions = evictions;
+  return stats;
+}
+
+void DrawStatsOverlay(int posX, int posY) {
+  CacheStats s = GetStats();
+  const float MB = 1024.0f * 1024.0f;
+  char lines[4][64];
+  snprintf(lines[0], sizeof(lines[0]), "textures: %d (%.1f MB) swap: %d",
+           s.textures, s.textureBytes / MB, s.swapping);
+  snprintf(lines[1], sizeof(lines[1]), "sounds: %d (%.1f MB)", s.sounds,
+           s.soundBytes / MB);
+  snprintf(lines[2], sizeof(lines[2]), "unused: %d (%.1f MB)", s.unused,
+           s.unusedBytes / MB);
+  snprintf(lines[3], sizeof(lines[3]), "hits: %d  misses: %d  evict: %d",
+           s.hits, s.misses, s.evictions);
+
+  int lineH = 16;
+  ::DrawRectangle(posX - 6, posY - 6, 250, lineH * 4 + 10, Fade(BLACK, 0.6f));
+  for (int i = 0; i < 4; i++)
+    ::DrawText(lines[i], posX, posY + i * lineH, 14, SKYBLUE);
+}
+
+} // namespace Resources
@@ -0,0 +1,115 @@
+#pragma once
+#include "SpriteMesh.h"
+#include "raylib.h"
+#include <cstddef>
+#include <functional>
+
+class AssetLoader;
+class ColorGrade;
+
+// Reference-counted cache of textures and sounds, keyed by asset path.
+//
+// Code holds lightweight handles (an index plus a generation) instead of
+// copies of raylib structs: handles are free to copy and resolve through the
+// cache at use time, so a stale handle reads as an empty resource instead of
+// a freed one. Acquiring an asset that is already cached only bumps its
+// reference count; the last Release() leaves it cached but unused, and
+// unused entries are evicted oldest first once they exceed a memory budget.
+//
+// Misses are loaded through the AssetLoader (decode on a worker, upload on
+// the main thread), at a mip level chosen for the render size (see
+// SetRenderSize). All functions are main-thread only.
+namespace Resources {
+
+struct TextureHandle {
+  unsigned int index = 0;
+  unsigned int generation = 0; // 0 = no texture
+  bool IsValid() const { return generation != 0; }
+};
+
+struct SoundHandle {
+  unsigned int index = 0;
+  unsigned int generation = 0; // 0 = no sound
+  bool IsValid() const { return generation != 0; }
+};
+
+// What to derive from an image while it is decoded. Different options on the
+// same path are cached as separate entries.
+struct TextureOptions {
+  int frameCount = 1;  // Spritesheet frames (laid out horizontally)
+  bool buildMesh = false;
+  SpriteMesh::Mode meshMode = SpriteMesh::Mode::HULL;
+  bool night = false; // Bake a night variant (CPU grading fallback only)
+
+  // Largest size one frame is drawn at, in render heights, which picks the
+  // mip level. displayHeight 0 = up to full screen; displayWidth 0 = no
+  // wider than the frame's aspect ratio gives.
+  float displayHeight = 0.0f;
+  float displayWidth = 0.0f;
+
+  // Drawn through an alpha-trimmed mesh, one mesh frame per sheet frame
+  static TextureOptions Mesh(int frameCount = 1,
+                             SpriteMesh::Mode mode = SpriteMesh::Mode::HULL);
+  TextureOptions WithNight() const;
+  TextureOptions WithDisplaySize(float height, float width = 0.0f) const;
+};
+
+struct CacheStats {
+  int textures;       // Cached entries (referenced or not)
+  int sounds;
+  int unused;         // Entries with no references left
+  size_t textureBytes; // Estimated VRAM of every cached texture
+  size_t soundBytes;   // Estimated audio memory of every cached sound
+  size_t unusedBytes;  // Part of the above held by unused entries
+  int hits;            // Acquires served from the cache
+  int misses;          // Acquires that started a load
+  int evictions;
+  int swapping;        // Textures changing mip level in the background
+};
+
+using ReadyCallback = std::function<void()>;
+
+constexpr size_t DEFAULT_UNUSED_BUDGET = 64u * 1024u * 1024u;
+
+// 'grade' bakes night variants on the CPU fallback path; it must be loaded
+// before the first texture with night = true is acquired
+void Init(AssetLoader *loader, const ColorGrade *grade,
+          size_t unusedBudgetBytes = DEFAULT_UNUSED_BUDGET);
+void Shutdown(); // Unloads every entry, referenced or not
+
+// Textures load at the smallest pre-scaled variant (mip level) that still
+// covers their display size at this render size. On a change, resident
+// textures whose level changes are reloaded in the background and swapped in
+// under the same handle (the old level draws meanwhile); unused ones are
+// dropped. Call before the first acquire, then on every resolution change.
+void SetRenderSize(int width, int height);
+
+// Take a reference, loading the asset on a miss. onReady runs (on the main
+// thread) once the asset is usable; immediately if it already is.
+TextureHandle AcquireTexture(const char *path,
+                             const TextureOptions &options = TextureOptions(),
+                             ReadyCallback onReady = nullptr);
+SoundHandle AcquireSound(const char *path, ReadyCallback onReady = nullptr);
+
+void Release(TextureHandle handle);
+void Release(SoundHandle handle);
+
+// Resolve a handle. Invalid, stale or still loading handles give an empty
+// resource (id 0 / null buffer), which raylib draws and plays as nothing.
+bool IsReady(TextureHandle handle);
+const Texture2D &GetTexture(TextureHandle handle);
+const Texture2D &GetNightTexture(TextureHandle handle); // Empty unless baked
+const SpriteMesh *GetMesh(TextureHandle handle);        // nullptr if none
+
+// Full-size dimensions of the image, whichever mip level is loaded (for
+// layouts that follow the art's size rather than the texture's)
+Vector2 GetSourceSize(TextureHandle handle);
+const Sound &GetSound(SoundHandle handle);
+
+int EvictUnused(); // Unload every unused entry now; returns how many
+CacheStats GetStats();
+
+// Panel with the cache stats (drawn unrecorded)
+void DrawStatsOverlay(int posX, int posY);
+
+} // namespace Resources
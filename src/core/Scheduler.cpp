@@ -0,0 +1,138 @@
+#include "Scheduler.h"
+#include <cmath>
+
+// --- Intrusive lists ---
+
+Scheduler::List::List() { head.prev = head.next = &head; }
+
+bool Scheduler::List::IsEmpty() const { return head.next == &head; }
+
+void Scheduler::List::PushBack(Node *node) {
+  node->Unlink();
+  node->prev = head.prev;
+  node->next = &head;
+  head.prev->next = node;
+  head.prev = node;
+}
+
+Scheduler::Node *Scheduler::List::PopFront() {
+  if (IsEmpty())
+    return nullptr;
+  Node *node = static_cast<Node *>(head.next);
+  node->Unlink();
+  return node;
+}
+
+void Scheduler::List::TakeAll(List &from) {
+  if (from.IsEmpty())
+    return;
+  Link *first = from.head.next;
+  Link *last = from.head.prev;
+  first->prev = head.prev;
+  head.prev->next = first;
+  last->next = &head;
+  head.prev = last;
+  from.head.prev = from.head.next = &from.head;
+}
+
+void Scheduler::Node::Unlink() {
+  if (next == nullptr)
+    return;
+  prev->next = next;
+  next->prev = prev;
+  prev = next = nullptr;
+}
+
+// --- Signal ---
+
+void Scheduler::Signal::Fire() {
+  while (Node *node = waiters.PopFront())
+    node->scheduler->ready.PushBack(node);
+}
+
+// --- Scheduler ---
+
+Scheduler::Scheduler() {
+  now = 0;
+  accumulator = 0.0f;
+  deltaTime = 0.0f;
+  taskCount = 0;
+}
+
+Scheduler::~Scheduler() { Clear(); }
+
+void Scheduler::Spawn(Task task) {
+  auto handle = task.handle;
+  task.handle = nullptr;
+  if (!handle)
+    return;
+  Task::promise_type &promise = handle.promise();
+  promise.wait.handle = promise.live.handle = handle;
+  promise.wait.scheduler = promise.live.scheduler = this;
+  live.PushBack(&promise.live);
+  taskCount++;
+  handle.resume(); // To its first wait (or its end)
+}
+
+void Scheduler::Clear() {
+  // Destroying a frame unlinks it (see promise_type), so this drains
+  while (Node *node = live.PopFront()) {
+    node->scheduler = nullptr; // Counted here, not by the promise
+    taskCount--;
+    node->handle.destroy();
+  }
+}
+
+Scheduler::DelayAwaiter Scheduler::Delay(float seconds) {
+  if (seconds <= 0.0f)
+    return {*this, 0};
+  return {*this, (uint64_t)std::ceil(seconds / TICK_SECONDS - 0.001f)};
+}
+
+void Scheduler::Insert(Node *node) {
+  uint64_t delta = node->due > now ? node->due - now : 0;
+  if (delta < NEAR_SLOTS)
+    nearSlots[node->due & (NEAR_SLOTS - 1)].PushBack(node);
+  else if (delta < NEAR_SLOTS * FAR_SLOTS)
+    farSlots[(node->due >> NEAR_BITS) & (FAR_SLOTS - 1)].PushBack(node);
+  else
+    overflow.PushBack(node);
+}
+
+void Scheduler::Cascade(List &slot) {
+  List pending;
+  pending.TakeAll(slot);
+  while (Node *node = pending.PopFront())
+    Insert(node);
+}
+
+void Scheduler::Resume(Node *node) { node->handle.resume(); }
+
+void Scheduler::RunAll(List &list) {
+  // Only what is waiting now: tasks that wait again land in a later pass
+  List batch;
+  batch.TakeAll(list);
+  while (Node *node = batch.PopFront())
+    Resume(node);
+}
+
+void Scheduler::Update(float dt) {
+  deltaTime = dt;
+  RunAll(ready);
+
+  accumulator += dt;
+  while (accumulator >= TICK_SECONDS) {
+    accumulator -= TICK_SECONDS;
+    now++;
+    // Entering a new span of the near wheel: bring its tasks down
+    if ((now & (NEAR_SLOTS - 1)) == 0) {
+      uint64_t span = now >> NEAR_BITS;
+      if ((span & (FAR_SLOTS - 1)) == 0)
+        Cascade(overflow);
+      Cascade(farSlots[span & (FAR_SLOTS - 1)]);
+    }
+    RunAll(nearSlots[now & (NEAR_SLOTS - 1)]);
+  }
+
+  RunAll(nextFrame);
+}
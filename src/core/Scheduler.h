@@ -0,0 +1,183 @@
+#pragma once
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+
+// Coroutine tasks for timed and scripted behaviour (C++20).
+//
+// A task is a member or free function returning Scheduler::Task that
+// co_awaits ticks, durations and signals:
+//
+//   Scheduler::Task Game::SunHint() {
+//     co_await sunBurn;                  // Gameplay event
+//     co_await scripts.Delay(3.0f);      // Game time
+//     co_await scripts.NextFrame();      // Next Update()
+//   }
+//   scripts.Spawn(SunHint());
+//
+// Waiting tasks sit in intrusive lists, so a wait allocates nothing. Delays
+// go into a hierarchical timer wheel: each tick looks at one slot, which
+// holds only the tasks due then, so dormant tasks cost nothing per frame
+// however many there are. Tasks only run inside Spawn() and Update(), on
+// the thread that calls them. Destroying the scheduler (or Clear()) drops
+// the tasks still waiting.
+class Scheduler {
+  struct Node;
+
+  // Circular list through a sentinel; a node is in at most one list
+  struct List {
+    List();
+    List(const List &) = delete;
+    List &operator=(const List &) = delete;
+
+    bool IsEmpty() const;
+    void PushBack(Node *node);
+    Node *PopFront();       // nullptr when empty
+    void TakeAll(List &from); // Appends 'from', leaving it empty
+
+    struct Link {
+      Link *prev;
+      Link *next;
+    } head;
+  };
+
+  struct Node : List::Link {
+    Node() { prev = next = nullptr; }
+    void Unlink();
+    std::coroutine_handle<> handle;
+    Scheduler *scheduler = nullptr;
+    uint64_t due = 0;
+  };
+
+public:
+  static constexpr float TICK_SECONDS = 1.0f / 60.0f; // Delay resolution
+
+  class Task {
+  public:
+    struct promise_type {
+      Node wait; // In a timer slot, signal or ready list while suspended
+      Node live; // In the scheduler's live list from Spawn() on
+
+      Task get_return_object() {
+        return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() {}
+      void unhandled_exception() { std::terminate(); }
+      ~promise_type() {
+        wait.Unlink();
+        live.Unlink();
+        if (live.scheduler != nullptr)
+          live.scheduler->taskCount--;
+      }
+    };
+
+    Task(Task &&other) noexcept : handle(other.handle) {
+      other.handle = nullptr;
+    }
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task() {
+      if (handle) // Never spawned
+        handle.destroy();
+    }
+
+  private:
+    friend class Scheduler;
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  // A gameplay event tasks wait for. Fire() wakes every waiting task on the
+  // scheduler's next Update(); tasks that wait after it wait for the next.
+  class Signal {
+  public:
+    Signal() {}
+    Signal(const Signal &) = delete;
+    Signal &operator=(const Signal &) = delete;
+
+    void Fire();
+    bool HasWaiters() const { return !waiters.IsEmpty(); }
+
+    struct Awaiter {
+      Signal &signal;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<Task::promise_type> h) {
+        signal.waiters.PushBack(&h.promise().wait);
+      }
+      void await_resume() const noexcept {}
+    };
+    Awaiter operator co_await() { return {*this}; }
+
+  private:
+    List waiters;
+  };
+
+  Scheduler();
+  ~Scheduler();
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  // Runs 'task' up to its first wait; the scheduler owns it from then on
+  void Spawn(Task task);
+  void Clear(); // Destroys every waiting task
+
+  // Advance game time: wakes signalled tasks, then tasks due in the ticks
+  // passed (in due order), then those waiting for the next frame
+  void Update(float dt);
+  float GetDeltaTime() const { return deltaTime; } // Of the current Update
+
+  // --- Awaitables ---
+  struct DelayAwaiter {
+    Scheduler &scheduler;
+    uint64_t ticks;
+    bool await_ready() const noexcept { return ticks == 0; }
+    void await_suspend(std::coroutine_handle<Task::promise_type> h) {
+      Node *node = &h.promise().wait;
+      node->due = scheduler.now + ticks;
+      scheduler.Insert(node);
+    }
+    void await_resume() const noexcept {}
+  };
+  struct FrameAwaiter {
+    Scheduler &scheduler;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<Task::promise_type> h) {
+      scheduler.nextFrame.PushBack(&h.promise().wait);
+    }
+    void await_resume() const noexcept {}
+  };
+
+  DelayAwaiter Delay(float seconds); // Rounded up to whole ticks
+  DelayAwaiter Ticks(uint64_t ticks) { return {*this, ticks}; }
+  FrameAwaiter NextFrame() { return {*this}; }
+
+  uint64_t GetTick() const { return now; }
+  int GetTaskCount() const { return taskCount; }
+
+private:
+  // Wheel: NEAR_SLOTS single ticks, then FAR_SLOTS spans of NEAR_SLOTS
+  // ticks, cascaded down as time reaches them; anything later waits in
+  // 'overflow', cascaded once per full turn of the far wheel
+  static constexpr int NEAR_BITS = 8;
+  static constexpr int FAR_BITS = 6;
+  static constexpr uint64_t NEAR_SLOTS = 1ull << NEAR_BITS;
+  static constexpr uint64_t FAR_SLOTS = 1ull << FAR_BITS;
+
+  List nearSlots[NEAR_SLOTS];
+  List farSlots[FAR_SLOTS];
+  List overflow;
+  List ready;     // Signalled
+  List nextFrame; // Waiting for the next Update
+  List live;      // Every spawned task, to destroy on Clear
+  uint64_t now;   // Ticks so far
+  float accumulator;
+  float deltaTime;
+  int taskCount;
+
+  void Insert(Node *node);
+  void Cascade(List &slot);
+  static void Resume(Node *node);
+  void RunAll(List &list);
+};
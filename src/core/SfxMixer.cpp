@@ -0,0 +1,209 @@
+#include "SfxMixer.h"
+#include <algorithm>
+
+SfxMixer::SfxMixer() {
+  stopping = false;
+  sleeping = false;
+  dropped = 0;
+  soundCount = 0;
+  for (float &v : busVolume)
+    v = 1.0f;
+  sfxVolume = 1.0f;
+  triggerCount = 0;
+}
+
+SfxMixer::~SfxMixer() { Stop(); }
+
+void SfxMixer::Start() {
+#if !defined(PLATFORM_WEB)
+  if (thread.joinable())
+    return;
+  stopping = false;
+  thread = std::thread(&SfxMixer::ThreadLoop, this);
+#endif
+}
+
+void SfxMixer::Stop() {
+  stopping = true;
+  sleeping = false;
+  sleeping.notify_one();
+  if (thread.joinable())
+    thread.join();
+
+  int count = soundCount.load();
+  for (int i = 0; i < count; i++) {
+    SoundSlot &slot = sounds[i];
+    for (int v = 0; v < slot.desc.maxVoices; v++) {
+      StopSound(slot.voices[v].alias);
+      UnloadSoundAlias(slot.voices[v].alias);
+    }
+  }
+  soundCount = 0;
+}
+
+SfxMixer::SfxId SfxMixer::Register(const Sound &sound, const SoundDesc &desc) {
+  int index = soundCount.load(std::memory_order_relaxed);
+  if (index >= MAX_SOUNDS || sound.stream.buffer == nullptr)
+    return -1;
+
+  SoundSlot &slot = sounds[index];
+  slot.desc = desc;
+  slot.desc.maxVoices = std::max(1, std::min(desc.maxVoices, MAX_SOUND_VOICES));
+  for (int v = 0; v < slot.desc.maxVoices; v++)
+    slot.voices[v] = {LoadSoundAlias(sound), 0, 1.0f};
+
+  // Publish: the mixer only reads slots below the count
+  soundCount.store(index + 1, std::memory_order_release);
+  return index;
+}
+
+void SfxMixer::Play(SfxId id, float volume) {
+  if (id >= 0)
+    Post({Command::PLAY, id, volume});
+}
+
+void SfxMixer::SetBusVolume(Bus bus, float volume) {
+  Post({Command::BUS_VOLUME, (int)bus, volume});
+}
+
+void SfxMixer::SetSfxVolume(float volume) {
+  Post({Command::SFX_VOLUME, 0, volume});
+}
+
+void SfxMixer::StopAll() { Post({Command::STOP_ALL, 0, 0.0f}); }
+
+void SfxMixer::Pump() {
+  if (!thread.joinable())
+    Mix();
+}
+
+void SfxMixer::Post(const Command &command) {
+  if (!commands.Push(command)) {
+    dropped++;
+    return;
+  }
+  // Pairs with the fence in ThreadLoop: either the mixer sees this command
+  // before it sleeps, or this sees it asleep. Only then is there a syscall.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load(std::memory_order_relaxed)) {
+    sleeping.store(false, std::memory_order_relaxed);
+    sleeping.notify_one();
+  }
+}
+
+void SfxMixer::Mix() {
+  int count = soundCount.load(std::memory_order_acquire);
+  bool volumesChanged = false;
+  Command command;
+  while (commands.Pop(command)) {
+    switch (command.type) {
+    case Command::PLAY:
+      if (command.target < count)
+        Trigger(command.target, command.volume);
+      break;
+    case Command::BUS_VOLUME:
+      busVolume[command.target] = command.volume;
+      volumesChanged = true;
+      break;
+    case Command::SFX_VOLUME:
+      sfxVolume = command.volume;
+      volumesChanged = true;
+      break;
+    case Command::STOP_ALL:
+      for (int i = 0; i < count; i++) {
+        for (int v = 0; v < sounds[i].desc.maxVoices; v++)
+          StopSound(sounds[i].voices[v].alias);
+      }
+      break;
+    }
+  }
+  if (volumesChanged)
+    ApplyVolumes();
+}
+
+void SfxMixer::Trigger(int sound, float volume) {
+  SoundSlot &slot = sounds[sound];
+  int count = soundCount.load(std::memory_order_acquire);
+
+  // A free copy of this sound, within its polyphony
+  Voice *voice = nullptr;
+  Voice *oldest = &slot.voices[0];
+  for (int v = 0; v < slot.desc.maxVoices; v++) {
+    Voice &candidate = slot.voices[v];
+    if (!IsSoundPlaying(candidate.alias)) {
+      voice = &candidate;
+      break;
+    }
+    if (candidate.startedAt < oldest->startedAt)
+      oldest = &candidate;
+  }
+
+  if (voice == nullptr) {
+    // At its limit: restart its oldest copy (reuses that pool voice)
+    if (!slot.desc.restart) {
+      dropped++;
+      return;
+    }
+    voice = oldest;
+    StopSound(voice->alias);
+  } else {
+    // Takes a pool voice: if none is free, steal the weakest playing one
+    int active = 0;
+    Voice *victim = nullptr;
+    int victimPriority = 0;
+    for (int i = 0; i < count; i++) {
+      for (int v = 0; v < sounds[i].desc.maxVoices; v++) {
+        Voice &playing = sounds[i].voices[v];
+        if (!IsSoundPlaying(playing.alias))
+          continue;
+        active++;
+        int priority = sounds[i].desc.priority;
+        if (victim == nullptr || priority < victimPriority ||
+            (priority == victimPriority &&
+             playing.startedAt < victim->startedAt)) {
+          victim = &playing;
+          victimPriority = priority;
+        }
+      }
+    }
+    if (active >= MAX_VOICES) {
+      if (victim == nullptr || victimPriority > slot.desc.priority) {
+        dropped++;
+        return;
+      }
+      StopSound(victim->alias);
+    }
+  }
+
+  voice->startedAt = ++triggerCount;
+  voice->volume = volume * slot.desc.volume;
+  SetSoundVolume(voice->alias, voice->volume * Gain(slot));
+  PlaySound(voice->alias);
+}
+
+void SfxMixer::ApplyVolumes() {
+  // Playing voices follow the new levels too
+  int count = soundCount.load(std::memory_order_acquire);
+  for (int i = 0; i < count; i++) {
+    float gain = Gain(sounds[i]);
+    for (int v = 0; v < sounds[i].desc.maxVoices; v++) {
+      const Voice &voice = sounds[i].voices[v];
+      SetSoundVolume(voice.alias, voice.volume * gain);
+    }
+  }
+}
+
+float SfxMixer::Gain(const SoundSlot &slot) const {
+  return busVolume[(int)slot.desc.bus] * sfxVolume;
+}
+
+void SfxMixer::ThreadLoop() {
+  while (!stopping) {
+    Mix();
+    sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (commands.IsEmpty() && !stopping)
+      sleeping.wait(true); // Until Post() or Stop() clears it
+    sleeping.store(false, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "SpscQueue.h"
+#include "raylib.h"
+#include <atomic>
+#include <thread>
+
+// Sound effect mixer: a fixed pool of voices shared by every effect.
+//
+// Each registered sound gets up to 'maxVoices' aliases (LoadSoundAlias:
+// same samples, own playback state), so overlapping triggers layer instead
+// of cutting each other off. When the pool is full a trigger takes the
+// voice of the lowest-priority (then oldest) sound at or below its own
+// priority, or is dropped.
+//
+// Volume: trigger volume x category bus x sfx volume; the master volume is
+// applied by raylib on top (SetMasterVolume).
+//
+// The game thread only posts to a lock-free queue; voices are started and
+// stopped on the mixer thread, which sleeps while the queue is empty (a post
+// wakes it only then). Without threads (web build) Pump() drains the queue
+// on the main thread.
+class SfxMixer {
+public:
+  static constexpr int MAX_VOICES = 16; // Pool shared by every sound
+  static constexpr int MAX_SOUNDS = 32;
+  static constexpr int MAX_SOUND_VOICES = 4; // Per-sound polyphony cap
+
+  using SfxId = int; // -1: none
+
+  enum class Bus { PLAYER, ENEMY, WORLD, COUNT };
+
+  struct SoundDesc {
+    Bus bus = Bus::WORLD;
+    int priority = 0;  // Higher wins a voice when the pool is full
+    int maxVoices = 1; // Copies of this sound playing at once
+    // At its voice limit: true restarts its oldest voice, false drops the
+    // new trigger (a looping burn that should not stack)
+    bool restart = true;
+    float volume = 1.0f;
+  };
+
+  SfxMixer();
+  ~SfxMixer();
+
+  void Start();
+  void Stop(); // Joins the thread and releases the voices
+
+  // Main thread, any time before Stop(). The source sound must outlive the
+  // mixer (released only after Stop()). Returns -1 for an unloaded sound.
+  SfxId Register(const Sound &sound, const SoundDesc &desc);
+
+  // Game thread: a queue push, never blocks (dropped if the queue is full)
+  void Play(SfxId id, float volume = 1.0f);
+  void SetBusVolume(Bus bus, float volume);
+  void SetSfxVolume(float volume);
+  void StopAll();
+
+  void Pump(); // Main-thread mixing when there is no thread (web)
+
+  int GetDroppedCount() const { return dropped.load(); }
+
+private:
+  struct Command {
+    enum Type { PLAY, BUS_VOLUME, SFX_VOLUME, STOP_ALL } type;
+    int target; // Sound or bus
+    float volume;
+  };
+
+  struct Voice {
+    Sound alias;
+    unsigned long long startedAt; // Trigger sequence, 0 = never played
+    float volume;                 // Trigger volume x sound volume
+  };
+
+  struct SoundSlot {
+    SoundDesc desc;
+    Voice voices[MAX_SOUND_VOICES];
+  };
+
+  std::thread thread;
+  std::atomic<bool> stopping;
+  std::atomic<bool> sleeping; // Mixer thread waits on it (cleared to wake)
+  std::atomic<int> dropped; // Triggers lost to a full queue or pool
+
+  SpscQueue<Command, 256> commands;
+
+  // Written by Register() before the count is published
+  SoundSlot sounds[MAX_SOUNDS];
+  std::atomic<int> soundCount;
+
+  // Mixer thread state
+  float busVolume[(int)Bus::COUNT];
+  float sfxVolume;
+  unsigned long long triggerCount;
+
+  void Post(const Command &command);
+  void Mix(); // Drain the queue
+  void Trigger(int sound, float volume);
+  void ApplyVolumes();
+  float Gain(const SoundSlot &slot) const;
+  void ThreadLoop();
+};
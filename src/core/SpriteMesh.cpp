@@ -0,0 +1,212 @@
+#include "SpriteMesh.h"
+#include "Render.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+float Cross(Vector2 o, Vector2 a, Vector2 b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Append a triangle wound like raylib's quads (TL, BL, BR in y-down space)
+void AddTriangle(std::vector<Vector2> &tris, Vector2 a, Vector2 b, Vector2 c) {
+  float cross = Cross(a, b, c);
+  if (cross == 0.0f)
+    return; // Degenerate
+  tris.push_back(a);
+  if (cross < 0.0f) {
+    tris.push_back(b);
+    tris.push_back(c);
+  } else {
+    tris.push_back(c);
+    tris.push_back(b);
+  }
+}
+
+// Andrew's monotone chain; returns the hull without the repeated end point
+std::vector<Vector2> ConvexHull(std::vector<Vector2> pts) {
+  std::sort(pts.begin(), pts.end(), [](const Vector2 &a, const Vector2 &b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+  pts.erase(std::unique(pts.begin(), pts.end(),
+                        [](const Vector2 &a, const Vector2 &b) {
+                          return a.x == b.x && a.y == b.y;
+                        }),
+            pts.end());
+  if (pts.size() < 3)
+    return pts;
+
+  std::vector<Vector2> hull(pts.size() * 2);
+  size_t k = 0;
+  for (size_t i = 0; i < pts.size(); i++) {
+    while (k >= 2 && Cross(hull[k - 2], hull[k - 1], pts[i]) <= 0)
+      k--;
+    hull[k++] = pts[i];
+  }
+  for (size_t i = pts.size() - 1, t = k + 1; i > 0; i--) {
+    while (k >= t && Cross(hull[k - 2], hull[k - 1], pts[i - 1]) <= 0)
+      k--;
+    hull[k++] = pts[i - 1];
+  }
+  hull.resize(k - 1);
+  return hull;
+}
+
+} // namespace
+
+SpriteMesh::SpriteMesh() {}
+
+void SpriteMesh::Clear() {
+  frames.clear();
+  coverage.clear();
+}
+
+void SpriteMesh::Build(Image image, int frameCount, Mode mode,
+                       int cellsAcross) {
+  Clear();
+  if (image.data == nullptr || frameCount < 1 || cellsAcross < 1)
+    return;
+
+  int frameW = image.width / frameCount;
+  int frameH = image.height;
+  if (frameW <= 0 || frameH <= 0)
+    return;
+
+  Color *pixels = LoadImageColors(image);
+  if (pixels == nullptr)
+    return;
+
+  // Square cells, coarse enough to keep vertex counts small
+  int cellSize = std::max(1, std::max(frameW, frameH) / cellsAcross);
+  int cols = (frameW + cellSize - 1) / cellSize;
+  int rows = (frameH + cellSize - 1) / cellSize;
+  std::vector<unsigned char> occupied(cols * rows);
+
+  // Cell edges in normalised frame coordinates
+  auto NX = [&](int cx) {
+    return std::min(1.0f, (float)(cx * cellSize) / (float)frameW);
+  };
+  auto NY = [&](int cy) {
+    return std::min(1.0f, (float)(cy * cellSize) / (float)frameH);
+  };
+
+  for (int f = 0; f < frameCount; f++) {
+    std::fill(occupied.begin(), occupied.end(), 0);
+    for (int y = 0; y < frameH; y++) {
+      const Color *row = pixels + y * image.width + f * frameW;
+      for (int x = 0; x < frameW; x++) {
+        if (row[x].a > 0)
+          occupied[(y / cellSize) * cols + x / cellSize] = 1;
+      }
+    }
+
+    std::vector<Vector2> tris;
+    if (mode == Mode::GRID) {
+      // One quad per horizontal run of occupied cells
+      for (int cy = 0; cy < rows; cy++) {
+        int cx = 0;
+        while (cx < cols) {
+          if (!occupied[cy * cols + cx]) {
+            cx++;
+            continue;
+          }
+          int start = cx;
+          while (cx < cols && occupied[cy * cols + cx])
+            cx++;
+          Vector2 tl = {NX(start), NY(cy)};
+          Vector2 bl = {NX(start), NY(cy + 1)};
+          Vector2 br = {NX(cx), NY(cy + 1)};
+          Vector2 tr = {NX(cx), NY(cy)};
+          AddTriangle(tris, tl, bl, br);
+          AddTriangle(tris, tl, br, tr);
+        }
+      }
+    } else {
+      // Hull over the outer corners of the leftmost/rightmost cell per row
+      std::vector<Vector2> pts;
+      for (int cy = 0; cy < rows; cy++) {
+        int left = -1, right = -1;
+        for (int cx = 0; cx < cols; cx++) {
+          if (occupied[cy * cols + cx]) {
+            if (left < 0)
+              left = cx;
+            right = cx;
+          }
+        }
+        if (left < 0)
+          continue;
+        pts.push_back({NX(left), NY(cy)});
+        pts.push_back({NX(left), NY(cy + 1)});
+        pts.push_back({NX(right + 1), NY(cy)});
+        pts.push_back({NX(right + 1), NY(cy + 1)});
+      }
+
+      std::vector<Vector2> hull = ConvexHull(pts);
+      for (size_t i = 1; i + 1 < hull.size(); i++)
+        AddTriangle(tris, hull[0], hull[i], hull[i + 1]);
+    }
+
+    float area = 0.0f;
+    for (size_t i = 0; i + 2 < tris.size(); i += 3)
+      area += std::fabs(Cross(tris[i], tris[i + 1], tris[i + 2])) * 0.5f;
+
+    frames.push_back(std::move(tris));
+    coverage.push_back(area);
+  }
+
+  UnloadImageColors(pixels);
+}
+
+float SpriteMesh::GetCoverage(int frame) const {
+  if (frame < 0 || frame >= (int)coverage.size())
+    return 1.0f;
+  return coverage[frame];
+}
+
+void SpriteMesh::Draw(Texture2D texture, Rectangle source, Rectangle dest,
+                      Color tint, int frame) const {
+  if (frame < 0 || frame >= (int)frames.size() || texture.id == 0) {
+    Render::DrawTexturePro(texture, source, dest, {0, 0}, 0.0f, tint);
+    return;
+  }
+
+  const std::vector<Vector2> &tris = frames[frame];
+  if (tris.empty())
+    return; // Fully transparent frame
+
+  // Flipped sources mirror the mesh on screen, which also flips the winding
+  bool flipX = source.width < 0;
+  bool flipY = source.height < 0;
+  bool swapWinding = flipX != flipY;
+  float srcW = std::fabs(source.width);
+  float srcH = std::fabs(source.height);
+  float texW = (float)texture.width;
+  float texH = (float)texture.height;
+
+  Color color = Render::BlendColor(tint);
+  rlCheckRenderBatchLimit((int)tris.size());
+  rlSetTexture(texture.id);
+  rlBegin(RL_TRIANGLES);
+  rlColor4ub(color.r, color.g, color.b, color.a);
+
+  for (size_t i = 0; i + 2 < tris.size(); i += 3) {
+    for (int k = 0; k < 3; k++) {
+      // Emit as (0, 2, 1) when the winding must be reversed
+      int j = (swapWinding && k > 0) ? 3 - k : k;
+      Vector2 n = tris[i + j];
+      float sx = flipX ? 1.0f - n.x : n.x;
+      float sy = flipY ? 1.0f - n.y : n.y;
+      rlTexCoord2f((source.x + n.x * srcW) / texW,
+                   (source.y + n.y * srcH) / texH);
+      rlVertex2f(dest.x + sx * dest.width, dest.y + sy * dest.height);
+    }
+  }
+
+  rlEnd();
+  rlSetTexture(0);
+
+  Render::RecordDraw(texture.id, (int)tris.size(),
+                     std::fabs(dest.width * dest.height) * coverage[frame]);
+}
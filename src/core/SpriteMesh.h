@@ -0,0 +1,44 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// Alpha-trimmed mesh for a texture (or each frame of a horizontal sheet).
+//
+// Built once at load from the decoded image, then drawn instead of a full
+// quad so the transparent texels around the sprite are never shaded.
+//  - HULL: convex hull of the opaque cells, drawn as a triangle fan. Best for
+//          compact sprites (characters, enemies, props).
+//  - GRID: only the cells that contain opaque texels, merged into runs per
+//          row. Best for large layers with holes (foregrounds).
+// Vertices are stored normalised to the frame (0..1), so the mesh works with
+// any dest rectangle and with flipped source rectangles.
+class SpriteMesh {
+public:
+  enum class Mode { HULL, GRID };
+
+  SpriteMesh();
+
+  // image: the decoded texture image. frameCount: horizontal frames.
+  // cellsAcross: resolution of the opaque-cell grid per frame.
+  void Build(Image image, int frameCount = 1, Mode mode = Mode::HULL,
+             int cellsAcross = 32);
+  void Clear();
+
+  bool IsBuilt() const { return !frames.empty(); }
+  int GetFrameCount() const { return (int)frames.size(); }
+
+  // Same contract as DrawTexturePro(texture, source, dest, {0,0}, 0, tint);
+  // 'frame' selects which frame's mesh covers 'source'. Falls back to
+  // DrawTexturePro when the mesh was not built.
+  void Draw(Texture2D texture, Rectangle source, Rectangle dest, Color tint,
+            int frame = 0) const;
+
+  // Fraction of the frame area covered by the mesh (1 = full quad)
+  float GetCoverage(int frame = 0) const;
+
+private:
+  // Triangle list per frame, 3 normalised vertices per triangle, wound the
+  // same way raylib winds its quads.
+  std::vector<std::vector<Vector2>> frames;
+  std::vector<float> coverage;
+};
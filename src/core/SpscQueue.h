@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Fixed-capacity lock-free queue for exactly one producer thread and one
+// consumer thread. Push and Pop are a couple of atomic loads and one store;
+// neither ever blocks. Capacity must be a power of two.
+template <typename T, size_t Capacity> class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+public:
+  SpscQueue() : head(0), tail(0) {}
+
+  // Producer: false (item dropped) when full
+  bool Push(const T &item) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == Capacity)
+      return false;
+    items[t & (Capacity - 1)] = item;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: whether Pop would fail
+  bool IsEmpty() const {
+    return head.load(std::memory_order_relaxed) ==
+           tail.load(std::memory_order_acquire);
+  }
+
+  // Consumer: false when empty
+  bool Pop(T &item) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return false;
+    item = items[h & (Capacity - 1)];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  // Each index on its own cache line: the threads never write the same one
+  alignas(64) std::atomic<size_t> head; // Next to pop (consumer writes)
+  alignas(64) std::atomic<size_t> tail; // Next to push (producer writes)
+  alignas(64) T items[Capacity];
+};
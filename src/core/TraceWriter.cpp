@@ -0,0 +1,177 @@
+#include "TraceWriter.h"
+#include "raylib.h"
+#include <cmath>
+
+namespace {
+
+// Names are code literals; quotes and backslashes are escaped anyway
+void WriteString(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\')
+      fputc('\\', f);
+    if ((unsigned char)*s >= 0x20)
+      fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+void WriteEvent(FILE *f, const TraceWriter::Event &e) {
+  // Microseconds, kept to the nanosecond
+  double ts = (double)e.time * 1e-3;
+  switch (e.phase) {
+  case 'M':
+    fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+               "\"name\":\"thread_name\",\"args\":{\"name\":",
+            e.thread);
+    WriteString(f, e.name);
+    fputs("}}", f);
+    break;
+  case 'X':
+    fprintf(f, "{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,"
+               "\"dur\":%.3f,\"name\":",
+            e.thread, ts, (double)e.duration * 1e-3);
+    WriteString(f, e.name);
+    fputc('}', f);
+    break;
+  case 'i':
+    // Global scope: drawn across every thread's track
+    fprintf(f, "{\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%d,"
+               "\"ts\":%.3f,\"name\":",
+            e.thread, ts);
+    WriteString(f, e.name);
+    fputc('}', f);
+    break;
+  case 'C':
+    fprintf(f, "{\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":",
+            e.thread, ts);
+    WriteString(f, e.name);
+    // JSON has no NaN or infinity: %g would write them as is
+    fprintf(f, ",\"args\":{\"value\":%.6g}}",
+            std::isfinite(e.value) ? e.value : 0.0);
+    break;
+  }
+}
+
+} // namespace
+
+TraceWriter::TraceWriter() {
+  file = nullptr;
+  eventCount = 0;
+  stopping = false;
+  first = true;
+}
+
+TraceWriter::~TraceWriter() { Stop(); }
+
+bool TraceWriter::Start(const char *outPath) {
+  if (file != nullptr)
+    return true;
+  file = fopen(outPath, "wb");
+  if (file == nullptr) {
+    TraceLog(LOG_WARNING, "TraceWriter: cannot create %s", outPath);
+    return false;
+  }
+  path = outPath;
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+  first = true;
+  eventCount = 0;
+  batch.clear();
+  queued.clear();
+  threadNames.clear();
+
+#if !defined(PLATFORM_WEB)
+  stopping = false;
+  writer = std::thread(&TraceWriter::WriterLoop, this);
+#endif
+  TraceLog(LOG_INFO, "TraceWriter: recording to %s", outPath);
+  return true;
+}
+
+void TraceWriter::Stop() {
+  if (file == nullptr)
+    return;
+  Flush();
+#if !defined(PLATFORM_WEB)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  if (writer.joinable())
+    writer.join();
+#endif
+  fputs("\n]}\n", file);
+  fclose(file);
+  file = nullptr;
+  TraceLog(LOG_INFO, "TraceWriter: %d events written to %s", eventCount,
+           path.c_str());
+}
+
+void TraceWriter::SetThreadName(int thread, const char *name) {
+  threadNames.push_back(name);
+  batch.push_back({'M', threadNames.back().c_str(), thread, 0, 0, 0.0});
+}
+
+void TraceWriter::Flush() {
+  if (file == nullptr || batch.empty())
+    return;
+  eventCount += (int)batch.size();
+#if defined(PLATFORM_WEB)
+  Write(batch);
+#else
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.insert(queued.end(), batch.begin(), batch.end());
+  }
+  wake.notify_one();
+#endif
+  batch.clear();
+}
+
+void TraceWriter::WriterLoop() {
+  std::vector<Event> events;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this] { return stopping || !queued.empty(); });
+      if (queued.empty())
+        return; // Stopping, and everything is written
+      events.swap(queued);
+    }
+    Write(events);
+    events.clear();
+  }
+}
+
+void TraceWriter::Write(const std::vector<Event> &events) {
+  for (const Event &e : events) {
+    fputs(first ? "" : ",\n", file);
+    first = false;
+    WriteEvent(file, e);
+  }
+  fflush(file);
+}
+
+bool TraceWriter::WriteFile(const char *outPath,
+                            const std::vector<Event> &events,
+                            const Notes &notes) {
+  FILE *f = fopen(outPath, "wb");
+  if (f == nullptr)
+    return false;
+  fputs("{\"displayTimeUnit\":\"ms\",\"otherData\":{", f);
+  for (size_t i = 0; i < notes.size(); i++) {
+    fputs(i == 0 ? "\n" : ",\n", f);
+    WriteString(f, notes[i].first.c_str());
+    fputc(':', f);
+    WriteString(f, notes[i].second.c_str());
+  }
+  fputs("},\"traceEvents\":[\n", f);
+  for (size_t i = 0; i < events.size(); i++) {
+    if (i > 0)
+      fputs(",\n", f);
+    WriteEvent(f, events[i]);
+  }
+  fputs("\n]}\n", f);
+  return fclose(f) == 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Chrome trace-event JSON file (chrome://tracing, ui.perfetto.dev), written
+// off the game thread.
+//
+// Events are added to an in-memory batch; Flush() hands the batch to a
+// writer thread that formats and appends it, so the game thread never waits
+// on the disk. The file is valid JSON once Stop() has written the end.
+//
+// Without threads (web build) Flush() writes on the calling thread.
+class TraceWriter {
+public:
+  // Key/value pairs stored with a trace ("otherData": shown as metadata)
+  using Notes = std::vector<std::pair<std::string, std::string>>;
+
+  struct Event {
+    char phase;       // 'X' span, 'i' instant, 'C' counter, 'M' thread name
+    const char *name; // Must outlive the writer (string literal)
+    int thread;
+    int64_t time;     // Nanoseconds from the trace start
+    int64_t duration; // 'X' only
+    double value;     // 'C' only
+  };
+
+  TraceWriter();
+  ~TraceWriter();
+
+  bool Start(const char *path);
+  void Stop(); // Writes what is pending, joins the writer, closes the file
+  bool IsRecording() const { return file != nullptr; }
+
+  // Game thread
+  void Add(const Event &event) { batch.push_back(event); }
+  void SetThreadName(int thread, const char *name); // Copied
+  void Flush();
+
+  int GetEventCount() const { return eventCount; } // Added so far
+  const char *GetPath() const { return path.c_str(); }
+
+  // A whole trace in one go, on the calling thread
+  static bool WriteFile(const char *path, const std::vector<Event> &events,
+                        const Notes &notes);
+
+private:
+  FILE *file;
+  std::string path;
+  std::vector<Event> batch; // Game thread
+  int eventCount;
+  std::deque<std::string> threadNames; // Never shrinks while recording
+
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<Event> queued; // Handed over, under mutex
+  bool stopping;
+  bool first; // Writer side: no comma before the first event
+
+  void WriterLoop();
+  void Write(const std::vector<Event> &events);
+};
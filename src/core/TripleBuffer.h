@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+
+// Latest-value handoff from one writer thread to one reader thread, with
+// neither ever waiting. The writer fills Back() and publishes it; the reader
+// takes the most recently published slot with Front(). Three slots: one
+// being written, one being read, one in between that the two swap with.
+// Slots are reused, so their allocations (vectors) are too.
+template <typename T> class TripleBuffer {
+public:
+  TripleBuffer() : back(0), middle(1), front(2) {}
+
+  // Writer: the slot to fill next
+  T &Back() { return slots[back]; }
+
+  // Writer: make Back() the latest; the writer gets the old middle slot
+  void Publish() {
+    int old = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+    back = old & INDEX;
+  }
+
+  // Reader: the latest published slot. Stays valid (and unchanged) until
+  // the next call; the same one is returned while nothing new is published.
+  const T &Front() {
+    if (middle.load(std::memory_order_relaxed) & FRESH) {
+      int old = middle.exchange(front, std::memory_order_acq_rel);
+      front = old & INDEX;
+    }
+    return slots[front];
+  }
+
+  bool HasNew() const { return middle.load(std::memory_order_relaxed) & FRESH; }
+
+private:
+  static constexpr int INDEX = 3;
+  static constexpr int FRESH = 4; // Middle was published, not read yet
+
+  T slots[3];
+  int back;                 // Writer only
+  std::atomic<int> middle;  // Index plus FRESH
+  int front;                // Reader only
+};
@@ -4,6 +4,8 @@ enum class DayNightState { DAY, NIGHT };
 
 enum class Direction { LEFT, RIGHT };
 
+enum class EnemyType { SPIDER, ROACH };
+
 enum class PlatformType {
   NORMAL,
   FLOWER,   // Solid during Day
@@ -5,13 +5,29 @@
 
 class Enemy : public Entity {
 public:
+  EnemyType type;
   float speed;
   bool movingRight;
 
-  Enemy(Vector2 pos) : Entity() {
+  // Ground it walks on, [min, max) in x, baked with the level. Without one
+  // the level geometry is probed every step.
+  Vector2 patrolRange;
+  bool hasPatrol;
+
+  Enemy(Vector2 pos, EnemyType kind) : Entity() {
     position = pos;
+    type = kind;
     speed = Core::ENEMY_SPEED;
     movingRight = true;
+    patrolRange = {0, 0};
+    hasPatrol = false;
+  }
+
+  // Ground under the point (x, feet)?
+  bool HasGround(float x, float feet, const Level &level) const {
+    if (hasPatrol)
+      return x >= patrolRange.x && x < patrolRange.y;
+    return !level.IsEdge({x, feet});
   }
 
   virtual void Update(float dt, const Level &level) {
@@ -48,7 +64,7 @@ public:
 
     // Level::IsEdge checks if there is ground at (x, y+1)
     // We want to pass the bottom corner.
-    if (level.IsEdge({checkPos.x, position.y + rect.height})) {
+    if (!HasGround(checkPos.x, position.y + rect.height, level)) {
       // Turn around
       movingRight = !movingRight;
     }
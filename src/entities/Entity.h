@@ -1,16 +1,17 @@
 #pragma once
 #include "../core/Constants.h"
+#include "../core/Render.h"
+#include "../core/Resources.h"
 #include "raylib.h"
 
 class Entity {
 public:
   Vector2 position;
   int hp;
-  Texture2D sprite;
-  bool textureLoaded;
+  Resources::TextureHandle sprite; // Mesh (if built) comes with it
 
   // Animation support (spritesheet)
-  Texture2D spritesheet;
+  Resources::TextureHandle spritesheet; // One mesh frame per sheet frame
   int frameCount;
   int currentFrame;
   float frameTimer;
@@ -21,9 +22,8 @@ public:
   float height;
 
   Entity()
-      : position({0, 0}), hp(1), sprite({0}), textureLoaded(false),
-        spritesheet({0}), frameCount(1), currentFrame(0), frameTimer(0.0f),
-        frameSpeed(0.1f), animated(false),
+      : position({0, 0}), hp(1), sprite(), spritesheet(), frameCount(1),
+        currentFrame(0), frameTimer(0.0f), frameSpeed(0.1f), animated(false),
         width((float)Core::SCREEN_HEIGHT * 0.05f),
         height((float)Core::SCREEN_HEIGHT * 0.05f) {}
 
@@ -41,23 +41,37 @@ public:
   }
 
   virtual void Draw() {
-    if (animated && spritesheet.id != 0) {
+    const Texture2D &sheet = Resources::GetTexture(spritesheet);
+    const Texture2D &tex = Resources::GetTexture(sprite);
+    if (animated && sheet.id != 0) {
       // Draw current frame from spritesheet
-      float frameW = (float)spritesheet.width / (float)frameCount;
-      float frameH = (float)spritesheet.height;
+      float frameW = (float)sheet.width / (float)frameCount;
+      float frameH = (float)sheet.height;
       Rectangle source = {frameW * currentFrame, 0, frameW, frameH};
       Rectangle dest = {position.x, position.y, width, height};
-      DrawTexturePro(spritesheet, source, dest, {0, 0}, 0.0f, WHITE);
-    } else if (textureLoaded) {
+      DrawSprite(spritesheet, source, dest, currentFrame);
+    } else if (tex.id != 0) {
       // Scale sprite to match entity dimensions
-      Rectangle source = {0, 0, (float)sprite.width, (float)sprite.height};
+      Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
       Rectangle dest = {position.x, position.y, width, height};
-      DrawTexturePro(sprite, source, dest, {0, 0}, 0.0f, WHITE);
+      DrawSprite(sprite, source, dest);
     } else {
       // Debug Draw
-      DrawRectangleV(position, {width, height}, RED);
+      Render::DrawRectangleV(position, {width, height}, RED);
     }
   }
 
   Rectangle GetRect() const { return {position.x, position.y, width, height}; }
+
+protected:
+  // Draw through the texture's alpha-trimmed mesh when it has one
+  static void DrawSprite(Resources::TextureHandle handle, Rectangle source,
+                         Rectangle dest, int frame = 0) {
+    const Texture2D &tex = Resources::GetTexture(handle);
+    const SpriteMesh *mesh = Resources::GetMesh(handle);
+    if (mesh != nullptr)
+      mesh->Draw(tex, source, dest, WHITE, frame);
+    else
+      Render::DrawTexturePro(tex, source, dest, {0, 0}, 0.0f, WHITE);
+  }
 };
@@ -1,5 +1,6 @@
 #include "Player.h"
 #include "../core/Constants.h"
+#include "../core/Profiler.h"
 #include "raylib.h"
 
 Player::Player() {
@@ -10,9 +11,7 @@ Player::Player() {
   isGrounded = false;
   facingRight = true;
   isMoving = false;
-  textureLoaded = false;
-  deathSpriteLoaded = false;
-  deathSprite = {0};
+  deathSprite = Resources::TextureHandle();
 
   maxHp = 5.0f;
   hp = maxHp;
@@ -32,48 +31,52 @@ void Player::TakeDamage(float amount) {
 void Player::Die() { isDead = true; }
 
 void Player::Draw() {
-  if (isDead && deathSpriteLoaded) {
+  const Texture2D &death = Resources::GetTexture(deathSprite);
+  if (isDead && death.id != 0) {
     // Draw death sprite
-    Rectangle source = {0, 0, (float)deathSprite.width,
-                        (float)deathSprite.height};
+    Rectangle source = {0, 0, (float)death.width, (float)death.height};
     Rectangle dest = {position.x, position.y, width, height};
-    DrawTexturePro(deathSprite, source, dest, {0, 0}, 0.0f, WHITE);
+    DrawSprite(deathSprite, source, dest);
     return;
   }
 
-  if (isMoving && animated && spritesheet.id != 0) {
+  const Texture2D &sheet = Resources::GetTexture(spritesheet);
+  const Texture2D &tex = Resources::GetTexture(sprite);
+  if (isMoving && animated && sheet.id != 0) {
     // Draw walking animation from spritesheet
-    float frameW = (float)spritesheet.width / (float)frameCount;
-    float frameH = (float)spritesheet.height;
+    float frameW = (float)sheet.width / (float)frameCount;
+    float frameH = (float)sheet.height;
     Rectangle source = {frameW * currentFrame, 0, frameW, frameH};
     // Flip horizontally if facing left
     if (!facingRight)
       source.width *= -1;
     Rectangle dest = {position.x, position.y, width, height};
-    DrawTexturePro(spritesheet, source, dest, {0, 0}, 0.0f, WHITE);
-  } else if (textureLoaded) {
+    DrawSprite(spritesheet, source, dest, currentFrame);
+  } else if (tex.id != 0) {
     // Draw idle sprite
-    Rectangle source = {0, 0, (float)sprite.width, (float)sprite.height};
+    Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
     // Flip if facing left
     if (!facingRight)
       source.width *= -1;
     Rectangle dest = {position.x, position.y, width, height};
-    DrawTexturePro(sprite, source, dest, {0, 0}, 0.0f, WHITE);
+    DrawSprite(sprite, source, dest);
   } else {
     // Fallback debug draw
-    DrawRectangleV(position, {width, height}, RED);
+    Render::DrawRectangleV(position, {width, height}, RED);
   }
 }
 
-void Player::Update(float delta, const std::vector<Platform> &platforms,
+void Player::Update(float delta, const PlayerInput &input, const Level &level,
                     bool isDayTime) {
+  PROFILE_SCOPE("Player::Update");
+
   // --- INPUT ---
   isMoving = false;
-  if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) {
+  if (input.left) {
     velocity.x = -speed;
     facingRight = false;
     isMoving = true;
-  } else if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) {
+  } else if (input.right) {
     velocity.x = speed;
     facingRight = true;
     isMoving = true;
@@ -81,7 +84,7 @@ void Player::Update(float delta, const std::vector<Platform> &platforms,
     velocity.x = 0;
   }
 
-  if ((IsKeyPressed(KEY_SPACE)) && isGrounded) {
+  if (input.jump && isGrounded) {
     velocity.y = -jumpForce;
     isGrounded = false;
   }
@@ -106,10 +109,8 @@ void Player::Update(float delta, const std::vector<Platform> &platforms,
   // Update rect for collision check
   Rectangle playerRect = GetRect();
 
-  for (const auto &plat : platforms) {
-    if (!plat.IsSolid(isDayTime))
-      continue;
-
+  // Only platforms near the player (baked broadphase, solid ones only)
+  level.ForEachSolid(playerRect, isDayTime, [&](const Platform &plat) {
     if (CheckCollisionRecs(playerRect, plat.rect)) {
       // Collision on X
       if (velocity.x > 0) {
@@ -121,7 +122,7 @@ void Player::Update(float delta, const std::vector<Platform> &platforms,
       }
       velocity.x = 0;
     }
-  }
+  });
 
   // 2. Vertical Pass
   velocity.y += Core::GRAVITY * delta;
@@ -131,10 +132,7 @@ void Player::Update(float delta, const std::vector<Platform> &platforms,
   playerRect = GetRect();
   isGrounded = false; // Assume falling
 
-  for (const auto &plat : platforms) {
-    if (!plat.IsSolid(isDayTime))
-      continue;
-
+  level.ForEachSolid(playerRect, isDayTime, [&](const Platform &plat) {
     if (CheckCollisionRecs(playerRect, plat.rect)) {
       // Collision on Y
       if (velocity.y > 0) {
@@ -154,5 +152,5 @@ void Player::Update(float delta, const std::vector<Platform> &platforms,
         velocity.y = 0;
       }
     }
-  }
+  });
 }
@@ -1,10 +1,20 @@
 #pragma once
-#include "../world/Platform.h"
+#include "../world/Level.h"
 #include "Entity.h"
 #include <vector>
 
+// Controls for one update, sampled by whoever drives the player (keyboard,
+// a replay, a bot)
+struct PlayerInput {
+  bool left = false;
+  bool right = false;
+  bool jump = false; // Pressed since the last update
+};
+
 class Player : public Entity {
 public:
+  static constexpr float SIZE = 0.12f; // x SCREEN_HEIGHT (cropped sprites)
+
   Vector2 velocity;
   bool isGrounded;
   float speed;
@@ -20,8 +30,7 @@ public:
   bool isDead;
 
   // Extra textures
-  Texture2D deathSprite;
-  bool deathSpriteLoaded;
+  Resources::TextureHandle deathSprite;
 
   void TakeDamage(float amount);
   void Die();
@@ -29,7 +38,7 @@ public:
   Player();
 
   // Custom Update signature to include Platform collision context
-  void Update(float delta, const std::vector<Platform> &platforms,
+  void Update(float delta, const PlayerInput &input, const Level &level,
               bool isDayTime);
   void Draw() override;
 };
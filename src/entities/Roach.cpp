@@ -2,14 +2,15 @@
 #include "raylib.h"
 
 void Roach::Draw() {
-  if (textureLoaded) {
+  const Texture2D &tex = Resources::GetTexture(sprite);
+  if (tex.id != 0) {
     // Scale sprite to match entity dimensions
-    Rectangle source = {0, 0, (float)sprite.width, (float)sprite.height};
+    Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
     Rectangle dest = {position.x, position.y, width, height};
-    DrawTexturePro(sprite, source, dest, {0, 0}, 0.0f, WHITE);
+    DrawSprite(sprite, source, dest);
   } else {
     // Draw Roach shape (e.g. Brown Rectangle)
-    DrawRectangleV(position, {width, height}, BROWN);
+    Render::DrawRectangleV(position, {width, height}, BROWN);
   }
 }
 
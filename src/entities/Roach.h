@@ -3,7 +3,7 @@
 
 class Roach : public Enemy {
 public:
-  Roach(Vector2 pos) : Enemy(pos) { speed = 100.0f; }
+  Roach(Vector2 pos) : Enemy(pos, EnemyType::ROACH) { speed = 100.0f; }
 
   void Draw() override;
   void Update(float dt, const Level &level) override;
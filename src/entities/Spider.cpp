@@ -26,19 +26,10 @@ void Spider::Update(float dt, const Level &level) {
   }
 
   // 2. Platform Edge Detection
-  // find the platform we are on
-  bool onPlatform = false;
   // Look ahead point: Bottom Center + offset
   float lookAheadX =
       movingRight ? (myRect.x + myRect.width + 5) : (myRect.x - 5);
-  Vector2 footPos = {lookAheadX, myRect.y + myRect.height + 2};
-
-  for (const auto &plat : level.platforms) {
-    if (CheckCollisionPointRec(footPos, plat.rect)) {
-      onPlatform = true; // We have ground ahead
-      break;
-    }
-  }
+  bool onPlatform = HasGround(lookAheadX, myRect.y + myRect.height + 1, level);
 
   if (!onPlatform) {
     // No ground ahead, turn around
@@ -49,28 +40,30 @@ void Spider::Update(float dt, const Level &level) {
 }
 
 void Spider::Draw() {
-  if (animated && spritesheet.id != 0) {
+  const Texture2D &sheet = Resources::GetTexture(spritesheet);
+  const Texture2D &tex = Resources::GetTexture(sprite);
+  if (animated && sheet.id != 0) {
     // Draw current frame from spritesheet
-    float frameW = (float)spritesheet.width / (float)frameCount;
-    float frameH = (float)spritesheet.height;
+    float frameW = (float)sheet.width / (float)frameCount;
+    float frameH = (float)sheet.height;
     Rectangle source = {frameW * currentFrame, 0, frameW, frameH};
     // Flip sprite if moving left
     if (!movingRight)
       source.width *= -1;
     Rectangle dest = {position.x, position.y, width, height};
-    DrawTexturePro(spritesheet, source, dest, {0, 0}, 0.0f, WHITE);
-  } else if (textureLoaded) {
+    DrawSprite(spritesheet, source, dest, currentFrame);
+  } else if (tex.id != 0) {
     // Scale sprite to match entity dimensions
-    Rectangle source = {0, 0, (float)sprite.width, (float)sprite.height};
+    Rectangle source = {0, 0, (float)tex.width, (float)tex.height};
     if (!movingRight)
       source.width *= -1;
     Rectangle dest = {position.x, position.y, width, height};
-    DrawTexturePro(sprite, source, dest, {0, 0}, 0.0f, WHITE);
+    DrawSprite(sprite, source, dest);
   } else {
     // Draw Spider shape (e.g. Purple Rectangle)
-    DrawRectangleV(position, {width, height}, PURPLE);
+    Render::DrawRectangleV(position, {width, height}, PURPLE);
     // Draw eyes to show direction
     float eyeX = movingRight ? (position.x + width - 10) : (position.x + 5);
-    DrawRectangle(eyeX, position.y + 10, 5, 5, RED);
+    Render::DrawRectangle(eyeX, position.y + 10, 5, 5, RED);
   }
 }
@@ -1,16 +1,28 @@
 #include "Game.h"
 #include "core/Constants.h"
+#include <cstring>
+
+int main(int argc, char **argv) {
+  // --replay <file>: play a recorded session back and quit (see Replay)
+  const char *replayPath = nullptr;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--replay") == 0)
+      replayPath = argv[++i];
+  }
 
-int main() {
   InitWindow(Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT, "Reino de Aragon");
   SetExitKey(0); // Disable ESC closing window - we handle ESC for settings menu
-  SetTargetFPS(60);
+  // Uncapped while playing back, so frame times measure the frames' work
+  SetTargetFPS(replayPath != nullptr ? 0 : 60);
   InitAudioDevice(); // Initialize audio system
 
   Game game;
   game.Init();
+  int status = 0;
+  if (replayPath != nullptr && !game.PlayReplay(replayPath))
+    status = 1;
 
-  while (!WindowShouldClose()) {
+  while (status == 0 && !WindowShouldClose() && !game.ShouldQuit()) {
     game.Update();
     game.Draw();
   }
@@ -18,5 +30,5 @@ int main() {
   game.Unload();
   CloseAudioDevice(); // Close audio system
   CloseWindow();
-  return 0;
-}
\ No newline at end of file
+  return status;
+}
@@ -0,0 +1,270 @@
+#include "BakedLevel.h"
+#include <cmath>
+#include <cstring>
+
+using namespace LevelFormat;
+
+namespace {
+
+// Appends 8-byte aligned arrays and records where they went
+class Writer {
+public:
+  std::vector<unsigned char> bytes;
+
+  template <typename T> Section Add(const T *items, size_t count) {
+    uint32_t offset = AlignUp((uint32_t)bytes.size(), 8);
+    bytes.resize(offset + count * sizeof(T));
+    if (count > 0)
+      memcpy(bytes.data() + offset, items, count * sizeof(T));
+    return {offset, (uint32_t)count};
+  }
+
+  template <typename T> Section Add(const std::vector<T> &items) {
+    return Add(items.data(), items.size());
+  }
+};
+
+bool SolidAt(PlatformType type, bool isDay) {
+  switch (type) {
+  case PlatformType::FLOWER:
+    return isDay;
+  case PlatformType::MUSHROOM:
+    return !isDay;
+  default:
+    return true;
+  }
+}
+
+// Flowers sink while it is night (Game::UpdateGameplay): not binned
+bool IsDynamic(PlatformType type) { return type == PlatformType::FLOWER; }
+
+uint16_t Cell(float v, uint32_t cells) {
+  float cell = v * (float)cells;
+  if (cell <= 0.0f)
+    return 0;
+  return (uint16_t)std::min((uint32_t)cell, cells - 1);
+}
+
+// Ground under a spawn, grown over static night-solid platforms at the same
+// height that touch it. Returns false if the enemy does not stand on any.
+bool FindPatrolSpan(const LevelData &data, const LevelData::EnemyDef &enemy,
+                    PatrolSpan &span) {
+  const float EPSILON = 0.001f;
+  float footY = enemy.position.y + LevelData::EnemySize(enemy.type);
+
+  auto walkable = [](const LevelData::PlatformDef &p) {
+    return !IsDynamic(p.type) && SolidAt(p.type, false) &&
+           p.type != PlatformType::INVISIBLE;
+  };
+
+  // Same point Enemy::Update tests: bottom corner, just below the feet
+  int start = -1;
+  for (size_t i = 0; i < data.platforms.size(); i++) {
+    const Rectangle &r = data.platforms[i].rect;
+    if (walkable(data.platforms[i]) && enemy.position.x >= r.x &&
+        enemy.position.x < r.x + r.width && footY + EPSILON >= r.y &&
+        footY + EPSILON < r.y + r.height) {
+      start = (int)i;
+      break;
+    }
+  }
+  if (start < 0)
+    return false;
+
+  const Rectangle &ground = data.platforms[start].rect;
+  span = {ground.x, ground.x + ground.width, ground.y, (uint32_t)start};
+  for (bool grown = true; grown;) {
+    grown = false;
+    for (const auto &p : data.platforms) {
+      const Rectangle &r = p.rect;
+      if (!walkable(p) || std::fabs(r.y - span.y) > EPSILON)
+        continue;
+      if (r.x <= span.maxX + EPSILON && r.x + r.width >= span.minX - EPSILON &&
+          (r.x < span.minX || r.x + r.width > span.maxX)) {
+        span.minX = std::min(span.minX, r.x);
+        span.maxX = std::max(span.maxX, r.x + r.width);
+        grown = true;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+BakedLevel::BakedLevel() {
+  header = nullptr;
+  platforms = nullptr;
+  solid[0] = solid[1] = nullptr;
+  cellStart = nullptr;
+  cellItems = nullptr;
+  dynamic = nullptr;
+  enemies = nullptr;
+  patrols = nullptr;
+  strings = nullptr;
+}
+
+std::vector<unsigned char> BakedLevel::Bake(const LevelData &data) {
+  uint32_t platformCount = (uint32_t)data.platforms.size();
+  uint32_t maskWords = (platformCount + 31) / 32;
+
+  // Platforms, masks and grid binning
+  std::vector<Platform> records(platformCount);
+  std::vector<uint32_t> solidDay(maskWords, 0), solidNight(maskWords, 0);
+  std::vector<std::vector<uint32_t>> cells(GRID_COLUMNS * GRID_ROWS);
+  std::vector<uint32_t> dynamicList;
+  for (uint32_t i = 0; i < platformCount; i++) {
+    const LevelData::PlatformDef &def = data.platforms[i];
+    Platform &p = records[i];
+    p.x = def.rect.x;
+    p.y = def.rect.y;
+    p.width = def.rect.width;
+    p.height = def.rect.height;
+    p.type = (uint32_t)def.type;
+    p.cell[0] = Cell(p.x, GRID_COLUMNS);
+    p.cell[1] = Cell(p.y, GRID_ROWS);
+    p.cell[2] = Cell(p.x + p.width, GRID_COLUMNS);
+    p.cell[3] = Cell(p.y + p.height, GRID_ROWS);
+    p.reserved = 0;
+
+    if (SolidAt(def.type, true))
+      solidDay[i >> 5] |= 1u << (i & 31);
+    if (SolidAt(def.type, false))
+      solidNight[i >> 5] |= 1u << (i & 31);
+
+    if (IsDynamic(def.type)) {
+      dynamicList.push_back(i);
+      continue;
+    }
+    for (uint32_t cy = p.cell[1]; cy <= p.cell[3]; cy++)
+      for (uint32_t cx = p.cell[0]; cx <= p.cell[2]; cx++)
+        cells[cy * GRID_COLUMNS + cx].push_back(i);
+  }
+
+  std::vector<uint32_t> cellStart, cellItems;
+  for (const auto &cell : cells) {
+    cellStart.push_back((uint32_t)cellItems.size());
+    cellItems.insert(cellItems.end(), cell.begin(), cell.end());
+  }
+  cellStart.push_back((uint32_t)cellItems.size());
+
+  // Enemies and their patrol spans
+  std::vector<Enemy> enemyRecords;
+  std::vector<PatrolSpan> spans;
+  for (const auto &def : data.enemies) {
+    Enemy e = {def.position.x, def.position.y, (uint32_t)def.type,
+               def.movingRight ? 1u : 0u, NONE, 0};
+    PatrolSpan span;
+    if (FindPatrolSpan(data, def, span)) {
+      e.patrol = (uint32_t)spans.size();
+      spans.push_back(span);
+    }
+    enemyRecords.push_back(e);
+  }
+
+  // Asset paths
+  std::vector<char> stringBytes;
+  auto addString = [&](const std::string &s) -> uint32_t {
+    if (s.empty())
+      return NONE;
+    uint32_t offset = (uint32_t)stringBytes.size();
+    stringBytes.insert(stringBytes.end(), s.begin(), s.end());
+    stringBytes.push_back('\0');
+    return offset;
+  };
+
+  Header h = {};
+  memcpy(h.magic, MAGIC, 4);
+  h.version = VERSION;
+  h.flags = data.isDay ? (uint32_t)FLAG_DAY : 0u;
+  h.spawn[0] = data.spawnPoint.x;
+  h.spawn[1] = data.spawnPoint.y;
+  h.sun[0] = data.sunPosition.x;
+  h.sun[1] = data.sunPosition.y;
+  h.exit[0] = data.exitZone.x;
+  h.exit[1] = data.exitZone.y;
+  h.exit[2] = data.exitZone.width;
+  h.exit[3] = data.exitZone.height;
+  h.gridColumns = GRID_COLUMNS;
+  h.gridRows = GRID_ROWS;
+  h.background = addString(data.backgroundPath);
+  h.foreground = addString(data.foregroundPath);
+  h.dayMusic = addString(data.dayMusicPath);
+  h.nightMusic = addString(data.nightMusicPath);
+
+  Writer out;
+  out.bytes.resize(sizeof(Header));
+  h.platforms = out.Add(records);
+  h.solidDay = out.Add(solidDay);
+  h.solidNight = out.Add(solidNight);
+  h.cellStart = out.Add(cellStart);
+  h.cellItems = out.Add(cellItems);
+  h.dynamic = out.Add(dynamicList);
+  h.enemies = out.Add(enemyRecords);
+  h.patrols = out.Add(spans);
+  h.strings = out.Add(stringBytes);
+  h.totalSize = (uint32_t)out.bytes.size();
+  memcpy(out.bytes.data(), &h, sizeof(h));
+  return out.bytes;
+}
+
+bool BakedLevel::Attach(const unsigned char *data, size_t size) {
+  *this = BakedLevel();
+  if (data == nullptr || size < sizeof(Header) ||
+      ((uintptr_t)data & 7) != 0)
+    return false;
+  const Header *h = (const Header *)data;
+  if (memcmp(h->magic, MAGIC, 4) != 0 || h->version != VERSION ||
+      h->totalSize > size || h->gridColumns == 0 || h->gridRows == 0)
+    return false;
+
+  // Every section inside the blob, with the counts the others imply
+  auto fits = [&](const Section &s, size_t itemSize) {
+    return s.offset % 8 == 0 &&
+           (uint64_t)s.offset + (uint64_t)s.count * itemSize <= h->totalSize;
+  };
+  uint32_t maskWords = (h->platforms.count + 31) / 32;
+  uint32_t cellCount = h->gridColumns * h->gridRows;
+  if (!fits(h->platforms, sizeof(Platform)) ||
+      !fits(h->solidDay, 4) || h->solidDay.count != maskWords ||
+      !fits(h->solidNight, 4) || h->solidNight.count != maskWords ||
+      !fits(h->cellStart, 4) || h->cellStart.count != cellCount + 1 ||
+      !fits(h->cellItems, 4) || !fits(h->dynamic, 4) ||
+      !fits(h->enemies, sizeof(Enemy)) ||
+      !fits(h->patrols, sizeof(PatrolSpan)) || !fits(h->strings, 1))
+    return false;
+
+  // Offsets to pointers: all a load does besides the range checks below
+  header = h;
+  platforms = (const Platform *)(data + h->platforms.offset);
+  solid[0] = (const uint32_t *)(data + h->solidDay.offset);
+  solid[1] = (const uint32_t *)(data + h->solidNight.offset);
+  cellStart = (const uint32_t *)(data + h->cellStart.offset);
+  cellItems = (const uint32_t *)(data + h->cellItems.offset);
+  dynamic = (const uint32_t *)(data + h->dynamic.offset);
+  enemies = (const Enemy *)(data + h->enemies.offset);
+  patrols = (const PatrolSpan *)(data + h->patrols.offset);
+  strings = (const char *)(data + h->strings.offset);
+
+  // Indices stay in range (a damaged file must not index past the arrays)
+  bool ok = cellStart[cellCount] <= h->cellItems.count;
+  for (uint32_t i = 0; ok && i < cellCount; i++)
+    ok = cellStart[i] <= cellStart[i + 1];
+  for (uint32_t i = 0; ok && i < h->cellItems.count; i++)
+    ok = cellItems[i] < h->platforms.count;
+  for (uint32_t i = 0; ok && i < h->dynamic.count; i++)
+    ok = dynamic[i] < h->platforms.count;
+  for (uint32_t i = 0; ok && i < h->enemies.count; i++)
+    ok = enemies[i].patrol == NONE || enemies[i].patrol < h->patrols.count;
+  if (!ok || (h->strings.count > 0 && strings[h->strings.count - 1] != '\0')) {
+    *this = BakedLevel();
+    return false;
+  }
+  return true;
+}
+
+const char *BakedLevel::GetString(uint32_t offset) const {
+  if (offset == NONE || offset >= header->strings.count)
+    return "";
+  return strings + offset;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "LevelData.h"
+#include "LevelFormat.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Read-only view of a baked level blob (see LevelFormat.h): collision
+// data ready to use, with no construction at load time.
+class BakedLevel {
+public:
+  // Which platforms a query reports
+  enum class Solidity { DAY, NIGHT, ANY };
+
+  BakedLevel();
+
+  // Serialise a parsed level together with its derived data (solidity
+  // masks, broadphase grid, patrol spans)
+  static std::vector<unsigned char> Bake(const LevelData &data);
+
+  // Validate a blob and point into it. No copy: the bytes must stay alive
+  // (and unmoved) as long as the view is used.
+  bool Attach(const unsigned char *data, size_t size);
+  bool IsValid() const { return header != nullptr; }
+
+  const LevelFormat::Header &GetHeader() const { return *header; }
+  const char *GetString(uint32_t offset) const; // "" for NONE
+
+  uint32_t GetPlatformCount() const { return header->platforms.count; }
+  const LevelFormat::Platform &GetPlatform(uint32_t i) const {
+    return platforms[i];
+  }
+  bool IsSolid(uint32_t platform, Solidity when) const;
+
+  uint32_t GetEnemyCount() const { return header->enemies.count; }
+  const LevelFormat::Enemy &GetEnemy(uint32_t i) const { return enemies[i]; }
+  const LevelFormat::PatrolSpan &GetPatrol(uint32_t i) const {
+    return patrols[i];
+  }
+
+  // Visit, in index order, each platform matching 'when' whose static
+  // rectangle overlaps [x0, x1] x [y0, y1] (normalised), and every moving
+  // one. Callers still test the actual rectangles.
+  template <typename Visit>
+  void Query(float x0, float y0, float x1, float y1, Solidity when,
+             Visit &&visit) const;
+
+private:
+  const LevelFormat::Header *header;
+  const LevelFormat::Platform *platforms;
+  const uint32_t *solid[2]; // Day, night
+  const uint32_t *cellStart;
+  const uint32_t *cellItems;
+  const uint32_t *dynamic;
+  const LevelFormat::Enemy *enemies;
+  const LevelFormat::PatrolSpan *patrols;
+  const char *strings;
+
+  uint32_t CellX(float x) const;
+  uint32_t CellY(float y) const;
+};
+
+inline bool BakedLevel::IsSolid(uint32_t platform, Solidity when) const {
+  if (when == Solidity::ANY)
+    return true;
+  const uint32_t *mask = solid[when == Solidity::DAY ? 0 : 1];
+  return (mask[platform >> 5] >> (platform & 31)) & 1u;
+}
+
+inline uint32_t BakedLevel::CellX(float x) const {
+  float cell = x * (float)header->gridColumns;
+  return cell <= 0.0f ? 0
+                      : std::min((uint32_t)cell, header->gridColumns - 1);
+}
+
+inline uint32_t BakedLevel::CellY(float y) const {
+  float cell = y * (float)header->gridRows;
+  return cell <= 0.0f ? 0 : std::min((uint32_t)cell, header->gridRows - 1);
+}
+
+template <typename Visit>
+void BakedLevel::Query(float x0, float y0, float x1, float y1, Solidity when,
+                       Visit &&visit) const {
+  // Candidates are gathered and sorted so callers see the same order as a
+  // plain loop over the platforms (collision response depends on it)
+  uint32_t local[64];
+  std::vector<uint32_t> spill;
+  uint32_t count = 0;
+  auto add = [&](uint32_t i) {
+    if (!IsSolid(i, when))
+      return;
+    if (count < 64)
+      local[count] = i;
+    else
+      spill.push_back(i);
+    count++;
+  };
+
+  uint32_t cx0 = CellX(x0), cx1 = CellX(x1);
+  uint32_t cy0 = CellY(y0), cy1 = CellY(y1);
+  for (uint32_t cy = cy0; cy <= cy1; cy++) {
+    for (uint32_t cx = cx0; cx <= cx1; cx++) {
+      uint32_t cell = cy * header->gridColumns + cx;
+      for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+        uint32_t i = cellItems[k];
+        // A platform spanning several cells is reported from the first
+        // cell it shares with the query only
+        const uint16_t *c = platforms[i].cell;
+        if (cx == std::max<uint32_t>(cx0, c[0]) &&
+            cy == std::max<uint32_t>(cy0, c[1]))
+          add(i);
+      }
+    }
+  }
+  for (uint32_t k = 0; k < header->dynamic.count; k++)
+    add(dynamic[k]);
+
+  if (count <= 64) {
+    std::sort(local, local + count);
+    for (uint32_t k = 0; k < count; k++)
+      visit(local[k]);
+  } else {
+    spill.insert(spill.end(), local, local + 64);
+    std::sort(spill.begin(), spill.end());
+    for (uint32_t i : spill)
+      visit(i);
+  }
+}
@@ -0,0 +1,61 @@
+#include "Collision.h"
+#include <cmath>
+
+// Helper: Check collision between a Line and a Rectangle
+bool CheckCollisionLineRect(Vector2 start, Vector2 end, Rectangle rect) {
+  // Check if either point is INSIDE
+  if (CheckCollisionPointRec(start, rect) || CheckCollisionPointRec(end, rect))
+    return true;
+
+  // Check against 4 edges
+  Vector2 p1 = {rect.x, rect.y};
+  Vector2 p2 = {rect.x + rect.width, rect.y};
+  Vector2 p3 = {rect.x + rect.width, rect.y + rect.height};
+  Vector2 p4 = {rect.x, rect.y + rect.height};
+
+  Vector2 collisionPoint;
+  if (CheckCollisionLines(start, end, p1, p2, &collisionPoint))
+    return true;
+  if (CheckCollisionLines(start, end, p2, p3, &collisionPoint))
+    return true;
+  if (CheckCollisionLines(start, end, p3, p4, &collisionPoint))
+    return true;
+  if (CheckCollisionLines(start, end, p4, p1, &collisionPoint))
+    return true;
+
+  return false;
+}
+
+// Ray Intersection Helper
+Vector2 GetRayIntersection(Vector2 start, Vector2 end, const Level &level,
+                           bool isDay) {
+  float minT = 1.0f;
+
+  Rectangle span = {fminf(start.x, end.x), fminf(start.y, end.y),
+                    fabsf(end.x - start.x), fabsf(end.y - start.y)};
+  level.ForEachSolid(span, isDay, [&](const Platform &plat) {
+    if (CheckCollisionLineRect(start, end, plat.rect)) {
+      float t0 = 0.0f;
+      float t1 = minT;
+      for (int i = 0; i < 8; i++) {
+        float mid = t0 + (t1 - t0) * 0.5f;
+        Vector2 midPoint = {start.x + (end.x - start.x) * mid,
+                            start.y + (end.y - start.y) * mid};
+        if (CheckCollisionPointRec(midPoint, plat.rect)) {
+          t1 = mid;
+        } else {
+          if (CheckCollisionLineRect(start, midPoint, plat.rect)) {
+            t1 = mid;
+          } else {
+            t0 = mid;
+          }
+        }
+      }
+      if (t1 < minT)
+        minT = t1;
+    }
+  });
+
+  return {start.x + (end.x - start.x) * minT,
+          start.y + (end.y - start.y) * minT};
+}
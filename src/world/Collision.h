@@ -0,0 +1,11 @@
+#pragma once
+#include "Level.h"
+#include "raylib.h"
+
+// Segment vs rectangle: true if the segment touches it (or an end is inside)
+bool CheckCollisionLineRect(Vector2 start, Vector2 end, Rectangle rect);
+
+// First point along start -> end inside a platform solid at this time of
+// day ('end' if the way is clear)
+Vector2 GetRayIntersection(Vector2 start, Vector2 end, const Level &level,
+                           bool isDay);
@@ -1,50 +1,239 @@
 #include "Level.h"
 #include "../core/Constants.h"
+#include <cstring>
 
 Level::Level() {
   spawnPoint = {100, 300};
   isDay = true;
   sunPosition = {100, 100};
   exitZone = {0, 0, 0, 0};
-  foregroundDay = {0};
-  foregroundNight = {0};
   hasForeground = false;
   dayMusic = {0};
   nightMusic = {0};
   hasDayMusic = false;
   hasNightMusic = false;
+  layoutWidth = (float)Core::SCREEN_WIDTH;
+  layoutHeight = (float)Core::SCREEN_HEIGHT;
+  watchTimes[0] = watchTimes[1] = 0;
 }
 
-void Level::Unload() {
-  // Unload background textures
-  UnloadTexture(std::get<0>(backgrounds));
-  UnloadTexture(std::get<1>(backgrounds));
+namespace {
+
+long ModTime(const std::string &path) {
+  return FileExists(path.c_str()) ? GetFileModTime(path.c_str()) : 0;
+}
+
+std::shared_ptr<AssetBytes> BakeText(const LevelData &data) {
+  auto bytes = std::make_shared<AssetBytes>();
+  bytes->storage = BakedLevel::Bake(data);
+  bytes->data = bytes->storage.data();
+  bytes->size = bytes->storage.size();
+  return bytes;
+}
+
+bool SamePlace(const Platform &a, const Platform &b) {
+  return a.type == b.type && a.rect.x == b.rect.x &&
+         a.rect.width == b.rect.width && a.rect.height == b.rect.height &&
+         a.initialY == b.initialY;
+}
+
+} // namespace
+
+bool Level::Attach(std::shared_ptr<const AssetBytes> bytes,
+                   const char *path) {
+  // Into a new view first: on failure the current one stays usable
+  BakedLevel view;
+  if (!view.Attach(bytes->data, bytes->size)) {
+    TraceLog(LOG_WARNING, "LEVEL: %s: not a valid baked level", path);
+    return false;
+  }
+  baked = view;
+  blob = std::move(bytes);
+  return true;
+}
+
+bool Level::Load(const char *path) {
+  bool loaded = false;
+  std::string textPath = path;
+  const char *ext = GetFileExtension(path);
+  if (ext != nullptr && strcmp(ext, ".lvlb") == 0) {
+    // Used in place (mapped from the pack); copied only if misaligned
+    auto bytes = std::make_shared<AssetBytes>(AssetFiles::Read(path));
+    if (bytes->IsValid() && ((uintptr_t)bytes->data & 7) != 0 &&
+        bytes->storage.empty()) {
+      bytes->storage.assign(bytes->data, bytes->data + bytes->size);
+      bytes->data = bytes->storage.data();
+    }
+    loaded = bytes->IsValid() && Attach(bytes, path);
+    // A stale or damaged bake falls back to the source next to it
+    textPath.resize(textPath.size() - 1);
+  }
+
+  if (!loaded) {
+    LevelData data;
+    if (!data.Load(textPath.c_str()) ||
+        !Attach(BakeText(data), textPath.c_str()))
+      return false;
+  }
+
+  watchPaths[0] = textPath;
+  watchPaths[1] = textPath + "b";
+  for (int i = 0; i < 2; i++)
+    watchTimes[i] = ModTime(watchPaths[i]);
+  sourcePath = path;
+  ReadHeader(path);
+  return true;
+}
+
+bool Level::Load(const LevelData &data, const char *name) {
+  if (!Attach(BakeText(data), name))
+    return false;
+  for (int i = 0; i < 2; i++) {
+    watchPaths[i].clear();
+    watchTimes[i] = 0;
+  }
+  sourcePath = name;
+  ReadHeader(name);
+  return true;
+}
+
+void Level::ReadHeader(const char *path) {
+  const LevelFormat::Header &h = baked.GetHeader();
+  assets = AssetGroup(GetFileNameWithoutExt(path));
+  dayBackgroundPath = baked.GetString(h.background);
+  foregroundPath = baked.GetString(h.foreground);
+  hasForeground = !foregroundPath.empty();
+  dayMusicPath = baked.GetString(h.dayMusic);
+  nightMusicPath = baked.GetString(h.nightMusic);
+  isDay = (h.flags & LevelFormat::FLAG_DAY) != 0;
+}
+
+void Level::Layout(float W, float H) {
+  layoutWidth = W;
+  layoutHeight = H;
 
-  // Unload foreground textures
-  if (hasForeground) {
-    if (foregroundDay.id != 0)
-      UnloadTexture(foregroundDay);
-    if (foregroundNight.id != 0)
-      UnloadTexture(foregroundNight);
+  platforms.clear();
+  platforms.reserve(baked.GetPlatformCount());
+  for (uint32_t i = 0; i < baked.GetPlatformCount(); i++) {
+    const LevelFormat::Platform &p = baked.GetPlatform(i);
+    platforms.push_back(Platform({p.x * W, p.y * H, p.width * W, p.height * H},
+                                 (PlatformType)p.type));
   }
 
-  // Unload music
-  if (hasDayMusic)
-    UnloadMusicStream(dayMusic);
-  if (hasNightMusic)
-    UnloadMusicStream(nightMusic);
+  enemies.clear();
+  for (uint32_t i = 0; i < baked.GetEnemyCount(); i++) {
+    const LevelFormat::Enemy &e = baked.GetEnemy(i);
+    EnemyConfig config = {{e.x * W, e.y * H},
+                          {0, 0},
+                          e.movingRight != 0,
+                          -1,
+                          (EnemyType)e.type};
+    if (e.patrol != LevelFormat::NONE) {
+      const LevelFormat::PatrolSpan &span = baked.GetPatrol(e.patrol);
+      config.patrolRange = {span.minX * W, span.maxX * W};
+      config.platformIndex = (int)span.platform;
+    }
+    enemies.push_back(config);
+  }
+
+  const LevelFormat::Header &h = baked.GetHeader();
+  spawnPoint = {h.spawn[0] * W, h.spawn[1] * H};
+  sunPosition = {h.sun[0] * W, h.sun[1] * H};
+  exitZone = {h.exit[0] * W, h.exit[1] * H, h.exit[2] * W, h.exit[3] * H};
+}
+
+void Level::Unload() {
+  // Background/foreground references and music were registered with the
+  // group as they came in
+  assets.Release();
 }
 
 bool Level::IsEdge(Vector2 pos) const {
   // Check if there is ground strictly below 'pos'
   Vector2 checkPoint = {pos.x, pos.y + 1.0f};
 
-  for (const auto &plat : platforms) {
-    if (CheckCollisionPointRec(checkPoint, plat.rect)) {
-      // Found ground
+  bool ground = false;
+  auto visit = [&](const Platform &plat) {
+    if (!ground && CheckCollisionPointRec(checkPoint, plat.rect))
+      ground = true;
+  };
+  Query({checkPoint.x, checkPoint.y, 0, 0}, BakedLevel::Solidity::ANY, visit);
+  return !ground;
+}
+
+bool Level::HasChangedOnDisk() const {
+  for (int i = 0; i < 2; i++) {
+    if (!watchPaths[i].empty() && ModTime(watchPaths[i]) != watchTimes[i])
+      return true;
+  }
+  return false;
+}
+
+bool Level::Reload() {
+  long times[2] = {ModTime(watchPaths[0]), ModTime(watchPaths[1])};
+  watchTimes[0] = times[0];
+  watchTimes[1] = times[1];
+
+  // Loose file straight from disk (the pack holds the shipped version)
+  bool useBaked = times[1] > times[0];
+  const char *path = watchPaths[useBaked ? 1 : 0].c_str();
+  std::shared_ptr<AssetBytes> bytes;
+  if (useBaked) {
+    int size = 0;
+    unsigned char *fileData = LoadFileData(path, &size);
+    if (fileData == nullptr)
+      return false;
+    bytes = std::make_shared<AssetBytes>();
+    bytes->storage.assign(fileData, fileData + size);
+    bytes->data = bytes->storage.data();
+    bytes->size = bytes->storage.size();
+    UnloadFileData(fileData);
+  } else {
+    char *text = LoadFileText(path);
+    if (text == nullptr)
       return false;
+    LevelData data;
+    bool parsed = data.Parse(text, strlen(text), path);
+    UnloadFileText(text);
+    if (!parsed)
+      return false; // Parse() logged the line; keep playing the old layout
+    bytes = BakeText(data);
+  }
+  if (!Attach(bytes, path))
+    return false;
+
+  // Asset paths are only read on load: new ones need the level reloaded
+  const LevelFormat::Header &h = baked.GetHeader();
+  if (dayBackgroundPath != baked.GetString(h.background) ||
+      foregroundPath != baked.GetString(h.foreground) ||
+      dayMusicPath != baked.GetString(h.dayMusic) ||
+      nightMusicPath != baked.GetString(h.nightMusic))
+    TraceLog(LOG_WARNING, "LEVEL: %s: asset changes apply on next load", path);
+
+  // Lay out again; platforms still in the same place keep their runtime
+  // state (a flower sunk for the night stays down)
+  std::vector<Platform> previous;
+  previous.swap(platforms);
+  Layout(layoutWidth, layoutHeight);
+  int changed = 0;
+  for (size_t i = 0; i < platforms.size(); i++) {
+    const Platform *match = nullptr;
+    if (i < previous.size() && SamePlace(previous[i], platforms[i])) {
+      match = &previous[i];
+    } else {
+      for (const auto &old : previous) {
+        if (SamePlace(old, platforms[i])) {
+          match = &old;
+          break;
+        }
+      }
     }
+    if (match != nullptr)
+      platforms[i].rect.y = match->rect.y;
+    else
+      changed++;
   }
-  // No ground found
+  TraceLog(LOG_INFO, "LEVEL: Reloaded %s (%d of %d platforms new or moved)",
+           path, changed, (int)platforms.size());
   return true;
 }
@@ -1,13 +1,14 @@
 #pragma once
+#include "../core/AssetGroup.h"
+#include "../core/PackFile.h"
+#include "../core/Resources.h"
+#include "BakedLevel.h"
 #include "Platform.h"
 #include "raylib.h"
+#include <memory>
 #include <string>
-#include <tuple>
 #include <vector>
 
-// Define Enemy Config Struct for Data-Driven Level Loading
-enum class EnemyType { SPIDER, ROACH };
-
 #define roach EnemyType::ROACH
 #define spider EnemyType::SPIDER
 
@@ -22,17 +23,29 @@ struct EnemyConfig {
 
 class Level {
 public:
+  // Baked level (normalised units), viewing 'blob'. Shared so copies of the
+  // level keep pointing at live bytes.
+  std::shared_ptr<const AssetBytes> blob;
+  BakedLevel baked;
+
+  // Screen-space layout of 'baked' (see Layout); platforms keep the baked
+  // order, so platform i is baked platform i
   std::vector<Platform> platforms;
   std::vector<EnemyConfig> enemies;
 
-  // Backgrounds (Day, Night)
-  std::tuple<Texture2D, Texture2D> backgrounds;
+  // Background (night variant/grading handled by the cache and ColorGrade)
+  Resources::TextureHandle background;
 
-  // Foreground layers (Day, Night) - drawn on top of gameplay
-  Texture2D foregroundDay;
-  Texture2D foregroundNight;
+  // Foreground layer - drawn on top of gameplay, through an alpha-trimmed
+  // mesh of its opaque cells
+  Resources::TextureHandle foreground;
   bool hasForeground;
 
+  // Asset files, loaded into the fields above while the level is resident
+  std::string dayBackgroundPath;
+  std::string foregroundPath;
+  AssetGroup assets;
+
   Vector2 spawnPoint;
   Vector2 sunPosition;
   Rectangle exitZone;
@@ -47,6 +60,54 @@ public:
   std::string nightMusicPath;
 
   Level();
-  void Unload();
+
+  // Read a baked level (.lvlb) or a text one (.lvl, baked in memory); asset
+  // paths are set, nothing is loaded yet
+  bool Load(const char *path);
+  // Bake a level built in memory (tools, benchmarks); not watched on disk
+  bool Load(const LevelData &data, const char *name);
+  const std::string &GetPath() const { return sourcePath; } // As loaded
+  // Place the level for a screen size (platforms, enemies, spawn, sun, exit)
+  void Layout(float screenWidth, float screenHeight);
+
+  void Unload(); // Releases the level's assets
   bool IsEdge(Vector2 pos) const;
+
+  // --- Hot reload (loose files on disk, desktop) ---
+  // Has the level's .lvl or .lvlb been written since it was read?
+  bool HasChangedOnDisk() const;
+  // Re-read the newer of the two and rebuild the collision data in place.
+  // Textures and music are kept, and so is the state of platforms that did
+  // not change (sunk flowers). A bad file leaves the level as it was.
+  bool Reload();
+
+  // Visit, in index order, the platforms solid at this time of day that may
+  // overlap 'area' (screen space), through the baked broadphase grid
+  template <typename Visit>
+  void ForEachSolid(Rectangle area, bool isDayTime, Visit &&visit) const {
+    Query(area, isDayTime ? BakedLevel::Solidity::DAY
+                          : BakedLevel::Solidity::NIGHT,
+          visit);
+  }
+
+private:
+  float layoutWidth;
+  float layoutHeight;
+  std::string sourcePath;
+
+  // Source files on disk (text, baked) and their times when last read
+  std::string watchPaths[2];
+  long watchTimes[2];
+
+  bool Attach(std::shared_ptr<const AssetBytes> bytes, const char *path);
+  void ReadHeader(const char *path); // Asset paths and flags
+
+  template <typename Visit>
+  void Query(Rectangle area, BakedLevel::Solidity when, Visit &visit) const {
+    // One pixel of slack so rounding never drops a touching platform
+    baked.Query((area.x - 1.0f) / layoutWidth, (area.y - 1.0f) / layoutHeight,
+                (area.x + area.width + 1.0f) / layoutWidth,
+                (area.y + area.height + 1.0f) / layoutHeight, when,
+                [&](uint32_t i) { visit(platforms[i]); });
+  }
 };
@@ -0,0 +1,200 @@
+#include "LevelData.h"
+#include "../core/PackFile.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Tokens of the current line, read straight from the file buffer
+class Reader {
+public:
+  Reader(const char *text, size_t length, const char *source)
+      : p(text), end(text + length), source(source), line(1) {}
+
+  bool AtEnd() const { return p >= end; }
+
+  // Next token on the current line ("" at the end of the line or a comment)
+  bool Token(const char *&start, size_t &length) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+    start = p;
+    if (p >= end || *p == '\n' || *p == '#') {
+      length = 0;
+      return false;
+    }
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+      p++;
+    length = (size_t)(p - start);
+    return true;
+  }
+
+  bool Word(std::string &out) {
+    const char *start;
+    size_t length;
+    if (!Token(start, length))
+      return Fail("missing value");
+    out.assign(start, length);
+    return true;
+  }
+
+  bool Number(float &out) {
+    const char *start;
+    size_t length;
+    char buffer[32];
+    if (!Token(start, length) || length >= sizeof(buffer))
+      return Fail("missing number");
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    char *parsed;
+    out = strtof(buffer, &parsed);
+    if (parsed != buffer + length)
+      return Fail("bad number");
+    return true;
+  }
+
+  bool Numbers(float *out, int count) {
+    for (int i = 0; i < count; i++) {
+      if (!Number(out[i]))
+        return false;
+    }
+    return true;
+  }
+
+  // Skip the rest of the line; trailing values are an error
+  bool EndLine() {
+    const char *start;
+    size_t length;
+    bool extra = Token(start, length);
+    while (p < end && *p != '\n')
+      p++;
+    if (p < end)
+      p++;
+    line++;
+    return !extra || Fail("unexpected value");
+  }
+
+  bool Fail(const char *message) const {
+    TraceLog(LOG_WARNING, "LEVEL: %s:%d: %s", source, line, message);
+    return false;
+  }
+
+private:
+  const char *p;
+  const char *end;
+  const char *source;
+  int line;
+};
+
+bool ParsePlatformType(const std::string &name, PlatformType &out) {
+  if (name == "basic")
+    out = PlatformType::NORMAL;
+  else if (name == "flower")
+    out = PlatformType::FLOWER;
+  else if (name == "mushroom")
+    out = PlatformType::MUSHROOM;
+  else if (name == "invisible")
+    out = PlatformType::INVISIBLE;
+  else
+    return false;
+  return true;
+}
+
+bool ParseEnemyType(const std::string &name, EnemyType &out) {
+  if (name == "roach")
+    out = EnemyType::ROACH;
+  else if (name == "spider")
+    out = EnemyType::SPIDER;
+  else
+    return false;
+  return true;
+}
+
+} // namespace
+
+bool LevelData::Parse(const char *text, size_t length, const char *source) {
+  *this = LevelData();
+  Reader in(text, length, source);
+
+  std::string key;
+  std::string word;
+  float v[4];
+  bool hasBackground = false;
+  while (!in.AtEnd()) {
+    const char *start;
+    size_t keyLength;
+    if (!in.Token(start, keyLength)) {
+      in.EndLine(); // Blank or comment line
+      continue;
+    }
+    key.assign(start, keyLength);
+
+    bool ok = true;
+    if (key == "background") {
+      ok = in.Word(backgroundPath);
+      hasBackground = true;
+    } else if (key == "foreground") {
+      ok = in.Word(foregroundPath);
+    } else if (key == "music") {
+      ok = in.Word(dayMusicPath) && in.Word(nightMusicPath);
+      if (dayMusicPath == "-")
+        dayMusicPath.clear();
+      if (nightMusicPath == "-")
+        nightMusicPath.clear();
+    } else if (key == "time") {
+      ok = in.Word(word) && (word == "day" || word == "night" ||
+                             in.Fail("time is 'day' or 'night'"));
+      isDay = word == "day";
+    } else if (key == "spawn") {
+      ok = in.Numbers(v, 2);
+      spawnPoint = {v[0], v[1]};
+    } else if (key == "sun") {
+      ok = in.Numbers(v, 2);
+      sunPosition = {v[0], v[1]};
+    } else if (key == "exit") {
+      ok = in.Numbers(v, 4);
+      exitZone = {v[0], v[1], v[2], v[3]};
+    } else if (key == "platform") {
+      PlatformDef def;
+      ok = in.Word(word) &&
+           (ParsePlatformType(word, def.type) ||
+            in.Fail("unknown platform type")) &&
+           in.Numbers(v, 4);
+      def.rect = {v[0], v[1], v[2], v[3]};
+      if (ok)
+        platforms.push_back(def);
+    } else if (key == "enemy") {
+      EnemyDef def;
+      ok = in.Word(word) &&
+           (ParseEnemyType(word, def.type) || in.Fail("unknown enemy type")) &&
+           in.Numbers(v, 2);
+      def.position = {v[0], v[1]};
+      def.movingRight = true;
+      const char *dir;
+      size_t dirLength;
+      if (ok && in.Token(dir, dirLength)) {
+        std::string facing(dir, dirLength);
+        ok = facing == "left" || facing == "right" ||
+             in.Fail("direction is 'left' or 'right'");
+        def.movingRight = facing != "left";
+      }
+      if (ok)
+        enemies.push_back(def);
+    } else {
+      ok = in.Fail("unknown statement");
+    }
+
+    if (!ok || !in.EndLine())
+      return false;
+  }
+
+  if (!hasBackground)
+    return in.Fail("no background");
+  return true;
+}
+
+bool LevelData::Load(const char *path) {
+  AssetBytes bytes = AssetFiles::Read(path);
+  if (!bytes.IsValid())
+    return false;
+  return Parse((const char *)bytes.data, bytes.size, path);
+}
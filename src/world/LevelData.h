@@ -0,0 +1,57 @@
+#pragma once
+#include "../core/Types.h"
+#include "raylib.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A level as stored in assets/levels/levelN.lvl, in normalised units:
+// x and widths in screen widths, y and heights in screen heights, (0, 0)
+// top-left and (1, 1) bottom-right. Level::Layout() places it on screen.
+//
+// One statement per line, '#' starts a comment:
+//
+//   background assets/sprites/level1day.png
+//   foreground assets/sprites/foregroundDay.png     (optional)
+//   music      <day track> <night track>            (either may be '-')
+//   time       day | night
+//   spawn      <x> <y>
+//   sun        <x> <y>
+//   exit       <x> <y> <w> <h>
+//   platform   basic | flower | mushroom | invisible  <x> <y> <w> <h>
+//   enemy      roach | spider  <x> <y>  [left | right]
+struct LevelData {
+  struct PlatformDef {
+    Rectangle rect;
+    PlatformType type;
+  };
+
+  struct EnemyDef {
+    Vector2 position; // Top-left corner
+    EnemyType type;
+    bool movingRight;
+  };
+
+  std::string backgroundPath;
+  std::string foregroundPath; // Empty: no foreground
+  std::string dayMusicPath;   // Empty: no track
+  std::string nightMusicPath;
+  bool isDay = true;
+  Vector2 spawnPoint = {0, 0};
+  Vector2 sunPosition = {0, 0};
+  Rectangle exitZone = {0, 0, 0, 0};
+  std::vector<PlatformDef> platforms;
+  std::vector<EnemyDef> enemies;
+
+  // Enemy width and height, in screen heights
+  static float EnemySize(EnemyType type) {
+    return type == EnemyType::ROACH ? 0.25f : 0.10f;
+  }
+
+  // Single pass over the text; on error logs "<source>:<line>: ..." and
+  // returns false
+  bool Parse(const char *text, size_t length, const char *source);
+
+  // Read through AssetFiles (pack or loose file) and parse
+  bool Load(const char *path);
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layout of a baked level (.lvlb), written by the level compiler
+// (tools/LevelCompiler.cpp) or in memory from a text level. Little-endian,
+// normalised units (see LevelData.h).
+//
+//   Header | platforms | solidity masks | grid | enemies | patrols | strings
+//
+// Every array is addressed by a Section (offset from the start of the blob,
+// element count) and starts on an 8-byte boundary, so a blob read or mapped
+// in one piece is used in place: loading only turns offsets into pointers.
+namespace LevelFormat {
+
+constexpr char MAGIC[4] = {'R', 'L', 'V', 'L'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t NONE = 0xFFFFFFFFu; // No string / patrol span
+
+// Broadphase grid over the screen, (0, 0)-(1, 1). Platforms reaching past
+// the screen are binned in the border cells.
+constexpr uint32_t GRID_COLUMNS = 16;
+constexpr uint32_t GRID_ROWS = 12;
+
+enum Flags : uint32_t {
+  FLAG_DAY = 1, // Level starts at day
+};
+
+struct Section {
+  uint32_t offset;
+  uint32_t count;
+};
+
+struct Header {
+  char magic[4];
+  uint32_t version;
+  uint32_t totalSize; // Bytes of the whole blob
+  uint32_t flags;
+  float spawn[2];
+  float sun[2];
+  float exit[4];
+  uint32_t gridColumns;
+  uint32_t gridRows;
+  Section platforms;  // Platform[]
+  Section solidDay;   // uint32_t[]: bit i set = platform i solid by day
+  Section solidNight; // uint32_t[]: same, by night
+  Section cellStart;  // uint32_t[columns * rows + 1]: ranges of cellItems
+  Section cellItems;  // uint32_t[]: static platform indices per cell
+  Section dynamic;    // uint32_t[]: moving platforms, tested by every query
+  Section enemies;    // Enemy[]
+  Section patrols;    // PatrolSpan[]
+  Section strings;    // char[]: NUL-terminated asset paths
+  uint32_t background; // Offsets into strings, or NONE
+  uint32_t foreground;
+  uint32_t dayMusic;
+  uint32_t nightMusic;
+};
+
+struct Platform {
+  float x, y, width, height;
+  uint32_t type;    // PlatformType
+  uint16_t cell[4]; // Grid cells covered: x0, y0, x1, y1 (inclusive)
+  uint32_t reserved;
+};
+
+struct Enemy {
+  float x, y;
+  uint32_t type; // EnemyType
+  uint32_t movingRight;
+  uint32_t patrol; // Index into patrols, or NONE
+  uint32_t reserved;
+};
+
+// Walkable ground under an enemy: the platform it spawns on, extended over
+// level neighbours that touch it. Turning at its ends matches the edge test.
+struct PatrolSpan {
+  float minX, maxX;
+  float y;           // Top of the ground
+  uint32_t platform; // Platform the enemy spawns on
+};
+
+static_assert(sizeof(Header) == 144, "LevelFormat::Header layout");
+static_assert(sizeof(Platform) == 32, "LevelFormat::Platform layout");
+static_assert(sizeof(Enemy) == 24, "LevelFormat::Enemy layout");
+static_assert(sizeof(PatrolSpan) == 16, "LevelFormat::PatrolSpan layout");
+
+inline uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace LevelFormat
@@ -0,0 +1,274 @@
+#include "Replay.h"
+#include "../core/Constants.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'R', 'P', 'L'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t FLAG_DAY = 1; // Segment starts at day
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  float stepSeconds;
+  uint32_t segmentCount;
+};
+
+struct SegmentHeader {
+  int32_t levelIndex;
+  uint32_t levelHash;
+  uint32_t flags;
+  uint32_t screenWidth;
+  uint32_t screenHeight;
+  uint32_t stepCount;
+  uint32_t pathLength;
+};
+
+static_assert(sizeof(FileHeader) == 16, "Replay file header layout");
+static_assert(sizeof(SegmentHeader) == 28, "Replay segment header layout");
+
+void PutVarint(std::vector<unsigned char> &out, uint32_t value) {
+  while (value >= 0x80) {
+    out.push_back((unsigned char)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((unsigned char)value);
+}
+
+// Sequential reads over a loaded file; any overrun marks it bad
+struct Reader {
+  const unsigned char *data;
+  size_t size;
+  size_t offset = 0;
+  bool ok = true;
+
+  bool Read(void *out, size_t count) {
+    if (!ok || size - offset < count)
+      return ok = false;
+    memcpy(out, data + offset, count);
+    offset += count;
+    return true;
+  }
+
+  uint32_t ReadVarint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      unsigned char byte;
+      if (!Read(&byte, 1))
+        return 0;
+      value |= (uint32_t)(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    ok = false;
+    return 0;
+  }
+};
+
+} // namespace
+
+uint8_t Replay::PackInput(const WorldInput &input) {
+  return (input.player.left ? INPUT_LEFT : 0) |
+         (input.player.right ? INPUT_RIGHT : 0) |
+         (input.player.jump ? INPUT_JUMP : 0) |
+         (input.toggleTime ? INPUT_TOGGLE : 0);
+}
+
+WorldInput Replay::UnpackInput(uint8_t bits) {
+  WorldInput input;
+  input.player.left = (bits & INPUT_LEFT) != 0;
+  input.player.right = (bits & INPUT_RIGHT) != 0;
+  input.player.jump = (bits & INPUT_JUMP) != 0;
+  input.toggleTime = (bits & INPUT_TOGGLE) != 0;
+  return input;
+}
+
+Replay::Replay() { stepSeconds = 1.0f / 60.0f; }
+
+void Replay::Begin(float seconds) {
+  stepSeconds = seconds;
+  segments.clear();
+}
+
+void Replay::BeginSegment(const Level &level, int levelIndex,
+                          const World &world) {
+  Segment segment;
+  segment.levelPath = level.GetPath();
+  segment.levelIndex = levelIndex;
+  segment.levelHash = HashLevel(level);
+  segment.startAtDay = world.isDayTime;
+  segment.screenWidth = Core::SCREEN_WIDTH;
+  segment.screenHeight = Core::SCREEN_HEIGHT;
+  segments.push_back(std::move(segment));
+}
+
+void Replay::Record(const WorldInput &input, const World &world) {
+  if (segments.empty())
+    return;
+  Segment &segment = segments.back();
+  segment.inputs.push_back(PackInput(input));
+  segment.checksums.push_back(world.Checksum());
+}
+
+size_t Replay::GetStepCount() const {
+  size_t count = 0;
+  for (const Segment &segment : segments)
+    count += segment.inputs.size();
+  return count;
+}
+
+bool Replay::Save(const char *path) const {
+  std::vector<unsigned char> out;
+  auto put = [&](const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    out.insert(out.end(), bytes, bytes + size);
+  };
+
+  FileHeader header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.stepSeconds = stepSeconds;
+  header.segmentCount = (uint32_t)segments.size();
+  put(&header, sizeof(header));
+
+  for (const Segment &segment : segments) {
+    SegmentHeader sh;
+    sh.levelIndex = segment.levelIndex;
+    sh.levelHash = segment.levelHash;
+    sh.flags = segment.startAtDay ? FLAG_DAY : 0;
+    sh.screenWidth = (uint32_t)segment.screenWidth;
+    sh.screenHeight = (uint32_t)segment.screenHeight;
+    sh.stepCount = (uint32_t)segment.inputs.size();
+    sh.pathLength = (uint32_t)segment.levelPath.size();
+    put(&sh, sizeof(sh));
+    put(segment.levelPath.data(), segment.levelPath.size());
+
+    for (size_t i = 0; i < segment.inputs.size();) {
+      size_t run = 1;
+      while (i + run < segment.inputs.size() &&
+             segment.inputs[i + run] == segment.inputs[i])
+        run++;
+      out.push_back(segment.inputs[i]);
+      PutVarint(out, (uint32_t)run);
+      i += run;
+    }
+    put(segment.checksums.data(),
+        segment.checksums.size() * sizeof(uint32_t));
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (f == nullptr) {
+    TraceLog(LOG_WARNING, "REPLAY: cannot create %s", path);
+    return false;
+  }
+  bool written = fwrite(out.data(), 1, out.size(), f) == out.size();
+  if (fclose(f) != 0 || !written) {
+    TraceLog(LOG_WARNING, "REPLAY: cannot write %s", path);
+    return false;
+  }
+  TraceLog(LOG_INFO, "REPLAY: %zu steps in %zu segments written to %s "
+           "(%zu bytes)",
+           GetStepCount(), segments.size(), path, out.size());
+  return true;
+}
+
+bool Replay::Load(const char *path) {
+  int size = 0;
+  unsigned char *data = LoadFileData(path, &size);
+  if (data == nullptr) {
+    TraceLog(LOG_WARNING, "REPLAY: cannot read %s", path);
+    return false;
+  }
+  Reader in = {data, (size_t)size};
+
+  FileHeader header;
+  bool valid = in.Read(&header, sizeof(header)) &&
+               memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+               header.version == VERSION;
+  std::vector<Segment> loaded;
+  for (uint32_t s = 0; valid && s < header.segmentCount; s++) {
+    SegmentHeader sh;
+    if (!in.Read(&sh, sizeof(sh)) || sh.pathLength > in.size ||
+        sh.stepCount > in.size) {
+      valid = false;
+      break;
+    }
+    Segment segment;
+    segment.levelIndex = sh.levelIndex;
+    segment.levelHash = sh.levelHash;
+    segment.startAtDay = (sh.flags & FLAG_DAY) != 0;
+    segment.screenWidth = (int)sh.screenWidth;
+    segment.screenHeight = (int)sh.screenHeight;
+    segment.levelPath.resize(sh.pathLength);
+    in.Read(segment.levelPath.data(), sh.pathLength);
+
+    while (in.ok && segment.inputs.size() < sh.stepCount) {
+      uint8_t bits = 0;
+      in.Read(&bits, 1);
+      uint32_t run = in.ReadVarint();
+      if (run == 0 || run > sh.stepCount - segment.inputs.size()) {
+        in.ok = false;
+        break;
+      }
+      segment.inputs.insert(segment.inputs.end(), run, bits);
+    }
+    segment.checksums.resize(sh.stepCount);
+    in.Read(segment.checksums.data(), sh.stepCount * sizeof(uint32_t));
+    valid = in.ok;
+    loaded.push_back(std::move(segment));
+  }
+  UnloadFileData(data);
+
+  if (!valid) {
+    TraceLog(LOG_WARNING, "REPLAY: %s: not a valid replay", path);
+    return false;
+  }
+  stepSeconds = header.stepSeconds;
+  segments = std::move(loaded);
+  return true;
+}
+
+uint32_t Replay::HashLevel(const Level &level) {
+  uint32_t hash = 2166136261u;
+  if (level.blob != nullptr) {
+    for (size_t i = 0; i < level.blob->size; i++)
+      hash = (hash ^ level.blob->data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+ReplayCursor::ReplayCursor() {
+  segment = nullptr;
+  stepSeconds = 0.0f;
+  step = 0;
+  mismatches = 0;
+  firstMismatch = -1;
+}
+
+void ReplayCursor::Begin(const Replay &replay, int index) {
+  segment = &replay.segments[index];
+  stepSeconds = replay.stepSeconds;
+  step = 0;
+  mismatches = 0;
+  firstMismatch = -1;
+}
+
+bool ReplayCursor::Step(World &world, WorldEvents &events) {
+  if (IsDone())
+    return false;
+  size_t i = step.load();
+  events = world.Step(stepSeconds, Replay::UnpackInput(segment->inputs[i]));
+  if (world.Checksum() != segment->checksums[i]) {
+    if (firstMismatch < 0)
+      firstMismatch = (long long)i;
+    mismatches++;
+  }
+  step.store(i + 1);
+  return true;
+}
+
+bool ReplayCursor::IsDone() const {
+  return segment == nullptr || step.load() >= segment->inputs.size();
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "World.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A recorded play session: the input of every world step and a checksum of
+// the world after it, to re-simulate the session exactly (bug reports,
+// performance comparisons).
+//
+// Steps depend only on their input: fixed step time, no randomness, and
+// parallel work combined in index order. So the same level, screen size
+// and inputs give the same steps on any machine built with the same
+// floating-point settings; the checksums tell where a run drifts.
+//
+// A session is a list of segments, one per level (re)start: each begins at
+// World::Start, from the level's spawn point, at the screen size the level
+// was laid out for (physics scales with it). Levels are identified by path
+// and by a hash of their baked bytes (the level is the only seed a step
+// has), so an edited level is refused rather than replayed wrongly.
+//
+// File (.rrpl), little-endian:
+//   "RRPL" | version | step seconds | segment count
+//   per segment: level index, level hash, flags, screen width, height,
+//                step count, path length, path | inputs | checksums
+//                (one uint32 per step)
+// Inputs are run-length coded: (input bits, run length as a varint) pairs.
+// Held keys change rarely, so most of a file is its checksums (4 bytes a
+// step).
+class Replay {
+public:
+  // Input of one step, as bits
+  enum Input : uint8_t {
+    INPUT_LEFT = 1,
+    INPUT_RIGHT = 2,
+    INPUT_JUMP = 4,
+    INPUT_TOGGLE = 8,
+  };
+  static uint8_t PackInput(const WorldInput &input);
+  static WorldInput UnpackInput(uint8_t bits);
+
+  struct Segment {
+    std::string levelPath; // As loaded (Level::GetPath)
+    int levelIndex;        // In the game's level list
+    uint32_t levelHash;    // HashLevel() when recorded
+    bool startAtDay;
+    int screenWidth; // Core::SCREEN_WIDTH/HEIGHT of the layout
+    int screenHeight;
+    std::vector<uint8_t> inputs;     // One per step
+    std::vector<uint32_t> checksums; // World::Checksum() after each step
+  };
+
+  float stepSeconds;
+  std::vector<Segment> segments;
+
+  Replay();
+
+  void Begin(float stepSeconds); // New recording
+  // Next segment: 'world' has just been started on 'level', laid out at
+  // the current screen size
+  void BeginSegment(const Level &level, int levelIndex, const World &world);
+  // One step taken by the world (nothing before the first segment)
+  void Record(const WorldInput &input, const World &world);
+
+  size_t GetStepCount() const; // Over every segment
+  bool IsEmpty() const { return GetStepCount() == 0; }
+
+  bool Save(const char *path) const;
+  bool Load(const char *path); // Logs and returns false on a bad file
+
+  // FNV-1a of the level's baked bytes
+  static uint32_t HashLevel(const Level &level);
+};
+
+// Plays one segment of a replay back into a World, checking each step
+// against the recording. IsDone() and GetStep() may be polled from another
+// thread while it steps; the mismatch counts only once it stopped.
+class ReplayCursor {
+public:
+  ReplayCursor();
+
+  // 'world' must have just been started on the segment's level
+  void Begin(const Replay &replay, int segment);
+
+  // Step 'world' with the next recorded input; false (no step) once the
+  // segment is over
+  bool Step(World &world, WorldEvents &events);
+
+  bool IsDone() const;
+  size_t GetStep() const { return step.load(); } // Played in the segment
+  int GetMismatches() const { return mismatches; }
+  long long GetFirstMismatch() const { return firstMismatch; } // -1: none
+
+private:
+  const Replay::Segment *segment;
+  float stepSeconds;
+  std::atomic<size_t> step;
+  int mismatches;
+  long long firstMismatch;
+};
@@ -0,0 +1,366 @@
+#include "World.h"
+#include "../core/JobSystem.h"
+#include "../core/Profiler.h"
+#include "../entities/Roach.h"
+#include "../entities/Spider.h"
+#include "Collision.h"
+#include <cmath>
+
+namespace {
+
+// Parallel-for when the world has jobs, a plain loop otherwise
+template <typename F>
+void ForRange(JobSystem *jobs, int count, int grain, F &&body) {
+  if (jobs == nullptr || count <= grain) {
+    body(0, count);
+    return;
+  }
+  jobs->Wait(jobs->ParallelFor(count, grain, body));
+}
+
+} // namespace
+
+World::World() {
+  isDayTime = true;
+  tick = 0;
+  computeSunRays = false;
+  level = nullptr;
+  jobs = nullptr;
+  finished = false;
+}
+
+World::~World() { ClearEnemies(); }
+
+Enemy *World::SpawnEnemy(const EnemyConfig &config) {
+  Enemy *enemy = nullptr;
+  if (config.type == EnemyType::ROACH) {
+    enemy = new Roach(config.position);
+  } else if (config.type == EnemyType::SPIDER) {
+    Spider *s = new Spider(config.position);
+    s->frameCount = 2;
+    s->frameSpeed = 0.2f;
+    s->animated = true;
+    enemy = s;
+  } else {
+    return nullptr;
+  }
+  enemy->movingRight = config.movingRight;
+  enemy->patrolRange = config.patrolRange;
+  enemy->hasPatrol = config.platformIndex >= 0;
+  enemy->width = (float)Core::SCREEN_HEIGHT * LevelData::EnemySize(config.type);
+  enemy->height = enemy->width;
+  return enemy;
+}
+
+void World::Start(Level &lvl, bool startAtDay) {
+  level = &lvl;
+  isDayTime = startAtDay;
+  tick = 0;
+  finished = false;
+
+  player.position = lvl.spawnPoint;
+  player.width = (float)Core::SCREEN_HEIGHT * Player::SIZE;
+  player.height = player.width;
+  player.velocity = {0, 0};
+  player.hp = player.maxHp;
+  player.isDead = false;
+  player.isGrounded = false;
+
+  ClearEnemies();
+  for (const auto &config : lvl.enemies) {
+    if (Enemy *enemy = SpawnEnemy(config))
+      enemies.push_back(enemy);
+  }
+  sunRays.clear();
+  if (computeSunRays)
+    UpdateSunRays();
+}
+
+void World::Clear() {
+  ClearEnemies();
+  level = nullptr;
+  finished = false;
+}
+
+void World::ClearEnemies() {
+  for (auto *enemy : enemies) {
+    delete enemy;
+  }
+  enemies.clear();
+}
+
+WorldEvents World::Step(float dt, const WorldInput &input) {
+  WorldEvents events;
+  events.isDayTime = isDayTime;
+  if (level == nullptr || finished)
+    return events;
+  PROFILE_SCOPE("World::Step");
+  tick++;
+  Level &currentLvl = *level;
+
+  // Day/Night Toggle
+  if (input.toggleTime) {
+    isDayTime = !isDayTime;
+    events.timeToggled = true;
+  }
+
+  // Dynamic Platform Logic (Flower)
+  UpdateFlowers(dt);
+
+  // Flowers carry the player, in platform order
+  const std::vector<Platform> &platforms = currentLvl.platforms;
+  for (size_t i = 0; i < platforms.size(); i++) {
+    const Platform &plat = platforms[i];
+    if (plat.type != PlatformType::FLOWER)
+      continue;
+    Rectangle pRect = player.GetRect();
+    if (pRect.x + pRect.width > plat.rect.x &&
+        pRect.x < plat.rect.x + plat.rect.width) {
+      float bottom = pRect.y + pRect.height;
+      if (bottom <= plat.rect.y + 10 && bottom >= plat.rect.y - 10) {
+        player.position.y += flowerMoves[i];
+      }
+    }
+  }
+
+  // Enemies Update (only at night): in parallel with the player, since
+  // neither reads the other. Each enemy moves and animates itself only.
+  auto updateEnemies = [&](int begin, int end) {
+    PROFILE_SCOPE("Enemy::Update");
+    for (int i = begin; i < end; i++)
+      enemies[i]->Update(dt, currentLvl);
+  };
+  JobSystem::Handle enemyJobs;
+  int enemyCount = isDayTime ? 0 : (int)enemies.size();
+  if (jobs != nullptr && enemyCount > ENEMY_GRAIN)
+    enemyJobs = jobs->ParallelFor(enemyCount, ENEMY_GRAIN, updateEnemies);
+  else
+    updateEnemies(0, enemyCount);
+
+  // Player Update
+  bool wasGrounded = player.isGrounded;
+  player.Update(dt, input.player, currentLvl, isDayTime);
+  events.jumped = wasGrounded && !player.isGrounded && player.velocity.y < 0;
+
+  // Enemy collision once both are done, in enemy order
+  if (jobs != nullptr)
+    jobs->Wait(enemyJobs);
+  if (!isDayTime) {
+    for (auto *enemy : enemies) {
+      if (CheckCollisionRecs(player.GetRect(), enemy->GetRect())) {
+        if (!player.isDead)
+          events.caught = true;
+        player.Die();
+      }
+    }
+  }
+
+  // Sun Damage (Raycast Logic)
+  if (isDayTime) {
+    PROFILE_SCOPE("Sun raycast");
+    bool isExposed = true;
+    Rectangle playerRect = player.GetRect();
+    Vector2 playerCenter = {playerRect.x + playerRect.width / 2.0f,
+                            playerRect.y + playerRect.height / 2.0f};
+    Vector2 sunPos = currentLvl.sunPosition;
+
+    // Platforms around the sun-player segment only
+    Rectangle span = {fminf(sunPos.x, playerCenter.x),
+                      fminf(sunPos.y, playerCenter.y),
+                      fabsf(playerCenter.x - sunPos.x),
+                      fabsf(playerCenter.y - sunPos.y)};
+    currentLvl.ForEachSolid(span, isDayTime, [&](const Platform &plat) {
+      if (isExposed && CheckCollisionLineRect(sunPos, playerCenter, plat.rect))
+        isExposed = false;
+    });
+
+    if (isExposed) {
+      player.TakeDamage(1.0f * dt);
+      events.burning = player.hp > 0;
+    }
+  }
+
+  if (computeSunRays)
+    UpdateSunRays();
+
+  // Game Over / Exit
+  events.died = player.isDead;
+  events.reachedExit =
+      !player.isDead && CheckCollisionRecs(player.GetRect(), currentLvl.exitZone);
+  finished = events.died || events.reachedExit;
+  events.isDayTime = isDayTime;
+  return events;
+}
+
+void World::UpdateFlowers(float dt) {
+  if (level == nullptr)
+    return;
+  // Platforms ease in parallel, each recording its own move
+  std::vector<Platform> &platforms = level->platforms;
+  flowerMoves.assign(platforms.size(), 0.0f);
+  ForRange(jobs, (int)platforms.size(), PLATFORM_GRAIN,
+           [&](int begin, int end) {
+             PROFILE_SCOPE("Flowers");
+             for (int i = begin; i < end; i++) {
+               Platform &plat = platforms[i];
+               if (plat.type != PlatformType::FLOWER)
+                 continue;
+               float targetY = plat.initialY;
+               if (!isDayTime) {
+                 targetY = plat.initialY + 200.0f;
+               }
+
+               float moveSpeed = 5.0f;
+               float diff = targetY - plat.rect.y;
+               float moveY = diff * moveSpeed * dt;
+               plat.rect.y += moveY;
+               flowerMoves[i] = moveY;
+             }
+           });
+}
+
+void World::UpdateSunRays() {
+  PROFILE_SCOPE("World::UpdateSunRays");
+  if (!isDayTime) {
+    sunRays.clear();
+    return;
+  }
+  // Ray queries run in parallel, each into its own slot
+  Vector2 sunPos = level->sunPosition;
+  int screenW = Core::SCREEN_WIDTH;
+  float screenH = (float)Core::SCREEN_HEIGHT;
+  int rayCount = screenW / SUN_RAY_STEP + 1;
+  sunRays.resize(rayCount);
+  ForRange(jobs, rayCount, RAY_GRAIN, [&](int begin, int end) {
+    PROFILE_SCOPE("GetRayIntersection");
+    for (int i = begin; i < end; i++) {
+      Vector2 target = {(float)(i * SUN_RAY_STEP), screenH};
+      sunRays[i] = GetRayIntersection(sunPos, target, *level, isDayTime);
+    }
+  });
+}
+
+void World::SaveState(State &out) const {
+  out.player = player;
+  out.enemies.resize(enemies.size());
+  for (size_t i = 0; i < enemies.size(); i++) {
+    const Enemy &e = *enemies[i];
+    out.enemies[i] = {e.position, e.movingRight, e.currentFrame, e.frameTimer};
+  }
+  out.flowerY.clear();
+  if (level != nullptr) {
+    for (const Platform &plat : level->platforms) {
+      if (plat.type == PlatformType::FLOWER)
+        out.flowerY.push_back(plat.rect.y);
+    }
+  }
+  out.isDayTime = isDayTime;
+  out.tick = tick;
+  out.finished = finished;
+}
+
+void World::LoadState(const State &state) {
+  player = state.player;
+  for (size_t i = 0; i < enemies.size() && i < state.enemies.size(); i++) {
+    Enemy &e = *enemies[i];
+    e.position = state.enemies[i].position;
+    e.movingRight = state.enemies[i].movingRight;
+    e.currentFrame = state.enemies[i].currentFrame;
+    e.frameTimer = state.enemies[i].frameTimer;
+  }
+  if (level != nullptr) {
+    size_t next = 0;
+    for (Platform &plat : level->platforms) {
+      if (plat.type == PlatformType::FLOWER && next < state.flowerY.size())
+        plat.rect.y = state.flowerY[next++];
+    }
+  }
+  isDayTime = state.isDayTime;
+  tick = state.tick;
+  finished = state.finished;
+}
+
+uint32_t World::Checksum() const {
+  uint32_t hash = 2166136261u;
+  auto mix = [&](const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+      hash = (hash ^ bytes[i]) * 16777619u;
+  };
+  auto mixValue = [&](auto value) { mix(&value, sizeof(value)); };
+
+  mixValue(player.position.x);
+  mixValue(player.position.y);
+  mixValue(player.velocity.x);
+  mixValue(player.velocity.y);
+  mixValue(player.hp);
+  mixValue(player.isGrounded);
+  mixValue(player.isDead);
+  mixValue(player.facingRight);
+  for (const Enemy *e : enemies) {
+    mixValue(e->position.x);
+    mixValue(e->position.y);
+    mixValue(e->movingRight);
+    mixValue(e->currentFrame);
+    mixValue(e->frameTimer);
+  }
+  if (level != nullptr) {
+    for (const Platform &plat : level->platforms) {
+      if (plat.type == PlatformType::FLOWER)
+        mixValue(plat.rect.y);
+    }
+  }
+  mixValue(isDayTime);
+  mixValue(tick);
+  mixValue(finished);
+  return hash;
+}
+
+bool World::ReloadLevel() {
+  if (level == nullptr || !level->Reload())
+    return false;
+  Level &lvl = *level;
+
+  // Player: stays put unless the new layout walls them in
+  bool stuck = false;
+  Rectangle playerRect = player.GetRect();
+  lvl.ForEachSolid(playerRect, isDayTime, [&](const Platform &plat) {
+    if (CheckCollisionRecs(playerRect, plat.rect))
+      stuck = true;
+  });
+  if (stuck) {
+    player.position = lvl.spawnPoint;
+    player.velocity = {0, 0};
+  }
+
+  // Enemies match their spawns by index. One keeps its position and
+  // direction if its spawn is still the same kind, on the same height and
+  // its new patrol ground is still under it; otherwise it respawns.
+  std::vector<Enemy *> kept;
+  for (size_t i = 0; i < lvl.enemies.size(); i++) {
+    const EnemyConfig &config = lvl.enemies[i];
+    Enemy *old = i < enemies.size() ? enemies[i] : nullptr;
+    if (old != nullptr) {
+      bool valid = old->type == config.type &&
+                   std::fabs(old->position.y - config.position.y) < 0.5f;
+      if (valid && config.platformIndex >= 0) {
+        float feetX = old->position.x + old->width * 0.5f;
+        valid = feetX >= config.patrolRange.x && feetX < config.patrolRange.y;
+      }
+      if (valid) {
+        old->patrolRange = config.patrolRange;
+        old->hasPatrol = config.platformIndex >= 0;
+        kept.push_back(old);
+        enemies[i] = nullptr;
+        continue;
+      }
+    }
+    if (Enemy *enemy = SpawnEnemy(config))
+      kept.push_back(enemy);
+  }
+  ClearEnemies(); // Removed or respawned ones
+  enemies = kept;
+  if (computeSunRays)
+    UpdateSunRays();
+  return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "../entities/Enemy.h"
+#include "../entities/Player.h"
+#include "Level.h"
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Input for one step of the world
+struct WorldInput {
+  PlayerInput player;
+  bool toggleTime = false; // Day <-> night (pressed since the last step)
+};
+
+// What a step did that the game reacts to (sounds, music, screens)
+struct WorldEvents {
+  bool jumped = false;
+  bool caught = false;  // An enemy got the player this step
+  bool burning = false; // The sun hurt the player (still alive)
+  bool timeToggled = false;
+  bool died = false;
+  bool reachedExit = false;
+  bool isDayTime = true; // After the step
+
+  bool Any() const {
+    return jumped || caught || burning || timeToggled || died || reachedExit;
+  }
+};
+
+// One level's simulation: the player, the enemies and the level's moving
+// platforms, advanced by Step() from explicit input. No window, audio or
+// GPU work, so it runs on its own thread in the game and headless
+// elsewhere. The level is borrowed; its assets are the game's business.
+class World {
+public:
+  Player player;
+  std::vector<Enemy *> enemies; // Owned
+  bool isDayTime;
+  unsigned long long tick; // Steps since Start()
+
+  // Sun ray ends across the screen, for drawing (see computeSunRays)
+  std::vector<Vector2> sunRays;
+  bool computeSunRays; // Off by default: only the game draws them
+  static constexpr int SUN_RAY_STEP = 40; // Pixels between ray targets
+
+  World();
+  ~World();
+  World(const World &) = delete;
+  World &operator=(const World &) = delete;
+
+  // Optional: parallel-for over platforms, enemies and rays
+  void SetJobs(JobSystem *jobSystem) { jobs = jobSystem; }
+
+  // Play 'level' (laid out already) from its spawn point; the player keeps
+  // its visuals, the rest of its state is reset
+  void Start(Level &level, bool startAtDay);
+  void Clear(); // Drops the enemies and the level
+  Level *GetLevel() const { return level; }
+
+  // Over once the player died or reached the exit; Step() then does nothing
+  bool IsFinished() const { return finished; }
+  WorldEvents Step(float dt, const WorldInput &input);
+
+  // Re-read the level's files (Level::Reload) and keep what still fits:
+  // the player's position unless walled in, each enemy matched by index
+  // while its kind, height and patrol ground still fit
+  bool ReloadLevel();
+
+  // Everything a step changes, to rewind to later (searches, checks).
+  // Only valid for the level and enemies it was saved from.
+  struct State {
+    struct EnemyState {
+      Vector2 position;
+      bool movingRight;
+      int currentFrame;
+      float frameTimer;
+    };
+
+    Player player;
+    std::vector<EnemyState> enemies;
+    std::vector<float> flowerY; // Moving platforms' heights, in level order
+    bool isDayTime = true;
+    unsigned long long tick = 0;
+    bool finished = false;
+  };
+  void SaveState(State &out) const;
+  void LoadState(const State &state);
+
+  // Hash of that state, bit for bit: replays compare runs with it
+  uint32_t Checksum() const;
+
+  static Enemy *SpawnEnemy(const EnemyConfig &config);
+
+  // The flowers' part of a step: ease towards their day or night height,
+  // recording each move (the player rides along in Step)
+  void UpdateFlowers(float dt);
+
+private:
+  Level *level;
+  JobSystem *jobs;
+  bool finished;
+  std::vector<float> flowerMoves; // Per platform, this step
+
+  static constexpr int PLATFORM_GRAIN = 256;
+  static constexpr int ENEMY_GRAIN = 64;
+  static constexpr int RAY_GRAIN = 8;
+
+  void ClearEnemies();
+  void UpdateSunRays();
+};
@@ -0,0 +1,238 @@
+#include "WorldThread.h"
+#include "../core/Profiler.h"
+#include <chrono>
+
+namespace {
+
+double Now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Events of several steps as one: flags add up, the time of day is the last
+void Merge(WorldEvents &into, const WorldEvents &from) {
+  into.jumped |= from.jumped;
+  into.caught |= from.caught;
+  into.burning |= from.burning;
+  into.timeToggled |= from.timeToggled;
+  into.died |= from.died;
+  into.reachedExit |= from.reachedExit;
+  into.isDayTime = from.isDayTime;
+}
+
+} // namespace
+
+void WorldSnapshot::Capture(const World &world) {
+  tick = world.tick;
+  isDayTime = world.isDayTime;
+  player = world.player;
+
+  enemies.resize(world.enemies.size());
+  for (size_t i = 0; i < world.enemies.size(); i++) {
+    const Enemy &e = *world.enemies[i];
+    enemies[i] = {e.type,        e.position,    e.width,
+                  e.height,      e.movingRight, e.currentFrame};
+  }
+
+  platforms.clear();
+  if (const Level *level = world.GetLevel()) {
+    platforms.resize(level->platforms.size());
+    for (size_t i = 0; i < level->platforms.size(); i++) {
+      const Platform &p = level->platforms[i];
+      platforms[i] = {p.rect, p.type, p.color};
+    }
+  }
+  sunRays = world.sunRays;
+}
+
+WorldThread::WorldThread() {
+  world = nullptr;
+  recording = nullptr;
+  playback = nullptr;
+  paused = true;
+  stepping = false;
+  stopping = false;
+  epoch = 0;
+  hasUnposted = false;
+  hasUnsent = false;
+  accumulator = 0.0f;
+  resetClock = true;
+}
+
+WorldThread::~WorldThread() { Stop(); }
+
+void WorldThread::Start(World *target) {
+  Stop();
+  world = target;
+  paused = true;
+  stopping = false;
+#if !defined(PLATFORM_WEB)
+  thread = std::thread(&WorldThread::ThreadLoop, this);
+#endif
+}
+
+void WorldThread::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  if (thread.joinable())
+    thread.join();
+}
+
+void WorldThread::Pause() {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!paused)
+    epoch++; // Input of the paused stretch is stale once it resumes
+  paused = true;
+  idle.wait(lock, [&] { return !stepping; });
+}
+
+void WorldThread::Resume() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!paused || world == nullptr)
+      return;
+    paused = false;
+    resetClock = true; // Paused time is not caught up
+  }
+  wake.notify_all();
+}
+
+bool WorldThread::IsPaused() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return paused;
+}
+
+void WorldThread::PostInput(const WorldInput &input) {
+  // A full queue (the simulation is stalled) drops the sample being pushed.
+  // Held keys come again with the next one; presses are carried over to it
+  // (within the same epoch: stale ones are dropped on resume anyway).
+  Sample sample = {input, epoch.load(std::memory_order_relaxed)};
+  if (hasUnposted && unposted.epoch == sample.epoch) {
+    sample.input.player.jump |= unposted.input.player.jump;
+    sample.input.toggleTime |= unposted.input.toggleTime;
+  }
+  hasUnposted = !inputs.Push(sample);
+  if (hasUnposted)
+    unposted = sample;
+}
+
+bool WorldThread::PollEvents(WorldEvents &out) { return events.Pop(out); }
+
+void WorldThread::Publish() {
+  if (world == nullptr)
+    return;
+  snapshots.Back().Capture(*world);
+  snapshots.Publish();
+}
+
+void WorldThread::TakeInput() {
+  Sample sample;
+  unsigned current = epoch.load(std::memory_order_relaxed);
+  while (inputs.Pop(sample)) {
+    if (sample.epoch != current)
+      continue;
+    pending.player.left = sample.input.player.left;
+    pending.player.right = sample.input.player.right;
+    pending.player.jump |= sample.input.player.jump;
+    pending.toggleTime |= sample.input.toggleTime;
+  }
+}
+
+void WorldThread::SendEvents(const WorldEvents &stepEvents) {
+  if (hasUnsent || stepEvents.Any()) {
+    Merge(unsent, stepEvents);
+    hasUnsent = true;
+  }
+  if (hasUnsent && events.Push(unsent)) {
+    unsent = WorldEvents();
+    hasUnsent = false;
+  }
+}
+
+int WorldThread::Advance(float elapsed) {
+  if (resetClock) {
+    resetClock = false;
+    accumulator = 0.0f;
+    pending = WorldInput();
+  }
+  accumulator += elapsed;
+  if (accumulator > TICK_SECONDS * MAX_CATCH_UP)
+    accumulator = TICK_SECONDS * MAX_CATCH_UP; // Drop the rest of a stall
+
+  int steps = 0;
+  while (accumulator >= TICK_SECONDS) {
+    accumulator -= TICK_SECONDS;
+    WorldEvents stepEvents;
+    if (playback != nullptr) {
+      if (!playback->Step(*world, stepEvents)) {
+        accumulator = 0.0f; // Over: wait for the next segment
+        break;
+      }
+    } else {
+      TakeInput();
+      unsigned long long before = world->tick;
+      stepEvents = world->Step(TICK_SECONDS, pending);
+      if (recording != nullptr && world->tick != before)
+        recording->Record(pending, *world);
+    }
+    if (stepEvents.timeToggled)
+      Profiler::Instant(stepEvents.isDayTime ? "Day" : "Night");
+    if (stepEvents.died)
+      Profiler::Instant("Death");
+    if (stepEvents.reachedExit)
+      Profiler::Instant("Exit");
+    SendEvents(stepEvents);
+    // Presses are used up by the step that saw them
+    pending.player.jump = false;
+    pending.toggleTime = false;
+    steps++;
+  }
+  Profiler::Counter("Steps", steps);
+  if (steps > 0) {
+    PROFILE_SCOPE("WorldSnapshot::Capture");
+    snapshots.Back().Capture(*world);
+    snapshots.Publish();
+  } else if (hasUnsent) {
+    SendEvents(WorldEvents());
+  }
+  return steps;
+}
+
+void WorldThread::Pump(float dt) {
+#if defined(PLATFORM_WEB)
+  if (!paused && world != nullptr)
+    Advance(dt);
+#else
+  (void)dt; // The thread keeps its own clock
+#endif
+}
+
+void WorldThread::ThreadLoop() {
+  Profiler::SetThreadName("Simulation");
+  double last = Now();
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&] { return stopping || !paused; });
+    if (stopping)
+      break;
+
+    stepping = true;
+    lock.unlock();
+    double now = Now();
+    if (resetClock)
+      last = now;
+    Advance((float)(now - last));
+    last = now;
+    lock.lock();
+    stepping = false;
+    idle.notify_all();
+
+    // Sleep to the next step, unless paused or stopped meanwhile
+    double due = TICK_SECONDS - accumulator;
+    wake.wait_for(lock, std::chrono::duration<double>(due),
+                  [&] { return stopping || paused; });
+  }
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "../core/SpscQueue.h"
+#include "../core/TripleBuffer.h"
+#include "Replay.h"
+#include "World.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// What the render thread draws of a world step: a copy, so drawing never
+// reads state the simulation is writing
+struct WorldSnapshot {
+  struct EnemyView {
+    EnemyType type;
+    Vector2 position;
+    float width;
+    float height;
+    bool movingRight;
+    int currentFrame;
+  };
+
+  struct PlatformView {
+    Rectangle rect;
+    PlatformType type;
+    Color color;
+  };
+
+  unsigned long long tick = 0;
+  bool isDayTime = true;
+  Player player;
+  std::vector<EnemyView> enemies;
+  std::vector<PlatformView> platforms; // Level platform i is view i
+  std::vector<Vector2> sunRays;         // World::sunRays
+
+  void Capture(const World &world);
+};
+
+// Runs a World at a fixed step on its own thread.
+//
+// The game thread posts input and polls events through lock-free queues and
+// draws the latest snapshot from a triple buffer: it never waits on a step,
+// and a slow frame never slows the simulation down (or the other way
+// round). Steps are TICK_SECONDS of game time, caught up in a burst of at
+// most MAX_CATCH_UP after a stall.
+//
+// While paused no step runs and the game thread may use the World directly
+// (load a level, resize); Publish() then refreshes the snapshot.
+//
+// Without threads (web build) Pump() steps on the main thread instead.
+class WorldThread {
+public:
+  static constexpr float TICK_SECONDS = 1.0f / 60.0f;
+  static constexpr int MAX_CATCH_UP = 5;
+
+  WorldThread();
+  ~WorldThread();
+
+  // Starts paused
+  void Start(World *world);
+  void Stop();
+
+  // Returns once no step is running. Input posted before it is dropped.
+  void Pause();
+  void Resume();
+  bool IsPaused() const;
+
+  // --- Game thread ---
+  // Once per frame: held keys as sampled, presses since the last post
+  void PostInput(const WorldInput &input);
+  bool PollEvents(WorldEvents &out); // False when there are none
+  const WorldSnapshot &Latest() { return snapshots.Front(); }
+  void Publish(); // Snapshot the world now (paused only)
+
+  void Pump(float dt); // Steps without a thread (web)
+
+  // --- Replays (set while paused) ---
+  // Append every step that advanced the world to 'replay' (nullptr stops)
+  void SetRecording(Replay *replay) { recording = replay; }
+  // Take each step's input from 'cursor' instead of PostInput, until its
+  // segment is over (nullptr stops)
+  void SetPlayback(ReplayCursor *cursor) { playback = cursor; }
+
+private:
+  struct Sample {
+    WorldInput input;
+    unsigned epoch; // Pause() count when posted
+  };
+
+  World *world;
+  Replay *recording;
+  ReplayCursor *playback;
+  std::thread thread;
+  mutable std::mutex mutex;
+  std::condition_variable wake;  // Resume, Stop
+  std::condition_variable idle;  // Between steps (Pause waits on it)
+  bool paused;
+  bool stepping;
+  bool stopping;
+  std::atomic<unsigned> epoch;
+
+  SpscQueue<Sample, 64> inputs;
+  SpscQueue<WorldEvents, 64> events;
+  TripleBuffer<WorldSnapshot> snapshots;
+
+  // Game side
+  Sample unposted; // Presses the full queue did not take yet
+  bool hasUnposted;
+
+  // Simulation side
+  WorldInput pending; // Held keys and unconsumed presses
+  WorldEvents unsent; // Events the full queue did not take yet
+  bool hasUnsent;
+  float accumulator;
+  bool resetClock;
+
+  int Advance(float elapsed); // Steps due; returns how many ran
+  void TakeInput();
+  void SendEvents(const WorldEvents &stepEvents);
+  void ThreadLoop();
+};
@@ -0,0 +1,234 @@
+// Conditions source assets for shipping (run before packing).
+//
+//   AssetConditioner <source dir> <output dir> [--max W H] [--straight-alpha]
+//
+// Images are downscaled to fit the largest supported resolution, their
+// alpha is premultiplied, and they are written as QOI (decodes several times
+// faster than PNG/JPG) along with half, quarter... size variants the game
+// picks from for smaller windows. Audio is transcoded to QOA; compressed sources
+// (MP3/OGG) are kept as they are when QOA would be larger. Anything else is
+// copied. Output paths mirror the source paths with the new extension, and
+// <output dir>/<source dir>/manifest.txt records every file produced; the
+// game reads it from the pack to find the conditioned files.
+//
+// Run from the project root, e.g. AssetConditioner assets build/conditioned
+#include "AssetManifest.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+  int maxWidth = 1920; // Largest entry of the game's resolution list
+  int maxHeight = 1080;
+  bool premultiply = true;
+};
+
+std::string Lower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(),
+                 [](unsigned char c) { return (char)tolower(c); });
+  return s;
+}
+
+bool IsImage(const std::string &ext) {
+  return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" ||
+         ext == ".tga" || ext == ".qoi";
+}
+
+bool IsAudio(const std::string &ext) {
+  return ext == ".wav" || ext == ".mp3" || ext == ".ogg" || ext == ".flac" ||
+         ext == ".qoa";
+}
+
+uint64_t SizeOf(const fs::path &file) {
+  std::error_code ec;
+  uint64_t size = fs::file_size(file, ec);
+  return ec ? 0 : size;
+}
+
+bool ConditionImage(const std::string &src, const fs::path &outDir,
+                    const Options &options, AssetManifest::Entry &entry) {
+  Image image = LoadImage(src.c_str());
+  if (image.data == nullptr)
+    return false;
+
+  // Fit inside the largest resolution, keeping the aspect ratio
+  float scale = std::min({1.0f, (float)options.maxWidth / image.width,
+                          (float)options.maxHeight / image.height});
+  if (scale < 1.0f) {
+    int w = std::max(1, (int)(image.width * scale + 0.5f));
+    int h = std::max(1, (int)(image.height * scale + 0.5f));
+    ImageResize(&image, w, h);
+  }
+
+  ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+  if (options.premultiply)
+    ImageAlphaPremultiply(&image);
+
+  entry.output = fs::path(src).replace_extension(".qoi").generic_string();
+  entry.width = image.width;
+  entry.height = image.height;
+  entry.outputBytes = 0;
+
+  // Full size, then each mip level halved from the one before (filtered on
+  // premultiplied colour, so transparent edges do not bleed)
+  bool ok = true;
+  for (int level = 0; level < AssetManifest::MAX_MIP_LEVELS; level++) {
+    if (level > 0) {
+      int w = image.width / 2;
+      int h = image.height / 2;
+      if (w < AssetManifest::MIN_MIP_SIZE || h < AssetManifest::MIN_MIP_SIZE)
+        break;
+      ImageResize(&image, w, h);
+    }
+    fs::path out = outDir / AssetManifest::MipPath(entry.output, level);
+    fs::create_directories(out.parent_path());
+    if (!ExportImage(image, out.string().c_str())) {
+      ok = false;
+      break;
+    }
+    entry.mipLevels = level + 1;
+    entry.outputBytes += SizeOf(out);
+  }
+  UnloadImage(image);
+  return ok;
+}
+
+bool ConditionAudio(const std::string &src, const std::string &ext,
+                    const fs::path &outDir, AssetManifest::Entry &entry) {
+  Wave wave = LoadWave(src.c_str());
+  if (wave.data == nullptr)
+    return false;
+
+  // QOA takes 16-bit samples
+  if (wave.sampleSize != 16)
+    WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+
+  entry.output = fs::path(src).replace_extension(".qoa").generic_string();
+  entry.width = (int)wave.sampleRate;
+  entry.height = (int)wave.channels;
+
+  fs::path out = outDir / entry.output;
+  fs::create_directories(out.parent_path());
+  bool ok = ExportWave(wave, out.string().c_str());
+  UnloadWave(wave);
+  if (!ok)
+    return false;
+  entry.outputBytes = SizeOf(out);
+
+  // Already compressed sources stay as they are unless QOA is smaller
+  bool compressed = ext == ".mp3" || ext == ".ogg" || ext == ".flac";
+  if (compressed && entry.outputBytes > entry.sourceBytes) {
+    fs::remove(out);
+    entry.kind = AssetManifest::Kind::COPY;
+    entry.output = src;
+    fs::copy_file(src, outDir / src, fs::copy_options::overwrite_existing);
+    entry.outputBytes = entry.sourceBytes;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr,
+            "usage: %s <source dir> <output dir> [--max W H] "
+            "[--straight-alpha]\n",
+            argv[0]);
+    return 1;
+  }
+
+  std::string sourceDir =
+      fs::path(argv[1]).lexically_normal().generic_string();
+  fs::path outDir = argv[2];
+  Options options;
+  for (int i = 3; i < argc; i++) {
+    if (strcmp(argv[i], "--max") == 0 && i + 2 < argc) {
+      options.maxWidth = atoi(argv[++i]);
+      options.maxHeight = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--straight-alpha") == 0) {
+      options.premultiply = false;
+    }
+  }
+  if (options.maxWidth <= 0 || options.maxHeight <= 0) {
+    fprintf(stderr, "invalid --max\n");
+    return 1;
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+
+  std::vector<std::string> sources;
+  for (const auto &item : fs::recursive_directory_iterator(sourceDir)) {
+    if (item.is_regular_file())
+      sources.push_back(item.path().lexically_normal().generic_string());
+  }
+  std::sort(sources.begin(), sources.end());
+
+  AssetManifest manifest;
+  manifest.maxWidth = options.maxWidth;
+  manifest.maxHeight = options.maxHeight;
+  manifest.premultipliedAlpha = options.premultiply;
+
+  std::string manifestName = sourceDir + "/" + AssetManifest::FILE_NAME;
+  int failures = 0;
+  for (const std::string &src : sources) {
+    if (src == manifestName)
+      continue;
+
+    AssetManifest::Entry entry;
+    entry.source = src;
+    entry.sourceBytes = SizeOf(src);
+    std::string ext = Lower(fs::path(src).extension().string());
+
+    bool ok;
+    if (IsImage(ext)) {
+      entry.kind = AssetManifest::Kind::IMAGE;
+      ok = ConditionImage(src, outDir, options, entry);
+    } else if (IsAudio(ext)) {
+      entry.kind = AssetManifest::Kind::AUDIO;
+      ok = ConditionAudio(src, ext, outDir, entry);
+    } else {
+      entry.kind = AssetManifest::Kind::COPY;
+      entry.output = src;
+      fs::create_directories((outDir / src).parent_path());
+      ok = fs::copy_file(src, outDir / src,
+                         fs::copy_options::overwrite_existing);
+      entry.outputBytes = entry.sourceBytes;
+    }
+
+    if (!ok) {
+      fprintf(stderr, "failed: %s\n", src.c_str());
+      failures++;
+      continue;
+    }
+    printf("%-55s %9llu -> %9llu\n", entry.output.c_str(),
+           (unsigned long long)entry.sourceBytes,
+           (unsigned long long)entry.outputBytes);
+    manifest.entries.push_back(entry);
+  }
+
+  fs::path manifestPath = outDir / manifestName;
+  fs::create_directories(manifestPath.parent_path());
+  if (!manifest.Save(manifestPath.string().c_str())) {
+    fprintf(stderr, "cannot write %s\n", manifestPath.string().c_str());
+    return 1;
+  }
+
+  uint64_t before = 0, after = 0;
+  for (const auto &e : manifest.entries) {
+    before += e.sourceBytes;
+    after += e.outputBytes;
+  }
+  printf("%zu files: %llu -> %llu bytes\n", manifest.entries.size(),
+         (unsigned long long)before, (unsigned long long)after);
+  return failures > 0 ? 1 : 0;
+}
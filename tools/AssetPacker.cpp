@@ -0,0 +1,153 @@
+// Packs asset folders into a single archive (see src/core/PackFormat.h).
+//
+//   AssetPacker <output.pak> <dir or file>... [--align N]
+//
+// Run from the project root: entries are named by their path as given
+// ("assets/sprites/roach.png"), which is the path the game asks for.
+#include "PackFormat.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Input {
+  std::string name; // Entry name ('/' separated)
+  fs::path file;
+  uint64_t size;
+};
+
+void Collect(const fs::path &root, std::vector<Input> &inputs) {
+  auto add = [&](const fs::path &file) {
+    std::string name = file.lexically_normal().generic_string();
+    if (name.rfind("./", 0) == 0)
+      name = name.substr(2);
+    inputs.push_back({name, file, (uint64_t)fs::file_size(file)});
+  };
+
+  if (fs::is_regular_file(root)) {
+    add(root);
+    return;
+  }
+  for (const auto &item : fs::recursive_directory_iterator(root)) {
+    if (item.is_regular_file())
+      add(item.path());
+  }
+}
+
+bool WritePadding(std::ofstream &out, uint64_t count) {
+  static const char zeros[256] = {};
+  while (count > 0) {
+    uint64_t n = std::min<uint64_t>(count, sizeof(zeros));
+    out.write(zeros, (std::streamsize)n);
+    count -= n;
+  }
+  return (bool)out;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr,
+            "usage: %s <output.pak> <dir or file>... [--align N]\n", argv[0]);
+    return 1;
+  }
+
+  const char *outputPath = argv[1];
+  uint32_t alignment = Pack::DEFAULT_ALIGNMENT;
+  std::vector<Input> inputs;
+
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--align") == 0 && i + 1 < argc) {
+      alignment = (uint32_t)strtoul(argv[++i], nullptr, 10);
+      if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        fprintf(stderr, "alignment must be a power of two\n");
+        return 1;
+      }
+      continue;
+    }
+    if (!fs::exists(argv[i])) {
+      fprintf(stderr, "not found: %s\n", argv[i]);
+      return 1;
+    }
+    Collect(argv[i], inputs);
+  }
+
+  // Stable order: the same inputs always give the same archive
+  std::sort(inputs.begin(), inputs.end(),
+            [](const Input &a, const Input &b) { return a.name < b.name; });
+  inputs.erase(std::unique(inputs.begin(), inputs.end(),
+                           [](const Input &a, const Input &b) {
+                             return a.name == b.name;
+                           }),
+               inputs.end());
+
+  // Table of contents
+  std::vector<Pack::Entry> entries(inputs.size());
+  std::string names;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    Pack::Entry &e = entries[i];
+    e.nameOffset = (uint32_t)names.size();
+    e.nameLength = (uint32_t)inputs[i].name.size();
+    e.hash = Pack::HashName(inputs[i].name.data(), inputs[i].name.size());
+    e.reserved = 0;
+    e.size = inputs[i].size;
+    names += inputs[i].name;
+  }
+
+  Pack::Header header;
+  memcpy(header.magic, Pack::MAGIC, 4);
+  header.version = Pack::VERSION;
+  header.entryCount = (uint32_t)entries.size();
+  header.alignment = alignment;
+  header.tocSize = entries.size() * sizeof(Pack::Entry) + names.size();
+  header.dataOffset =
+      Pack::AlignUp(sizeof(Pack::Header) + header.tocSize, alignment);
+
+  uint64_t offset = header.dataOffset;
+  for (Pack::Entry &e : entries) {
+    e.offset = offset;
+    offset = Pack::AlignUp(offset + e.size, alignment);
+  }
+
+  std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    fprintf(stderr, "cannot write %s\n", outputPath);
+    return 1;
+  }
+  out.write((const char *)&header, sizeof(header));
+  out.write((const char *)entries.data(),
+            (std::streamsize)(entries.size() * sizeof(Pack::Entry)));
+  out.write(names.data(), (std::streamsize)names.size());
+  WritePadding(out, header.dataOffset - sizeof(header) - header.tocSize);
+
+  std::vector<char> buffer;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    std::ifstream in(inputs[i].file, std::ios::binary);
+    buffer.resize(inputs[i].size);
+    if (!in.read(buffer.data(), (std::streamsize)buffer.size())) {
+      fprintf(stderr, "cannot read %s\n", inputs[i].file.string().c_str());
+      return 1;
+    }
+    out.write(buffer.data(), (std::streamsize)buffer.size());
+    uint64_t end = entries[i].offset + entries[i].size;
+    uint64_t next = i + 1 < entries.size() ? entries[i + 1].offset : end;
+    WritePadding(out, next - end);
+  }
+
+  if (!out) {
+    fprintf(stderr, "write failed: %s\n", outputPath);
+    return 1;
+  }
+  printf("%s: %zu entries, %llu bytes\n", outputPath, entries.size(),
+         (unsigned long long)out.tellp());
+  return 0;
+}
@@ -0,0 +1,463 @@
+// Micro-benchmarks of the simulation's hot paths, over synthetic levels of
+// growing size, for scaling curves and regression checks.
+//
+//   Benchmark [options]
+//     --out FILE      JSON results (default benchmark.json)
+//     --filter TEXT   only the benchmarks whose name contains TEXT
+//     --min-time S    shortest timed run of a sample (default 0.2)
+//     --quick         sizes up to 10k, shorter runs (smoke test)
+//
+// Levels are generated from a fixed seed: the same sizes give the same
+// levels on every run and machine. Platforms are a mix of 70% basic and
+// 10% each of flowers, mushrooms and invisible ones, shrinking as their
+// number grows so the area they cover stays about the same (a denser
+// level, not a bigger one). Enemies stand on basic platforms.
+//
+// Each benchmark is calibrated to run for at least --min-time, then timed
+// SAMPLES times; the JSON has the median, min and max time per operation
+// (one entity update, one query, one platform pass...).
+#include "world/Collision.h"
+#include "world/World.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int SAMPLES = 5;
+constexpr uint32_t SEED = 0x5eed;
+constexpr int QUERY_COUNT = 4096; // Points, rays and segments per set
+constexpr float TICK_SECONDS = 1.0f / 60.0f; // WorldThread::TICK_SECONDS
+
+const int PLATFORM_COUNTS[] = {10, 100, 1000, 10000, 100000};
+const int ENEMY_COUNTS[] = {1, 10, 100, 1000, 10000, 100000};
+constexpr int ENEMY_LEVEL_PLATFORMS = 1000; // Ground for the enemy runs
+
+struct Options {
+  const char *out = "benchmark.json";
+  const char *filter = "";
+  double minTime = 0.2;
+  int maxCount = 100000;
+};
+
+struct Result {
+  std::string name;
+  int platforms;
+  int enemies;
+  long long iterations; // Operations per sample
+  double medianNs;      // Per operation
+  double minNs;
+  double maxNs;
+};
+
+// Results the optimiser must not drop
+volatile float sink;
+
+double Seconds(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double>(d).count();
+}
+
+// Time run(n), which performs n operations: calibrated, then sampled
+template <typename Run>
+Result Measure(const char *name, int platforms, int enemies,
+               const Options &options, Run &&run) {
+  using Clock = std::chrono::steady_clock;
+  long long n = 1;
+  while (true) {
+    Clock::time_point start = Clock::now();
+    run(n);
+    double elapsed = Seconds(Clock::now() - start);
+    if (elapsed >= options.minTime || n >= (1ll << 40))
+      break;
+    // Aim past the minimum, growing at most 10x a round
+    double scale = elapsed > 0.0 ? options.minTime * 1.2 / elapsed : 10.0;
+    n = (long long)((double)n * std::min(10.0, std::max(2.0, scale)));
+  }
+
+  std::vector<double> samples;
+  for (int i = 0; i < SAMPLES; i++) {
+    Clock::time_point start = Clock::now();
+    run(n);
+    samples.push_back(Seconds(Clock::now() - start) * 1e9 / (double)n);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  Result result = {name,
+                   platforms,
+                   enemies,
+                   n,
+                   samples[SAMPLES / 2],
+                   samples.front(),
+                   samples.back()};
+  printf("  %-28s %7d %7d %12.1f ns/op  (%.1f .. %.1f)\n", name, platforms,
+         enemies, result.medianNs, result.minNs, result.maxNs);
+  fflush(stdout);
+  return result;
+}
+
+// --- Synthetic levels ---
+
+// 'enemyCount' roaches and as many spiders
+LevelData MakeLevelData(int platformCount, int enemyCount, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+  LevelData data;
+  data.isDay = true;
+  data.spawnPoint = {0.05f, 0.1f};
+  data.sunPosition = {0.5f, 0.0f};
+  data.exitZone = {0.95f, 0.0f, 0.05f, 0.1f};
+
+  // About a screen's worth of platforms at 10, shrinking with the count
+  float scale = 1.0f / sqrtf((float)platformCount / 10.0f);
+  float w = std::max(0.003f, 0.15f * scale);
+  float h = std::max(0.002f, 0.03f * scale);
+  std::vector<int> ground; // Basic platforms, for enemies
+  for (int i = 0; i < platformCount; i++) {
+    LevelData::PlatformDef p;
+    p.rect = {unit(rng) * (1.0f - w), 0.1f + unit(rng) * (0.9f - h), w, h};
+    float kind = unit(rng);
+    if (kind < 0.7f) {
+      p.type = PlatformType::NORMAL;
+      ground.push_back(i);
+    } else if (kind < 0.8f)
+      p.type = PlatformType::FLOWER;
+    else if (kind < 0.9f)
+      p.type = PlatformType::MUSHROOM;
+    else
+      p.type = PlatformType::INVISIBLE;
+    data.platforms.push_back(p);
+  }
+  if (ground.empty()) {
+    data.platforms[0].type = PlatformType::NORMAL;
+    ground.push_back(0);
+  }
+
+  for (int i = 0; i < enemyCount * 2; i++) {
+    LevelData::EnemyDef e;
+    e.type = (i % 2 == 0) ? EnemyType::ROACH : EnemyType::SPIDER;
+    const Rectangle &r = data.platforms[ground[rng() % ground.size()]].rect;
+    float size = LevelData::EnemySize(e.type);
+    // Heights are in screen heights, widths in screen widths
+    float width = size * (float)Core::SCREEN_HEIGHT / (float)Core::SCREEN_WIDTH;
+    e.position = {r.x + unit(rng) * std::max(0.0f, r.width - width),
+                  r.y - size};
+    e.movingRight = (rng() & 1) != 0;
+    data.enemies.push_back(e);
+  }
+  return data;
+}
+
+// A synthetic level, laid out at the game's resolution
+struct Scene {
+  Level level;
+  int platformCount = 0;
+  int enemyCount = 0; // Of each kind
+
+  bool Build(int platforms, int enemies) {
+    platformCount = platforms;
+    enemyCount = enemies;
+    LevelData data =
+        MakeLevelData(platforms, enemies, SEED + (uint32_t)platforms);
+    if (!level.Load(data, "synthetic"))
+      return false;
+    level.Layout((float)Core::SCREEN_WIDTH, (float)Core::SCREEN_HEIGHT);
+    return true;
+  }
+
+  // Points in the level, half of them just above a platform
+  std::vector<Vector2> Points(uint32_t seed) const {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Vector2> points;
+    for (int i = 0; i < QUERY_COUNT; i++) {
+      if (i % 2 == 0) {
+        const Rectangle &r = level.platforms[rng() % level.platforms.size()]
+                                 .rect;
+        points.push_back({r.x + unit(rng) * r.width, r.y - 1.0f});
+      } else {
+        points.push_back({unit(rng) * (float)Core::SCREEN_WIDTH,
+                          unit(rng) * (float)Core::SCREEN_HEIGHT});
+      }
+    }
+    return points;
+  }
+};
+
+bool Wanted(const Options &options, const char *name) {
+  return strstr(name, options.filter) != nullptr;
+}
+
+// --- Benchmarks ---
+
+void BenchPlayer(Scene &scene, const Options &options,
+                 std::vector<Result> &results) {
+  World world;
+  world.Start(scene.level, true);
+  Player start = world.player;
+  // Start on a platform, so the runs collide, land and walk off edges
+  const Rectangle &ground = scene.level.platforms[0].rect;
+  start.position = {ground.x, ground.y - start.height};
+
+  results.push_back(Measure(
+      "Player::Update", scene.platformCount, 0, options, [&](long long n) {
+        Player player = start;
+        for (long long i = 0; i < n; i++) {
+          // A few seconds of running and jumping back and forth
+          if ((i & 255) == 0)
+            player = start;
+          PlayerInput input;
+          input.right = (i & 128) == 0;
+          input.left = !input.right;
+          input.jump = (i & 31) == 0;
+          player.Update(TICK_SECONDS, input, scene.level, (i & 512) == 0);
+        }
+        sink = player.position.x + player.position.y;
+      }));
+}
+
+// One op = one enemy's update
+void BenchEnemies(Scene &scene, const Options &options,
+                  std::vector<Result> &results) {
+  std::vector<Enemy *> enemies;
+  std::vector<Enemy *> roaches;
+  std::vector<Enemy *> spiders;
+  for (const EnemyConfig &config : scene.level.enemies) {
+    if (Enemy *enemy = World::SpawnEnemy(config)) {
+      enemies.push_back(enemy);
+      (enemy->type == EnemyType::ROACH ? roaches : spiders).push_back(enemy);
+    }
+  }
+
+  auto sweep = [&](std::vector<Enemy *> &list, auto &&update) {
+    return [&list, update](long long n) {
+      size_t next = 0;
+      for (long long i = 0; i < n; i++) {
+        update(list[next]);
+        if (++next == list.size())
+          next = 0;
+      }
+      sink = list[0]->position.x;
+    };
+  };
+  const Level &level = scene.level;
+
+  // The base patrol, along the ground baked with the level...
+  if (Wanted(options, "Enemy::Update") && !roaches.empty()) {
+    results.push_back(Measure(
+        "Enemy::Update", scene.platformCount, scene.enemyCount, options,
+        sweep(roaches, [&level](Enemy *e) {
+          e->Enemy::Update(TICK_SECONDS, level);
+        })));
+  }
+  // ...and probing the level for ground (no baked patrol)
+  if (Wanted(options, "Enemy::Update/probe") && !roaches.empty()) {
+    for (Enemy *e : roaches)
+      e->hasPatrol = false;
+    results.push_back(Measure(
+        "Enemy::Update/probe", scene.platformCount, scene.enemyCount, options,
+        sweep(roaches, [&level](Enemy *e) {
+          e->Enemy::Update(TICK_SECONDS, level);
+        })));
+  }
+  if (Wanted(options, "Spider::Update") && !spiders.empty()) {
+    results.push_back(Measure(
+        "Spider::Update", scene.platformCount, scene.enemyCount, options,
+        sweep(spiders, [&level](Enemy *e) {
+          e->Update(TICK_SECONDS, level);
+        })));
+  }
+
+  for (Enemy *e : enemies)
+    delete e;
+}
+
+void BenchQueries(Scene &scene, const Options &options,
+                  std::vector<Result> &results) {
+  const Level &level = scene.level;
+
+  if (Wanted(options, "Level::IsEdge")) {
+    std::vector<Vector2> points = scene.Points(SEED);
+    results.push_back(Measure(
+        "Level::IsEdge", scene.platformCount, 0, options, [&](long long n) {
+          int edges = 0;
+          for (long long i = 0; i < n; i++)
+            edges += level.IsEdge(points[i % QUERY_COUNT]);
+          sink = (float)edges;
+        }));
+  }
+
+  if (Wanted(options, "GetRayIntersection")) {
+    // Sun rays: from the sun to points across the level
+    std::vector<Vector2> targets = scene.Points(SEED + 1);
+    Vector2 sun = level.sunPosition;
+    results.push_back(Measure(
+        "GetRayIntersection", scene.platformCount, 0, options,
+        [&](long long n) {
+          float sum = 0.0f;
+          for (long long i = 0; i < n; i++) {
+            Vector2 hit = GetRayIntersection(sun, targets[i % QUERY_COUNT],
+                                             level, (i & 1) == 0);
+            sum += hit.y;
+          }
+          sink = sum;
+        }));
+  }
+
+  if (Wanted(options, "World::UpdateFlowers")) {
+    // One op = one pass over every platform (flowers alternate day/night)
+    World world;
+    world.Start(scene.level, true);
+    results.push_back(Measure("World::UpdateFlowers", scene.platformCount, 0,
+                              options, [&](long long n) {
+                                for (long long i = 0; i < n; i++) {
+                                  world.isDayTime = (i & 64) == 0;
+                                  world.UpdateFlowers(TICK_SECONDS);
+                                }
+                              }));
+    world.Clear();
+    // Leave the level as laid out for the next benchmarks
+    scene.level.Layout((float)Core::SCREEN_WIDTH, (float)Core::SCREEN_HEIGHT);
+  }
+}
+
+void BenchLineRect(const Options &options, std::vector<Result> &results) {
+  std::mt19937 rng(SEED);
+  std::uniform_real_distribution<float> x(0.0f, (float)Core::SCREEN_WIDTH);
+  std::uniform_real_distribution<float> y(0.0f, (float)Core::SCREEN_HEIGHT);
+  std::uniform_real_distribution<float> size(10.0f, 200.0f);
+  struct Case {
+    Vector2 start, end;
+    Rectangle rect;
+  };
+  std::vector<Case> cases;
+  for (int i = 0; i < QUERY_COUNT; i++) {
+    cases.push_back({{x(rng), y(rng)},
+                     {x(rng), y(rng)},
+                     {x(rng), y(rng), size(rng), size(rng) * 0.3f}});
+  }
+  results.push_back(Measure(
+      "CheckCollisionLineRect", 0, 0, options, [&](long long n) {
+        int hits = 0;
+        for (long long i = 0; i < n; i++) {
+          const Case &c = cases[i % QUERY_COUNT];
+          hits += CheckCollisionLineRect(c.start, c.end, c.rect);
+        }
+        sink = (float)hits;
+      }));
+}
+
+// --- Output ---
+
+bool WriteJson(const char *path, const Options &options,
+               const std::vector<Result> &results) {
+  FILE *f = fopen(path, "wb");
+  if (f == nullptr)
+    return false;
+  char date[32];
+  time_t now = time(nullptr);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+#if defined(NDEBUG)
+  const char *build = "release";
+#else
+  const char *build = "debug";
+#endif
+  fprintf(f,
+          "{\n  \"context\": {\"date\": \"%s\", \"build\": \"%s\", "
+          "\"hardware_threads\": %u, \"seed\": %u, \"samples\": %d, "
+          "\"min_time_s\": %.3f, \"screen\": [%d, %d]},\n"
+          "  \"benchmarks\": [",
+          date, build, std::thread::hardware_concurrency(), SEED, SAMPLES,
+          options.minTime, Core::SCREEN_WIDTH, Core::SCREEN_HEIGHT);
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result &r = results[i];
+    fprintf(f,
+            "%s\n    {\"name\": \"%s\", \"platforms\": %d, \"enemies\": %d, "
+            "\"iterations\": %lld, \"ns_per_op_median\": %.3f, "
+            "\"ns_per_op_min\": %.3f, \"ns_per_op_max\": %.3f, "
+            "\"ops_per_second\": %.1f}",
+            i == 0 ? "" : ",", r.name.c_str(), r.platforms, r.enemies,
+            r.iterations, r.medianNs, r.minNs, r.maxNs,
+            r.medianNs > 0.0 ? 1e9 / r.medianNs : 0.0);
+  }
+  fputs("\n  ]\n}\n", f);
+  return fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--out") == 0 && hasValue)
+      options.out = argv[++i];
+    else if (strcmp(argv[i], "--filter") == 0 && hasValue)
+      options.filter = argv[++i];
+    else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+      options.minTime = std::max(0.001, atof(argv[++i]));
+    else if (strcmp(argv[i], "--quick") == 0) {
+      options.minTime = 0.02;
+      options.maxCount = 10000;
+    } else {
+      fprintf(stderr,
+              "usage: %s [--out FILE] [--filter TEXT] [--min-time S] "
+              "[--quick]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  std::vector<Result> results;
+  printf("  %-28s %7s %7s\n", "benchmark", "plats", "enemies");
+
+  if (Wanted(options, "CheckCollisionLineRect"))
+    BenchLineRect(options, results);
+
+  bool platformRuns = Wanted(options, "Player::Update") ||
+                      Wanted(options, "Level::IsEdge") ||
+                      Wanted(options, "GetRayIntersection") ||
+                      Wanted(options, "World::UpdateFlowers");
+  for (int count : PLATFORM_COUNTS) {
+    if (!platformRuns || count > options.maxCount)
+      break;
+    Scene scene;
+    if (!scene.Build(count, 0)) {
+      fprintf(stderr, "cannot build a level of %d platforms\n", count);
+      return 1;
+    }
+    if (Wanted(options, "Player::Update"))
+      BenchPlayer(scene, options, results);
+    BenchQueries(scene, options, results);
+  }
+
+  bool enemyRuns = Wanted(options, "Enemy::Update") ||
+                   Wanted(options, "Enemy::Update/probe") ||
+                   Wanted(options, "Spider::Update");
+  for (int count : ENEMY_COUNTS) {
+    if (!enemyRuns || count > options.maxCount)
+      break;
+    Scene scene;
+    if (!scene.Build(ENEMY_LEVEL_PLATFORMS, count)) {
+      fprintf(stderr, "cannot build a level of %d enemies\n", count);
+      return 1;
+    }
+    BenchEnemies(scene, options, results);
+  }
+
+  if (!WriteJson(options.out, options, results)) {
+    fprintf(stderr, "cannot write %s\n", options.out);
+    return 1;
+  }
+  printf("%zu results written to %s\n", results.size(), options.out);
+  return 0;
+}
@@ -0,0 +1,441 @@
+// Checks that levels can be finished: explores what the player can do with
+// the game's own movement and collision (World::Step), from the spawn point,
+// and reports the shortest route to the exit, the area the player can
+// reach and the exits that cannot be reached.
+//
+//   LevelAnalyser [options] <level.lvl|.lvlb>...
+//     --threads N   workers besides the main thread (default: all cores)
+//     --cell PX     position grid, in pixels at 1280x800 (default 16)
+//     --step TICKS  ticks an input is held per move (default 6 = 0.1 s)
+//     --seconds S   longest route explored (default 60)
+//     --map         print the reachable area of each search
+//
+// Each level is searched three ways: day and night toggled freely (from the
+// level's starting time), always day and always night. The search is
+// breadth-first over moves, so the first route to the exit is the fastest
+// at the move granularity. States are told apart by a coarse key (grid
+// cell, fall speed, grounded, time of day, flower height) and a key is
+// explored again only with more HP left; enemies are not part of the key,
+// so their positions are those of the first arrival. Moves of a layer are
+// simulated in parallel, then merged in a fixed order: reports do not
+// depend on the thread count.
+//
+// Exit status: 0 if every level's exit is reachable with free toggling, 2
+// if one is not, 1 on errors.
+#include "core/JobSystem.h"
+#include "world/World.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr float TICK_SECONDS = 1.0f / 60.0f; // WorldThread::TICK_SECONDS
+
+enum Action : uint8_t {
+  ACTION_LEFT = 1,
+  ACTION_RIGHT = 2,
+  ACTION_JUMP = 4,
+  ACTION_TOGGLE = 8,
+};
+
+enum class Mode { FREE, DAY, NIGHT };
+
+const char *ModeName(Mode mode) {
+  switch (mode) {
+  case Mode::FREE:
+    return "day/night";
+  case Mode::DAY:
+    return "day only";
+  default:
+    return "night only";
+  }
+}
+
+struct Options {
+  int threads = -1;
+  float cell = 16.0f;
+  int stepTicks = 6;
+  float seconds = 60.0f;
+  bool map = false;
+};
+
+// A state reached: how, and with how much HP
+struct Node {
+  uint64_t key;
+  int parent; // -1 for the start
+  uint8_t action;
+  float hp;
+};
+
+// A move's outcome, before merging
+struct Candidate {
+  uint64_t key;
+  float hp;
+  int parent;
+  uint8_t action;
+  bool reachedExit;
+  World::State state;
+};
+
+// One worker's world: own copy of the level (flowers move)
+struct Context {
+  Level level;
+  World world;
+  std::vector<Candidate> out;
+};
+
+struct Result {
+  bool reachedExit = false;
+  float exitSeconds = 0.0f;
+  float exitHp = 0.0f;
+  std::vector<uint8_t> route;
+  size_t states = 0;
+  std::vector<bool> visited; // Map cells the player's centre reached
+};
+
+class Analyser {
+public:
+  Analyser(const Level &prototype, const Options &options, JobSystem &jobs)
+      : prototype(prototype), options(options), jobs(jobs) {
+    W = (float)Core::SCREEN_WIDTH;
+    H = (float)Core::SCREEN_HEIGHT;
+    mapColumns = (int)std::ceil(W / MAP_CELL);
+    mapRows = (int)std::ceil(H / MAP_CELL);
+  }
+
+  static constexpr float MAP_CELL = 20.0f; // Pixels per map character
+  int mapColumns;
+  int mapRows;
+
+  Result Search(Mode mode);
+
+private:
+  const Level &prototype;
+  const Options &options;
+  JobSystem &jobs;
+  float W, H;
+
+  static constexpr float HP_STEP = 0.25f; // Less gain is not worth a revisit
+  static constexpr int FLOWER_BUCKETS = 8;
+
+  uint64_t Key(const World &world) const;
+  bool InBounds(const Player &player) const;
+  void Expand(Context &context, const std::vector<int> &frontier,
+              const std::vector<World::State> &states,
+              std::atomic<int> &next, Mode mode) const;
+};
+
+uint64_t Analyser::Key(const World &world) const {
+  const Player &p = world.player;
+  float cx = p.position.x + p.width * 0.5f + W; // Offset: may be off screen
+  float cy = p.position.y + p.height * 0.5f + H;
+  uint64_t x = (uint64_t)std::max(0.0f, cx / options.cell) & 0xFFF;
+  uint64_t y = (uint64_t)std::max(0.0f, cy / options.cell) & 0xFFF;
+
+  // Fall speed in eighths of a jump
+  int vy = (int)std::floor(p.velocity.y / (p.jumpForce / 8.0f));
+  vy = std::max(-127, std::min(127, vy));
+
+  // Flowers all ease the same way, so one height stands for all of them
+  uint64_t sunk = 0;
+  for (const Platform &plat : world.GetLevel()->platforms) {
+    if (plat.type == PlatformType::FLOWER) {
+      float depth = (plat.rect.y - plat.initialY) / 200.0f;
+      sunk = (uint64_t)std::max(
+          0, std::min(FLOWER_BUCKETS - 1, (int)(depth * FLOWER_BUCKETS)));
+      break;
+    }
+  }
+
+  return x | y << 12 | (uint64_t)(vy + 128) << 24 |
+         (uint64_t)(p.isGrounded ? 1 : 0) << 32 |
+         (uint64_t)(world.isDayTime ? 1 : 0) << 33 | sunk << 34;
+}
+
+bool Analyser::InBounds(const Player &player) const {
+  // Fallen off the level (nothing below stops the fall) or far outside it
+  return player.position.x > -W && player.position.x < 2 * W &&
+         player.position.y > -H && player.position.y < 2 * H;
+}
+
+void Analyser::Expand(Context &context, const std::vector<int> &frontier,
+                      const std::vector<World::State> &states,
+                      std::atomic<int> &next, Mode mode) const {
+  World &world = context.world;
+  for (int i = next.fetch_add(1); i < (int)frontier.size();
+       i = next.fetch_add(1)) {
+    for (uint8_t action = 0; action < 16; action++) {
+      bool left = action & ACTION_LEFT, right = action & ACTION_RIGHT;
+      if (left && right)
+        continue;
+      if ((action & ACTION_TOGGLE) && mode != Mode::FREE)
+        continue;
+      // A jump while airborne does nothing: same as not jumping
+      if ((action & ACTION_JUMP) && !states[i].player.isGrounded)
+        continue;
+
+      world.LoadState(states[i]);
+      WorldInput input;
+      input.player.left = left;
+      input.player.right = right;
+      bool reachedExit = false;
+      for (int t = 0; t < options.stepTicks && !world.IsFinished(); t++) {
+        // Presses count on the move's first tick, like a key tap
+        input.player.jump = t == 0 && (action & ACTION_JUMP);
+        input.toggleTime = t == 0 && (action & ACTION_TOGGLE);
+        reachedExit = world.Step(TICK_SECONDS, input).reachedExit;
+      }
+      if (world.player.isDead || !InBounds(world.player))
+        continue;
+
+      Candidate candidate;
+      candidate.key = Key(world);
+      candidate.hp = world.player.hp;
+      candidate.parent = frontier[i];
+      candidate.action = action;
+      candidate.reachedExit = reachedExit;
+      if (!reachedExit)
+        world.SaveState(candidate.state);
+      context.out.push_back(std::move(candidate));
+    }
+  }
+}
+
+Result Analyser::Search(Mode mode) {
+  Result result;
+  result.visited.assign(mapColumns * mapRows, false);
+
+  // One context per thread that can run a share of a layer
+  int contextCount = jobs.GetWorkerCount() + 1;
+  std::vector<std::unique_ptr<Context>> contexts;
+  for (int c = 0; c < contextCount; c++) {
+    contexts.push_back(std::make_unique<Context>());
+    Context &context = *contexts.back();
+    context.level = prototype;
+    bool startDay = mode == Mode::FREE ? prototype.isDay : mode == Mode::DAY;
+    context.world.Start(context.level, startDay);
+  }
+
+  std::vector<Node> nodes;
+  std::unordered_map<uint64_t, float> bestHp; // Memo: key -> most HP seen
+  std::vector<int> frontier;
+  std::vector<World::State> states(1);
+
+  World &start = contexts[0]->world;
+  start.SaveState(states[0]);
+  nodes.push_back({Key(start), -1, 0, start.player.hp});
+  bestHp[nodes[0].key] = nodes[0].hp;
+  frontier.push_back(0);
+
+  auto visit = [&](const Player &p) {
+    int mx = (int)((p.position.x + p.width * 0.5f) / MAP_CELL);
+    int my = (int)((p.position.y + p.height * 0.5f) / MAP_CELL);
+    if (mx >= 0 && mx < mapColumns && my >= 0 && my < mapRows)
+      result.visited[my * mapColumns + mx] = true;
+  };
+  visit(states[0].player);
+
+  int maxLayers =
+      (int)(options.seconds / (options.stepTicks * TICK_SECONDS) + 0.5f);
+  int exitNode = -1;
+  for (int layer = 1; layer <= maxLayers && !frontier.empty(); layer++) {
+    // Simulate every move of the layer in parallel
+    std::atomic<int> next(0);
+    jobs.Wait(jobs.ParallelFor(contextCount, 1, [&](int begin, int end) {
+      for (int c = begin; c < end; c++)
+        Expand(*contexts[c], frontier, states, next, mode);
+    }));
+
+    // Merge in a fixed order: by key, most HP first, then by origin
+    std::vector<std::pair<int, int>> order; // Context, candidate
+    for (int c = 0; c < contextCount; c++) {
+      for (int k = 0; k < (int)contexts[c]->out.size(); k++)
+        order.push_back({c, k});
+    }
+    auto at = [&](const std::pair<int, int> &o) -> const Candidate & {
+      return contexts[o.first]->out[o.second];
+    };
+    std::sort(order.begin(), order.end(), [&](const auto &a, const auto &b) {
+      const Candidate &x = at(a), &y = at(b);
+      if (x.key != y.key)
+        return x.key < y.key;
+      if (x.hp != y.hp)
+        return x.hp > y.hp;
+      if (x.parent != y.parent)
+        return x.parent < y.parent;
+      return x.action < y.action;
+    });
+
+    std::vector<int> nextFrontier;
+    std::vector<World::State> nextStates;
+    for (const auto &o : order) {
+      const Candidate &c = at(o);
+      if (c.reachedExit) {
+        // Fastest layer wins; within it the most HP left
+        if (exitNode < 0 || (!result.reachedExit && c.hp > result.exitHp)) {
+          nodes.push_back({c.key, c.parent, c.action, c.hp});
+          exitNode = (int)nodes.size() - 1;
+          result.exitHp = c.hp;
+          result.exitSeconds = layer * options.stepTicks * TICK_SECONDS;
+        }
+        continue;
+      }
+      auto found = bestHp.find(c.key);
+      if (found != bestHp.end() && c.hp < found->second + HP_STEP)
+        continue;
+      bestHp[c.key] = c.hp;
+      nodes.push_back({c.key, c.parent, c.action, c.hp});
+      nextFrontier.push_back((int)nodes.size() - 1);
+      nextStates.push_back(c.state);
+      visit(c.state.player);
+    }
+    if (exitNode >= 0)
+      result.reachedExit = true;
+
+    for (auto &context : contexts)
+      context->out.clear();
+    frontier.swap(nextFrontier);
+    states.swap(nextStates);
+  }
+
+  result.states = nodes.size();
+  for (int n = exitNode; n > 0; n = nodes[n].parent)
+    result.route.push_back(nodes[n].action);
+  std::reverse(result.route.begin(), result.route.end());
+  return result;
+}
+
+// "right x5, right+jump, toggle, ..." (runs of the same move counted)
+std::string DescribeRoute(const std::vector<uint8_t> &route) {
+  std::string text;
+  for (size_t i = 0; i < route.size();) {
+    size_t run = 1;
+    while (i + run < route.size() && route[i + run] == route[i])
+      run++;
+    uint8_t a = route[i];
+    std::string move;
+    if (a & ACTION_LEFT)
+      move = "left";
+    if (a & ACTION_RIGHT)
+      move = "right";
+    if (a & ACTION_JUMP)
+      move += move.empty() ? "jump" : "+jump";
+    if (a & ACTION_TOGGLE)
+      move += move.empty() ? "toggle" : "+toggle";
+    if (move.empty())
+      move = "wait";
+    if (!text.empty())
+      text += ", ";
+    text += move;
+    if (run > 1)
+      text += " x" + std::to_string(run);
+    i += run;
+  }
+  return text;
+}
+
+void PrintMap(const Analyser &analyser, const Level &level,
+              const Result &result) {
+  const float cell = Analyser::MAP_CELL;
+  for (int y = 0; y < analyser.mapRows; y++) {
+    std::string row = "    ";
+    for (int x = 0; x < analyser.mapColumns; x++) {
+      Vector2 centre = {(x + 0.5f) * cell, (y + 0.5f) * cell};
+      char c = result.visited[y * analyser.mapColumns + x] ? '.' : ' ';
+      for (const Platform &plat : level.platforms) {
+        if (plat.type != PlatformType::INVISIBLE &&
+            CheckCollisionPointRec(centre, plat.rect))
+          c = '#';
+      }
+      if (CheckCollisionPointRec(centre, level.exitZone))
+        c = 'E';
+      row += c;
+    }
+    printf("%s\n", row.c_str());
+  }
+}
+
+// Exit status of one level (see the top of the file)
+int AnalyseLevel(const char *path, const Options &options, JobSystem &jobs) {
+  Level level;
+  if (!level.Load(path)) {
+    fprintf(stderr, "%s: cannot load level\n", path);
+    return 1;
+  }
+  level.Layout((float)Core::SCREEN_WIDTH, (float)Core::SCREEN_HEIGHT);
+
+  Analyser analyser(level, options, jobs);
+  int status = 0;
+  printf("%s\n", path);
+  for (Mode mode : {Mode::FREE, Mode::DAY, Mode::NIGHT}) {
+    Result result = analyser.Search(mode);
+    size_t area = std::count(result.visited.begin(), result.visited.end(),
+                             true);
+    printf("  %-10s ", ModeName(mode));
+    if (result.reachedExit) {
+      printf("exit in %.2f s, %.2f HP left (%zu states, %zu map cells)\n",
+             result.exitSeconds, result.exitHp, result.states, area);
+      printf("             route: %s\n", DescribeRoute(result.route).c_str());
+    } else {
+      printf("EXIT UNREACHABLE (%zu states, %zu map cells)\n", result.states,
+             area);
+      if (mode == Mode::FREE)
+        status = 2;
+    }
+    if (options.map)
+      PrintMap(analyser, level, result);
+  }
+  return status;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--threads") == 0 && hasValue)
+      options.threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--cell") == 0 && hasValue)
+      options.cell = std::max(1.0f, (float)atof(argv[++i]));
+    else if (strcmp(argv[i], "--step") == 0 && hasValue)
+      options.stepTicks = std::max(1, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--seconds") == 0 && hasValue)
+      options.seconds = (float)atof(argv[++i]);
+    else if (strcmp(argv[i], "--map") == 0)
+      options.map = true;
+    else if (argv[i][0] == '-') {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    } else
+      paths.push_back(argv[i]);
+  }
+  if (paths.empty()) {
+    fprintf(stderr,
+            "usage: %s [--threads N] [--cell PX] [--step TICKS] "
+            "[--seconds S] [--map] <level>...\n",
+            argv[0]);
+    return 1;
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  JobSystem jobs;
+  jobs.Start(options.threads);
+
+  int status = 0;
+  for (const char *path : paths) {
+    int levelStatus = AnalyseLevel(path, options, jobs);
+    if (status == 0 || levelStatus == 1)
+      status = levelStatus;
+  }
+  jobs.Stop();
+  return status;
+}
@@ -0,0 +1,67 @@
+// Compiles a text level (see src/world/LevelData.h) into its baked form
+// (see src/world/LevelFormat.h): platforms with solidity masks and a
+// broadphase grid, enemies with their patrol spans, ready to use in place.
+//
+//   LevelCompiler <input.lvl> <output.lvlb>
+//
+// The game prefers assets/levels/levelN.lvlb over levelN.lvl, and bakes the
+// text file itself when no compiled one is shipped.
+#include "BakedLevel.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <input.lvl> <output.lvlb>\n", argv[0]);
+    return 1;
+  }
+  const char *input = argv[1];
+  const char *output = argv[2];
+
+  std::ifstream in(input, std::ios::binary);
+  if (!in) {
+    fprintf(stderr, "cannot read %s\n", input);
+    return 1;
+  }
+  std::string text((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+
+  LevelData data;
+  if (!data.Parse(text.data(), text.size(), input))
+    return 1; // Parse() reported the line
+
+  std::vector<unsigned char> blob = BakedLevel::Bake(data);
+  BakedLevel baked;
+  if (!baked.Attach(blob.data(), blob.size())) {
+    fprintf(stderr, "%s: baked level failed validation\n", input);
+    return 1;
+  }
+
+  fs::path outPath(output);
+  if (outPath.has_parent_path())
+    fs::create_directories(outPath.parent_path());
+  std::ofstream out(outPath, std::ios::binary);
+  out.write((const char *)blob.data(), (std::streamsize)blob.size());
+  if (!out) {
+    fprintf(stderr, "cannot write %s\n", output);
+    return 1;
+  }
+
+  uint32_t patrols = 0;
+  for (uint32_t i = 0; i < baked.GetEnemyCount(); i++) {
+    if (baked.GetEnemy(i).patrol != LevelFormat::NONE)
+      patrols++;
+  }
+  const LevelFormat::Header &h = baked.GetHeader();
+  printf("%s: %u platforms (%u moving), %u enemies (%u patrolling), "
+         "%u grid entries, %zu bytes\n",
+         output, baked.GetPlatformCount(), h.dynamic.count,
+         baked.GetEnemyCount(), patrols, h.cellItems.count, blob.size());
+  return 0;
+}
@@ -0,0 +1,155 @@
+// Re-simulates recorded sessions (see src/world/Replay.h) without a window,
+// as fast as the simulation runs: checks every step against the recorded
+// checksum and reports the steps per second.
+//
+//   ReplayRunner [options] <replay.rrpl>...
+//     --threads N   simulation workers besides the main thread (default 0)
+//     --repeat N    play each replay N times, for steadier timings
+//
+// Levels are read from the paths recorded (run it where the game runs) and
+// must be the bytes that were recorded. Each segment is laid out at its
+// recorded screen size and played from the level start; the first step
+// that differs is reported, with how many do.
+//
+// Exit status: 0 if every step matched, 2 if a replay diverged, 1 on
+// errors.
+#include "core/JobSystem.h"
+#include "world/Replay.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  int threads = 0;
+  int repeat = 1;
+};
+
+// Levels by path, loaded once for every replay
+std::map<std::string, std::unique_ptr<Level>> levelCache;
+
+Level *GetLevel(const std::string &path) {
+  auto it = levelCache.find(path);
+  if (it != levelCache.end())
+    return it->second.get();
+  auto level = std::make_unique<Level>();
+  if (!level->Load(path.c_str()))
+    return nullptr;
+  return (levelCache[path] = std::move(level)).get();
+}
+
+int RunReplay(const char *path, const Options &options, JobSystem &jobs) {
+  Replay replay;
+  if (!replay.Load(path))
+    return 1;
+
+  // Levels first: a missing or edited one fails before any timing
+  std::vector<Level *> levels;
+  for (size_t s = 0; s < replay.segments.size(); s++) {
+    const Replay::Segment &segment = replay.segments[s];
+    Level *level = GetLevel(segment.levelPath);
+    if (level == nullptr) {
+      fprintf(stderr, "%s: segment %zu: cannot load %s\n", path, s + 1,
+              segment.levelPath.c_str());
+      return 1;
+    }
+    if (Replay::HashLevel(*level) != segment.levelHash) {
+      fprintf(stderr, "%s: segment %zu: %s differs from the recorded level\n",
+              path, s + 1, segment.levelPath.c_str());
+      return 1;
+    }
+    levels.push_back(level);
+  }
+
+  World world;
+  world.SetJobs(&jobs);
+  ReplayCursor cursor;
+  double seconds = 0.0;
+  size_t steps = 0;
+  int diverged = 0;
+  for (int run = 0; run < options.repeat; run++) {
+    for (size_t s = 0; s < replay.segments.size(); s++) {
+      const Replay::Segment &segment = replay.segments[s];
+      Core::SCREEN_WIDTH = segment.screenWidth;
+      Core::SCREEN_HEIGHT = segment.screenHeight;
+      Core::RecalculatePhysics();
+      levels[s]->Layout((float)segment.screenWidth,
+                        (float)segment.screenHeight);
+      world.Start(*levels[s], segment.startAtDay);
+      cursor.Begin(replay, (int)s);
+
+      auto start = std::chrono::steady_clock::now();
+      WorldEvents events;
+      while (cursor.Step(world, events)) {
+      }
+      seconds += std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+      steps += cursor.GetStep();
+
+      if (run == 0 && cursor.GetMismatches() > 0) {
+        printf("  segment %zu (%s): DIVERGED at step %lld, %d of %zu steps "
+               "differ\n",
+               s + 1, segment.levelPath.c_str(), cursor.GetFirstMismatch(),
+               cursor.GetMismatches(), cursor.GetStep());
+        diverged++;
+      }
+    }
+  }
+  world.Clear();
+
+  printf("%s: %zu segments, %zu steps, %s\n", path, replay.segments.size(),
+         replay.GetStepCount(), diverged > 0 ? "DIVERGED" : "all steps match");
+  printf("  %.0f steps/s (%.1fx real time, %zu steps in %.3f s)\n",
+         seconds > 0.0 ? (double)steps / seconds : 0.0,
+         seconds > 0.0
+             ? (double)steps * replay.stepSeconds / seconds
+             : 0.0,
+         steps, seconds);
+  return diverged > 0 ? 2 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--threads") == 0 && hasValue)
+      options.threads = std::max(0, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--repeat") == 0 && hasValue)
+      options.repeat = std::max(1, atoi(argv[++i]));
+    else if (argv[i][0] == '-') {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    } else
+      paths.push_back(argv[i]);
+  }
+  if (paths.empty()) {
+    fprintf(stderr, "usage: %s [--threads N] [--repeat N] <replay>...\n",
+            argv[0]);
+    return 1;
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  JobSystem jobs;
+  jobs.Start(options.threads);
+
+  int status = 0;
+  for (const char *path : paths) {
+    int replayStatus = RunReplay(path, options, jobs);
+    if (status == 0 || replayStatus == 1)
+      status = replayStatus;
+  }
+  jobs.Stop();
+  levelCache.clear();
+  return status;
+}
@@ -74,16 +74,71 @@ else
     echo "=== raylib web library already built ==="
 fi
 
-# Step 2: Build the game for web
+# Step 2: Pack assets. The game fetches the pack's table of contents at
+# startup and each asset by HTTP range request when it is first needed, so
+# nothing has to be downloaded up front. Assets are conditioned first when
+# the conditioner is built (smaller, premultiplied, faster to decode).
+# Without the packer (native build: cmake --build build --target
+# AssetPacker) assets are preloaded instead.
+PACKER="build/AssetPacker"
+CONDITIONER="build/AssetConditioner"
+LEVEL_COMPILER="build/LevelCompiler"
+if [ -x "$PACKER" ]; then
+    ROOT="$(pwd)"
+    PACK_ROOT="."
+    if [ -x "$CONDITIONER" ]; then
+        echo "=== Conditioning assets ==="
+        rm -rf "$OUT_DIR/conditioned"
+        "$CONDITIONER" assets "$OUT_DIR/conditioned"
+        PACK_ROOT="$OUT_DIR/conditioned"
+        # Baked levels, preferred by the game over the text ones
+        if [ -x "$LEVEL_COMPILER" ]; then
+            for level in assets/levels/*.lvl; do
+                "$LEVEL_COMPILER" "$level" \
+                    "$PACK_ROOT/assets/levels/$(basename "$level" .lvl).lvlb"
+            done
+        fi
+    fi
+    echo "=== Packing assets ==="
+    (cd "$PACK_ROOT" && "$ROOT/$PACKER" "$ROOT/$OUT_DIR/assets.pak" assets)
+    rm -rf "$OUT_DIR/conditioned"
+    ASSET_FLAGS=()
+else
+    echo "=== AssetPacker not built: preloading assets ==="
+    ASSET_FLAGS=(--preload-file assets)
+fi
+
+# Step 3: Build the game for web
 echo "=== Building Reino de Aragon for Web ==="
 
 emcc -o "$OUT_DIR/index.html" \
     src/main.cpp \
     src/Game.cpp \
+    src/core/AssetGroup.cpp \
+    src/core/AssetLoader.cpp \
+    src/core/AssetManifest.cpp \
+    src/core/ColorGrade.cpp \
+    src/core/FrameCapture.cpp \
+    src/core/JobSystem.cpp \
+    src/core/MusicStreamer.cpp \
+    src/core/PackFile.cpp \
+    src/core/Render.cpp \
+    src/core/Profiler.cpp \
+    src/core/Resources.cpp \
+    src/core/Scheduler.cpp \
+    src/core/SfxMixer.cpp \
+    src/core/SpriteMesh.cpp \
+    src/core/TraceWriter.cpp \
     src/entities/Player.cpp \
     src/entities/Roach.cpp \
     src/entities/Spider.cpp \
+    src/world/BakedLevel.cpp \
+    src/world/Collision.cpp \
     src/world/Level.cpp \
+    src/world/LevelData.cpp \
+    src/world/Replay.cpp \
+    src/world/World.cpp \
+    src/world/WorldThread.cpp \
     -Os -Wall \
     "$RAYLIB_WEB_LIB" \
     -s ASYNCIFY \
@@ -94,8 +149,8 @@ emcc -o "$OUT_DIR/index.html" \
     -I"$RAYLIB_SRC" \
     -Isrc/ \
     -DPLATFORM_WEB \
-    --preload-file assets \
-    -std=c++17
+    "${ASSET_FLAGS[@]}" \
+    -std=c++20
 
 echo ""
 echo "=== Build Complete! ==="
@@ -103,7 +158,7 @@ echo "Output files in: $OUT_DIR/"
 echo "  - index.html"
 echo "  - index.js"  
 echo "  - index.wasm"
-echo "  - index.data (assets)"
+echo "  - assets.pak (or index.data when preloading)"
 echo ""
 echo "To test locally:"
 echo "  cd $OUT_DIR && python3 -m http.server 8080"